@@ -6,14 +6,22 @@
 */
 
 #include <Arduino.h>
+#include <SdFat.h>
 #include <Watchdog_t4.h>
 #include <arduino_freertos.h>
 
+#include "sl_cr_binlog.hpp"
+#include "sl_cr_blackbox.hpp"
 #include "sl_cr_config.h"
+#include "sl_cr_cyclic_executive.hpp"
 #include "sl_cr_drive.hpp"
 #include "sl_cr_failsafe.hpp"
+#include "sl_cr_latency.hpp"
+#include "sl_cr_profiler.hpp"
 #include "sl_robot_log_task.hpp"
 #include "sl_cr_sbus.hpp"
+#include "sl_cr_sbus_record.hpp"
+#include "sl_cr_telemetry.hpp"
 #include "sl_cr_types.hpp"
 #include "sl_robot_utils.hpp"
 #include "sl_cr_version.h"
@@ -23,12 +31,16 @@ using namespace sandor_laboratories::robot;
 const sl_cr_drive_data_s *drive_data_ptr = nullptr;
 
 time_ms_t watchdog_fed;
+/* Free heap just before the scheduler starts.  All allocation is complete by then, heap must not change after this */
+size_t heap_free_at_scheduler_start;
 /* Watchdog Timeout in ms, 32ms to 522.232s */
 #define SL_CR_WATCHDOG_TIMEOUT 100
 /* Watchdog feeding schedule in ms */
 #define SL_CR_WATCHDOG_FEEDING_SCHEDULE (SL_CR_WATCHDOG_TIMEOUT / 2)
 /* Watchdog window in ms, 32ms to 522.232s, must be smaller than timeout */
 #define SL_CR_WATCHDOG_WINDOW (SL_CR_WATCHDOG_FEEDING_SCHEDULE - 1)
+/* Feeding this late (ms) triggers the blackbox, while there is still time to recover and dump it */
+#define SL_CR_WATCHDOG_LATE_FEED ((SL_CR_WATCHDOG_TIMEOUT * 3) / 4)
 WDT_T4<WDT3> wdt;
 void wdt_callback()
 {
@@ -38,9 +50,8 @@ void wdt_callback()
   Serial.flush();
 }
 
-/* SBUS read frequency in ms */
-#define SL_CR_SBUS_PERIOD SL_CR_SBUS_UPDATE_PERIOD
-
+#ifndef _CYCLIC_EXECUTIVE_
+TaskHandle_t control_loop_task_handle = nullptr;
 static void control_loop_task(void *)
 {
   TickType_t xLastWakeTime;
@@ -49,109 +60,396 @@ static void control_loop_task(void *)
 
   for (;;)
   {
-    vTaskDelayUntil(&xLastWakeTime, xPeriod);
+#ifdef _PIPELINED_DRIVE_
+    /* Run early if drive strategy has new set points, otherwise at end of period */
+    const TickType_t xElapsed = xTaskGetTickCount() - xLastWakeTime;
+    ulTaskNotifyTake(pdTRUE, (xElapsed < xPeriod)?(xPeriod - xElapsed):0);
+    xLastWakeTime = xTaskGetTickCount();
+    sl_cr_profiler_begin(SL_CR_PROFILER_TASK_CONTROL_LOOP, SL_CR_PROFILER_APERIODIC);
+#else
+    /* Run at end of period, or immediately on failsafe entry */
+    const TickType_t xElapsed = xTaskGetTickCount() - xLastWakeTime;
+    if(0 == ulTaskNotifyTake(pdTRUE, (xElapsed < xPeriod)?(xPeriod - xElapsed):0))
+    {
+      /* Period elapsed, keep fixed cadence */
+      xLastWakeTime += xPeriod;
+    }
+    sl_cr_profiler_begin(SL_CR_PROFILER_TASK_CONTROL_LOOP, SL_CR_CONTROL_LOOP_PERIOD*1000);
+#endif
     sl_cr_drive_control_loop();
+    sl_cr_profiler_end(SL_CR_PROFILER_TASK_CONTROL_LOOP);
   }
 }
 
+TaskHandle_t drive_task_handle = nullptr;
 static void drive_task(void *)
 {
-  TickType_t xLastWakeTime;
+#ifdef _PIPELINED_DRIVE_
   const TickType_t xPeriod = pdMS_TO_TICKS(SL_CR_DRIVE_PERIOD);
+#else
+  TickType_t xLastWakeTime;
   xLastWakeTime = xTaskGetTickCount();
+#endif
 
   for (;;)
   {
+#ifdef _PIPELINED_DRIVE_
+    /* Run as soon as SBUS publishes a frame, period is a fallback */
+    ulTaskNotifyTake(pdTRUE, xPeriod);
+    sl_cr_profiler_begin(SL_CR_PROFILER_TASK_DRIVE, SL_CR_PROFILER_APERIODIC);
+    if(sl_cr_drive_strategy_loop())
+    {
+      /* Push new set points to motors immediately */
+      xTaskNotifyGive(control_loop_task_handle);
+    }
+#else
+    /* Run in lockstep with detected SBUS frame rate */
+    const TickType_t xPeriod = sl_cr_sbus_get_frame_period_ticks();
     vTaskDelayUntil(&xLastWakeTime, xPeriod);
+    sl_cr_profiler_begin(SL_CR_PROFILER_TASK_DRIVE, xPeriod*portTICK_PERIOD_MS*1000);
     sl_cr_drive_strategy_loop();
+#endif
+    sl_cr_profiler_end(SL_CR_PROFILER_TASK_DRIVE);
   }
 }
+#else
+static void cyclic_executive_strategy()
+{
+  sl_cr_drive_strategy_loop();
+}
+static void cyclic_executive_rc()
+{
+  sl_cr_sbus_loop();
+  combat::failsafe_armswitch_loop();
+}
+
+/* Rate-monotonic schedule in 1ms minor frames, offsets spread slower slots across frames */
+constexpr sl_cr_cyclic_executive_slot_s cyclic_executive_schedule[] =
+{
+  {"Control Loop",   sl_cr_drive_control_loop,  1, 0},
+  {"Drive Strategy", cyclic_executive_strategy, 5, 1},
+  {"RC & Failsafe",  cyclic_executive_rc,      10, 2},
+};
+#define SL_CR_CYCLIC_EXECUTIVE_SLOTS (sizeof(cyclic_executive_schedule) / sizeof(cyclic_executive_schedule[0]))
+static_assert(sl_cr_cyclic_executive_valid(cyclic_executive_schedule), "Cyclic executive schedule must be rate-monotonic");
+#define SL_CR_CYCLIC_EXECUTIVE_CONTROL_LOOP_SLOT 0
+/* Control loop gains are rescaled for a slot running every minor frame (SL_CR_DRIVE_PID_PERIOD_US) */
+static_assert(1 == cyclic_executive_schedule[SL_CR_CYCLIC_EXECUTIVE_CONTROL_LOOP_SLOT].period, "Control loop slot must run every minor frame");
+
+sl_cr_cyclic_executive_c<SL_CR_CYCLIC_EXECUTIVE_SLOTS> cyclic_executive(cyclic_executive_schedule);
+
+/* Replaces control loop, drive and SBUS tasks */
+static void cyclic_executive_task(void *)
+{
+  TickType_t xLastWakeTime;
+  const TickType_t xPeriod = pdMS_TO_TICKS(SL_CR_CYCLIC_EXECUTIVE_MINOR_FRAME);
+  xLastWakeTime = xTaskGetTickCount();
+
+  for (;;)
+  {
+    vTaskDelayUntil(&xLastWakeTime, xPeriod);
+    cyclic_executive.minor_frame();
+  }
+}
+#endif
+
+/* Failsafe entry disables motor outputs now instead of at the next control loop period.
+     Never runs the control loop in the caller, which may be the control loop's own context */
+static void control_loop_failsafe_hook()
+{
+#if defined(_FAST_CONTROL_LOOP_)
+  /* Fast control loop timer applies failsafe to the motor drivers within one timer period */
+#elif defined(_CYCLIC_EXECUTIVE_)
+  /* Control loop slot runs as soon as the slot that entered failsafe returns */
+  cyclic_executive.request_run(SL_CR_CYCLIC_EXECUTIVE_CONTROL_LOOP_SLOT);
+#else
+  /* Highest priority task, preempts caller */
+  xTaskNotifyGive(control_loop_task_handle);
+#endif
+}
 
 static void watchdog_task(void *)
 {
   const TickType_t xPeriod = pdMS_TO_TICKS(SL_CR_WATCHDOG_FEEDING_SCHEDULE);
+  bool heap_changed = false;
 
   for (;;)
   {
     vTaskDelay(xPeriod);
+    sl_cr_profiler_begin(SL_CR_PROFILER_TASK_WATCHDOG, SL_CR_WATCHDOG_FEEDING_SCHEDULE*1000);
+
+#ifdef _BLACKBOX_
+    if((millis() - watchdog_fed) > SL_CR_WATCHDOG_LATE_FEED)
+    {
+      /* Watchdog callback runs just before reset, too late to dump.  Freeze on a near miss instead */
+      sl_cr_blackbox_trigger(SL_CR_BLACKBOX_TRIGGER_WATCHDOG);
+    }
+#endif
 
     /* Feed watchdog */
     wdt.feed();
     watchdog_fed = millis();
+
+    if(!heap_changed && (xPortGetFreeHeapSize() != heap_free_at_scheduler_start))
+    {
+      log_snprintf(LOG_KEY_BOOT, LOG_LEVEL_ERROR, "Heap used after scheduler start! Free: %u bytes, expected: %u bytes.",
+        (unsigned int) xPortGetFreeHeapSize(), (unsigned int) heap_free_at_scheduler_start);
+      heap_changed = true;
+#ifndef _COMBAT_MODE_
+      /* Allocation at runtime is a bug, stop the motors until reboot.  Combat builds keep driving and only log */
+      combat::set_failsafe_mask(combat::FAILSAFE_BOOT);
+#endif
+    }
+    sl_cr_profiler_end(SL_CR_PROFILER_TASK_WATCHDOG);
   }
 }
 
+TaskHandle_t sbus_task_handle = nullptr;
+#ifndef _CYCLIC_EXECUTIVE_
 static void sbus_task(void *)
 {
-  TickType_t xLastWakeTime;
-  const TickType_t xPeriod = pdMS_TO_TICKS(SL_CR_SBUS_PERIOD);
-  xLastWakeTime = xTaskGetTickCount();
   for (;;)
   {
-    vTaskDelayUntil(&xLastWakeTime, xPeriod);
+    /* Wake as soon as a new frame is decoded, or after a detected frame period to check for stale data */
+    ulTaskNotifyTake(pdTRUE, sl_cr_sbus_get_frame_period_ticks());
+    sl_cr_profiler_begin(SL_CR_PROFILER_TASK_SBUS, SL_CR_PROFILER_APERIODIC);
 
     /* Read any new SBUS data */
-    sl_cr_sbus_loop();
+    const bool new_frame = sl_cr_sbus_loop();
     /* Check if ARM switch is set */
     combat::failsafe_armswitch_loop();
+#ifdef _PIPELINED_DRIVE_
+    if(new_frame)
+    {
+      /* Wake drive strategy with new frame */
+      xTaskNotifyGive(drive_task_handle);
+    }
+#else
+    (void) new_frame;
+#endif
+    sl_cr_profiler_end(SL_CR_PROFILER_TASK_SBUS);
   }
 }
+#endif
+
+#if defined(_SBUS_RECORD_) || defined(_BINARY_LOG_) || defined(_TELEMETRY_)
+/* Writes as much of a stream flush as the port can take without blocking, user data is the port (Print *) */
+static size_t serial_port_write(const uint8_t *data, size_t length, void *port)
+{
+  Print * const serial    = (Print *) port;
+  const int     available = serial->availableForWrite();
+  size_t        written   = 0;
+
+  if(available > 0)
+  {
+    written = serial->write(data, (length < (size_t) available)?length:available);
+  }
+
+  return written;
+}
+#endif
+
+#ifdef _SBUS_RECORD_
+static void sbus_record_task(void *)
+{
+  TickType_t xLastWakeTime;
+  const TickType_t xPeriod = pdMS_TO_TICKS(SL_CR_SBUS_RECORD_PERIOD);
+  xLastWakeTime = xTaskGetTickCount();
+  for (;;)
+  {
+    vTaskDelayUntil(&xLastWakeTime, xPeriod);
+    sl_cr_sbus_record_flush(serial_port_write, (Print *) &SL_CR_SBUS_RECORD_PORT);
+  }
+}
+#endif
+
+#ifdef _BINARY_LOG_
+static void binlog_task(void *)
+{
+  TickType_t xLastWakeTime;
+  const TickType_t xPeriod = pdMS_TO_TICKS(SL_CR_BINLOG_PERIOD);
+  xLastWakeTime = xTaskGetTickCount();
+  for (;;)
+  {
+    vTaskDelayUntil(&xLastWakeTime, xPeriod);
+    sl_cr_binlog_flush(serial_port_write, (Print *) &SL_CR_BINLOG_PORT);
+  }
+}
+#endif
+
+#ifdef _TELEMETRY_
+static void telemetry_task(void *)
+{
+  TickType_t xLastWakeTime;
+  const TickType_t xPeriod = pdMS_TO_TICKS(SL_CR_TELEMETRY_PERIOD);
+  xLastWakeTime = xTaskGetTickCount();
+  for (;;)
+  {
+    vTaskDelayUntil(&xLastWakeTime, xPeriod);
+    sl_cr_telemetry_flush(serial_port_write, (Print *) &SL_CR_TELEMETRY_PORT);
+  }
+}
+#endif
+
+#ifdef _BLACKBOX_
+/* Blackbox dumps on SD card, file system objects are static so dumping never allocates */
+SdFs   blackbox_sd;
+FsFile blackbox_file;
+bool   blackbox_sd_mounted = false;
+
+static bool blackbox_sd_open(void *)
+{
+  bool ret_val   = false;
+  bool searching = blackbox_sd_mounted;
+  char path[sizeof("BB000.BIN")];
+
+  /* Next unused file name */
+  for(unsigned int n = 0; searching && (n < SL_CR_BLACKBOX_SD_MAX_FILES); n++)
+  {
+    snprintf(path, sizeof(path), "BB%03u.BIN", n);
+    if(!blackbox_sd.exists(path))
+    {
+      blackbox_file = blackbox_sd.open(path, O_WRONLY | O_CREAT | O_EXCL);
+      ret_val   = (bool) blackbox_file;
+      searching = false;
+    }
+  }
+
+  return ret_val;
+}
+
+static bool blackbox_sd_write(const uint8_t *data, size_t length, void *)
+{
+  return (length == blackbox_file.write(data, length));
+}
+
+static bool blackbox_sd_close(void *)
+{
+  return blackbox_file.close();
+}
+
+const sl_cr_blackbox_storage_s blackbox_storage = {blackbox_sd_open, blackbox_sd_write, blackbox_sd_close, nullptr};
+
+/* Below every recording task, so a frozen recording is complete when dumped */
+static void blackbox_task(void *)
+{
+  TickType_t xLastWakeTime;
+  const TickType_t xPeriod = pdMS_TO_TICKS(SL_CR_BLACKBOX_PERIOD);
+  xLastWakeTime = xTaskGetTickCount();
+  for (;;)
+  {
+    vTaskDelayUntil(&xLastWakeTime, xPeriod);
+    sl_cr_blackbox_flush(&blackbox_storage, LOG_KEY_FAILSAFE);
+  }
+}
+#endif
 
 TaskHandle_t log_task_handle = nullptr;
+/* Longest delay (ms) before a failsafe transition is logged */
+#define SL_CR_LOG_TASK_FAILSAFE_POLL_PERIOD 10
 static void log_task(void *)
 {
   log_cstring(LOG_KEY_BOOT, LOG_LEVEL_INFO, "######### BOOTUP END #########");
   for(;;)
   {
+    sl_cr_profiler_begin(SL_CR_PROFILER_TASK_LOG, SL_CR_PROFILER_APERIODIC);
+    combat::failsafe_log_transitions();
     log_flush();
-    ulTaskNotifyTake(pdTRUE,portMAX_DELAY);
+    sl_cr_profiler_end(SL_CR_PROFILER_TASK_LOG);
+    /* Failsafe transitions do not notify, poll for them */
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SL_CR_LOG_TASK_FAILSAFE_POLL_PERIOD));
   }
 }
 
 #ifdef _SERIAL_DEBUG_MODE_
+/* Serial debug task iterations between SBUS link statistic dumps */
+#define SL_CR_SERIAL_DEBUG_SBUS_STATS_INTERVAL 10
+/* Serial input character requesting a task profile dump */
+#define SL_CR_SERIAL_DEBUG_PROFILE_KEY 'p'
 static void serial_debug_task(void *)
 {
   TickType_t xLastWakeTime;
   const TickType_t xPeriod = pdMS_TO_TICKS(1000);
+  unsigned int iteration = 0;
   xLastWakeTime = xTaskGetTickCount();
   for (;;)
   {
     vTaskDelayUntil(&xLastWakeTime, xPeriod);
 
-    if(drive_data_ptr->left_motor_stack.control_loop)
+#ifndef _BINARY_LOG_
+    /* Statistic dumps carry names and histograms that do not fit a binary log record, text logs only */
+    if(0 == (iteration++ % SL_CR_SERIAL_DEBUG_SBUS_STATS_INTERVAL))
     {
-      SL_CR_LOG_SNPRINTF(LOG_KEY_DEBUG_TASK, LOG_LEVEL_DEBUG, 
-        "Left motor set_rpm: %u motor commanded_rpm: %u encoder rpm: %u error: %u.", 
-        drive_data_ptr->left_motor_stack.driver->get_set_rpm(),
-        drive_data_ptr->left_motor_stack.driver->get_commanded_rpm(),
-        drive_data_ptr->left_motor_stack.driver->get_real_rpm(),
-        drive_data_ptr->left_motor_stack.control_loop->get_error());
+      sl_cr_sbus_log_stats(LOG_KEY_DEBUG_TASK);
     }
-    else
+
+    /* Task profile on demand */
+    bool profile_requested = false;
+    while(Serial.available() > 0)
+    {
+      profile_requested |= (SL_CR_SERIAL_DEBUG_PROFILE_KEY == Serial.read());
+    }
+    if(profile_requested)
+    {
+      sl_cr_profiler_log_stats(LOG_KEY_DEBUG_TASK);
+    }
+
+    sl_cr_latency_log_stats(LOG_KEY_DEBUG_TASK);
+#endif
+
+#ifdef _FAST_CONTROL_LOOP_
+    sl_cr_drive_fast_loop_stats_s fast_loop_stats;
+    sl_cr_drive_get_fast_loop_stats(&fast_loop_stats);
+    sl_cr_log_format<SL_CR_BINLOG_FMT_FAST_CONTROL_LOOP>(LOG_KEY_DEBUG_TASK, LOG_LEVEL_DEBUG,
+      (unsigned int) SL_CR_FAST_CONTROL_LOOP_RATE,
+      (unsigned int) (fast_loop_stats.jitter_max     * 1000ULL / (F_CPU_ACTUAL / 1000000)),
+      (unsigned int) (fast_loop_stats.execution_last * 1000ULL / (F_CPU_ACTUAL / 1000000)),
+      (unsigned int) (fast_loop_stats.execution_max  * 1000ULL / (F_CPU_ACTUAL / 1000000)),
+      fast_loop_stats.count);
+#endif
+
+#ifdef _CYCLIC_EXECUTIVE_
+    sl_cr_cyclic_executive_stats_s      executive_stats;
+    sl_cr_cyclic_executive_slot_stats_s executive_slot_stats[SL_CR_CYCLIC_EXECUTIVE_SLOTS];
+    cyclic_executive.get_stats(&executive_stats, executive_slot_stats);
+    sl_cr_log_format<SL_CR_BINLOG_FMT_CYCLIC_EXECUTIVE>(LOG_KEY_DEBUG_TASK, LOG_LEVEL_DEBUG,
+      executive_stats.utilization, executive_stats.overruns, executive_stats.minor_frames, cyclic_executive.get_major_frame());
+    for(unsigned int s = 0; s < SL_CR_CYCLIC_EXECUTIVE_SLOTS; s++)
     {
-      SL_CR_LOG_SNPRINTF(LOG_KEY_DEBUG_TASK, LOG_LEVEL_DEBUG, 
-        "Left motor set_rpm: %u motor commanded_rpm: %u encoder rpm: %u", 
-        drive_data_ptr->left_motor_stack.driver->get_set_rpm(),
-        drive_data_ptr->left_motor_stack.driver->get_commanded_rpm(),
-        drive_data_ptr->left_motor_stack.driver->get_real_rpm());
+      sl_cr_log_format<SL_CR_BINLOG_FMT_CYCLIC_EXECUTIVE_SLOT>(LOG_KEY_DEBUG_TASK, LOG_LEVEL_DEBUG,
+        s, executive_slot_stats[s].utilization,
+        (unsigned int) (executive_slot_stats[s].execution_max * 1000ULL / (F_CPU_ACTUAL / 1000000)), executive_slot_stats[s].runs);
     }
+#endif
 
-    if(drive_data_ptr->right_motor_stack.control_loop)
+    if(SL_CR_DRIVE_STRATEGY_ARCADE == drive_data_ptr->active_drive_strategy)
     {
-      SL_CR_LOG_SNPRINTF(LOG_KEY_DEBUG_TASK, LOG_LEVEL_DEBUG, 
-        "Reft motor set_rpm: %u motor commanded_rpm: %u encoder rpm: %u error: %u.", 
-        drive_data_ptr->right_motor_stack.driver->get_set_rpm(),
-        drive_data_ptr->right_motor_stack.driver->get_commanded_rpm(),
-        drive_data_ptr->right_motor_stack.driver->get_real_rpm(),
-        drive_data_ptr->right_motor_stack.control_loop->get_error());
+      sl_cr_log_format<SL_CR_BINLOG_FMT_DRIVE_STRATEGY_ARCADE>(LOG_KEY_DEBUG_TASK, LOG_LEVEL_DEBUG);
     }
     else
     {
-      SL_CR_LOG_SNPRINTF(LOG_KEY_DEBUG_TASK, LOG_LEVEL_DEBUG, 
-        "Reft motor set_rpm: %u motor commanded_rpm: %u encoder rpm: %u", 
-        drive_data_ptr->right_motor_stack.driver->get_set_rpm(),
-        drive_data_ptr->right_motor_stack.driver->get_commanded_rpm(),
-        drive_data_ptr->right_motor_stack.driver->get_real_rpm());
+      sl_cr_log_format<SL_CR_BINLOG_FMT_DRIVE_STRATEGY_TANK>(LOG_KEY_DEBUG_TASK, LOG_LEVEL_DEBUG);
+    }
+
+    for(unsigned int m = 0; m < SL_CR_DRIVE_MOTOR_COUNT; m++)
+    {
+      if(drive_data_ptr->motor_stack[m]->get_control_loop())
+      {
+        sl_cr_log_format<SL_CR_BINLOG_FMT_MOTOR_STATE_CLOSED_LOOP>(LOG_KEY_DEBUG_TASK, LOG_LEVEL_DEBUG,
+          m,
+          drive_data_ptr->motor_state.set_rpm[m],
+          drive_data_ptr->motor_state.commanded_rpm[m],
+          drive_data_ptr->motor_state.real_rpm[m],
+          drive_data_ptr->motor_stack[m]->get_control_loop()->get_error());
+      }
+      else
+      {
+        sl_cr_log_format<SL_CR_BINLOG_FMT_MOTOR_STATE>(LOG_KEY_DEBUG_TASK, LOG_LEVEL_DEBUG,
+          m,
+          drive_data_ptr->motor_state.set_rpm[m],
+          drive_data_ptr->motor_state.commanded_rpm[m],
+          drive_data_ptr->motor_state.real_rpm[m]);
+      }
     }
   }
 }
@@ -194,21 +492,55 @@ void setup()
   analogWriteResolution(SL_CR_PWM_RESOLUTION);
 
   /* Begin the SBUS communication */
-  sl_cr_sbus_init();
+  sl_cr_sbus_init(&sbus_task_handle);
   log_cstring(LOG_KEY_BOOT, LOG_LEVEL_INFO, "SBUS Configured.");
 
   drive_data_ptr = sl_cr_drive_init();
+  combat::register_failsafe_hook(control_loop_failsafe_hook);
   log_cstring(LOG_KEY_BOOT, LOG_LEVEL_INFO, "Drive Configured.");
 
+#ifdef _BLACKBOX_
+  /* After control loop failsafe hook, so the motors off tick is recorded before freezing */
+  if(!sl_cr_blackbox_init())
+  {
+    log_cstring(LOG_KEY_BOOT, LOG_LEVEL_ERROR, "Blackbox failsafe trigger not registered.");
+  }
+  blackbox_sd_mounted = blackbox_sd.begin(SdioConfig(FIFO_SDIO));
+  if(blackbox_sd_mounted)
+  {
+    log_cstring(LOG_KEY_BOOT, LOG_LEVEL_INFO, "Blackbox SD card mounted.");
+  }
+  else
+  {
+    log_cstring(LOG_KEY_BOOT, LOG_LEVEL_WARNING, "Blackbox SD card not found, dumps will fail.");
+  }
+#endif
+
   /* Configure FreeRTOS */
   #ifdef _SERIAL_DEBUG_MODE_
   xTaskCreate(serial_debug_task, "Serial Debug Task", SL_CR_DEFAULT_TASK_STACK_SIZE,      nullptr, 1, nullptr);
   #endif
+  #ifdef _SBUS_RECORD_
+  xTaskCreate(sbus_record_task,  "SBUS Record Task",  SL_CR_DEFAULT_TASK_STACK_SIZE,      nullptr, 1, nullptr);
+  #endif
+  #ifdef _BINARY_LOG_
+  xTaskCreate(binlog_task,       "Binary Log Task",   SL_CR_DEFAULT_TASK_STACK_SIZE,      nullptr, 1, nullptr);
+  #endif
+  #ifdef _TELEMETRY_
+  xTaskCreate(telemetry_task,    "Telemetry Task",    SL_CR_DEFAULT_TASK_STACK_SIZE,      nullptr, 1, nullptr);
+  #endif
+  #ifdef _BLACKBOX_
+  xTaskCreate(blackbox_task,     "Blackbox Task",     SL_CR_BLACKBOX_TASK_STACK_SIZE,     nullptr, 1, nullptr);
+  #endif
   xTaskCreate(log_task,          "Log Task",          SL_CR_LOG_TASK_STACK_SIZE,          nullptr, 0, &log_task_handle);
   xTaskCreate(watchdog_task,     "Watchdog Task",     SL_CR_DEFAULT_TASK_STACK_SIZE,      nullptr, 2, nullptr);
-  xTaskCreate(drive_task,        "Drive Task",        SL_CR_DEFAULT_TASK_STACK_SIZE,      nullptr, 5, nullptr);
-  xTaskCreate(sbus_task,         "SBUS Task",         SL_CR_DEFAULT_TASK_STACK_SIZE,      nullptr, 6, nullptr);
-  xTaskCreate(control_loop_task, "Control Loop Task", SL_CR_CONTROL_LOOP_TASK_STACK_SIZE, nullptr, 7, nullptr);
+  #ifdef _CYCLIC_EXECUTIVE_
+  xTaskCreate(cyclic_executive_task, "Cyclic Executive Task", SL_CR_CONTROL_LOOP_TASK_STACK_SIZE, nullptr, 7, nullptr);
+  #else
+  xTaskCreate(drive_task,        "Drive Task",        SL_CR_DEFAULT_TASK_STACK_SIZE,      nullptr, 5, &drive_task_handle);
+  xTaskCreate(sbus_task,         "SBUS Task",         SL_CR_DEFAULT_TASK_STACK_SIZE,      nullptr, 6, &sbus_task_handle);
+  xTaskCreate(control_loop_task, "Control Loop Task", SL_CR_CONTROL_LOOP_TASK_STACK_SIZE, nullptr, 7, &control_loop_task_handle);
+  #endif
   log_cstring(LOG_KEY_BOOT, LOG_LEVEL_INFO, "FreeRTOS Configured.");
 
   /* Bootup Complete */
@@ -221,6 +553,8 @@ void setup()
   sl_cr_drive_register_interrupts();
   log_cstring(LOG_KEY_BOOT, LOG_LEVEL_INFO, "Starting FreeRTOS scheduler.");
 
+  /* Idle and timer task memory is static, starting the scheduler does not allocate */
+  heap_free_at_scheduler_start = xPortGetFreeHeapSize();
   vTaskStartScheduler();
 }
 
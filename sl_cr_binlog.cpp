@@ -0,0 +1,99 @@
+/*
+  sl_cr_binlog.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#include <string.h>
+
+#include "sl_cr_binlog.hpp"
+#include "sl_cr_ring_buffer.hpp"
+
+/* Records buffered between flushes */
+#define SL_CR_BINLOG_BUFFER_SIZE 64
+
+sl_cr_mpsc_ring_buffer_c<sl_cr_binlog_record_s, SL_CR_BINLOG_BUFFER_SIZE> binlog_buffer;
+
+/* Flush state, owned by flushing task */
+bool     binlog_header_written = false;
+uint32_t binlog_dropped_reported = 0;
+/* Record partially accepted by sink */
+uint8_t  binlog_pending[sizeof(sl_cr_binlog_record_s)];
+size_t   binlog_pending_length = 0;
+size_t   binlog_pending_offset = 0;
+
+const sl_cr_binlog_header_s binlog_header =
+{
+  .magic       = SL_CR_BINLOG_MAGIC,
+  .version     = SL_CR_BINLOG_VERSION,
+  .record_size = sizeof(sl_cr_binlog_record_s),
+  .format_hash = sl_cr_binlog_format_hash(),
+};
+
+void sl_cr_binlog_push(const sl_cr_binlog_record_s &record)
+{
+  binlog_buffer.push(record);
+}
+
+/* Writes pending bytes, returns true once all are accepted */
+bool sl_cr_binlog_write_pending(sl_cr_binlog_write_f write, void *user_data)
+{
+  while(binlog_pending_offset < binlog_pending_length)
+  {
+    const size_t written = write(&binlog_pending[binlog_pending_offset], binlog_pending_length - binlog_pending_offset, user_data);
+    if(0 == written)
+    {
+      break;
+    }
+    binlog_pending_offset += written;
+  }
+
+  return (binlog_pending_offset >= binlog_pending_length);
+}
+
+void sl_cr_binlog_set_pending(const void *data, size_t length)
+{
+  memcpy(binlog_pending, data, length);
+  binlog_pending_length = length;
+  binlog_pending_offset = 0;
+}
+
+void sl_cr_binlog_flush(sl_cr_binlog_write_f write, void *user_data)
+{
+  static_assert(sizeof(sl_cr_binlog_header_s) <= sizeof(binlog_pending), "Header must fit in pending buffer");
+  sl_cr_binlog_record_s record;
+
+  if(!binlog_header_written)
+  {
+    sl_cr_binlog_set_pending(&binlog_header, sizeof(binlog_header));
+    binlog_header_written = true;
+  }
+
+  while(sl_cr_binlog_write_pending(write, user_data))
+  {
+    const uint32_t dropped = binlog_buffer.get_dropped();
+
+    if(binlog_buffer.pop(&record))
+    {
+      /* Next buffered record */
+    }
+    else if(dropped != binlog_dropped_reported)
+    {
+      /* Buffer drained, mark where messages were lost */
+      record           = {};
+      record.time      = micros();
+      record.format    = SL_CR_BINLOG_FMT_BINLOG_DROPPED;
+      record.level     = LOG_LEVEL_WARNING;
+      record.arg_count = 1;
+      record.args[0]   = dropped - binlog_dropped_reported;
+      binlog_dropped_reported = dropped;
+    }
+    else
+    {
+      break;
+    }
+
+    sl_cr_binlog_set_pending(&record, sizeof(record));
+  }
+}
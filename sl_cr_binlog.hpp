@@ -0,0 +1,143 @@
+/*
+  sl_cr_binlog.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_BINLOG_HPP__
+#define __SL_CR_BINLOG_HPP__
+
+#include <Arduino.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+#include "sl_cr_binlog_formats.h"
+#include "sl_cr_config.h"
+#include "sl_robot_log.hpp"
+
+/* Binary log format (little-endian):
+     sl_cr_binlog_header_s, followed by back-to-back sl_cr_binlog_record_s until end of stream.
+   Records hold a format ID from sl_cr_binlog_formats.h and its raw arguments, formatting happens on the host.
+   format_hash identifies the format table, the decoder must be built from the same sl_cr_binlog_formats.h. */
+#define SL_CR_BINLOG_MAGIC    0x4C42534C /* "LSBL" */
+#define SL_CR_BINLOG_VERSION  1
+#define SL_CR_BINLOG_MAX_ARGS 6
+
+typedef enum
+{
+#define SL_CR_BINLOG_FORMAT_ID(name, format) SL_CR_BINLOG_FMT_##name,
+  SL_CR_BINLOG_FORMATS(SL_CR_BINLOG_FORMAT_ID)
+#undef SL_CR_BINLOG_FORMAT_ID
+  SL_CR_BINLOG_FMT_COUNT,
+} sl_cr_binlog_format_e;
+
+/* Format strings, indexed by sl_cr_binlog_format_e */
+constexpr const char *sl_cr_binlog_format_strings[SL_CR_BINLOG_FMT_COUNT] =
+{
+#define SL_CR_BINLOG_FORMAT_STRING(name, format) format,
+  SL_CR_BINLOG_FORMATS(SL_CR_BINLOG_FORMAT_STRING)
+#undef SL_CR_BINLOG_FORMAT_STRING
+};
+
+/* Number of arguments consumed by a format string */
+constexpr unsigned int sl_cr_binlog_format_arg_count(const char *format)
+{
+  unsigned int ret_val = 0;
+  for(; *format; format++)
+  {
+    if('%' == format[0])
+    {
+      if('%' == format[1])
+      {
+        format++;
+      }
+      else
+      {
+        ret_val++;
+      }
+    }
+  }
+  return ret_val;
+}
+
+/* FNV-1a hash of all format strings */
+constexpr uint32_t sl_cr_binlog_format_hash()
+{
+  uint32_t ret_val = 2166136261u;
+  for(unsigned int f = 0; f < SL_CR_BINLOG_FMT_COUNT; f++)
+  {
+    for(const char *c = sl_cr_binlog_format_strings[f]; ; c++)
+    {
+      ret_val = (ret_val ^ (uint8_t) *c) * 16777619u;
+      if(0 == *c)
+      {
+        break;
+      }
+    }
+  }
+  return ret_val;
+}
+
+typedef struct __attribute__((packed))
+{
+  uint32_t magic;
+  uint16_t version;
+  /* Size of each record in bytes */
+  uint16_t record_size;
+  uint32_t format_hash;
+} sl_cr_binlog_header_s;
+
+typedef struct __attribute__((packed))
+{
+  /* Time logged (us) */
+  uint32_t time;
+  /* sl_cr_binlog_format_e */
+  uint16_t format;
+  /* log_key_e and log_level_e */
+  uint8_t  key;
+  uint8_t  level;
+  uint8_t  arg_count;
+  uint32_t args[SL_CR_BINLOG_MAX_ARGS];
+} sl_cr_binlog_record_s;
+
+/* Sink for log bytes, returns number of bytes accepted (may be less than length if sink is full) */
+typedef size_t (*sl_cr_binlog_write_f)(const uint8_t *data, size_t length, void *user_data);
+
+/* Queues a record.  Lock-free and safe from any task or ISR, drops and counts the record if the buffer is full */
+void sl_cr_binlog_push(const sl_cr_binlog_record_s &record);
+/* Writes queued records to sink (header first).  Call from a low priority task */
+void sl_cr_binlog_flush(sl_cr_binlog_write_f write, void *user_data);
+
+/* Promotes a log argument to the int or unsigned int its format conversion expects (uint32_t is unsigned long on the target) */
+template <typename arg_t>
+constexpr typename std::conditional<std::is_signed<arg_t>::value, int, unsigned int>::type sl_cr_binlog_format_arg(arg_t arg)
+{
+  return (typename std::conditional<std::is_signed<arg_t>::value, int, unsigned int>::type) arg;
+}
+
+/* Logs a message from the format table.  With _BINARY_LOG_ only the format ID, time and raw arguments are queued,
+     otherwise the message is formatted by log_snprintf */
+template <sl_cr_binlog_format_e format, typename... args_t>
+inline void sl_cr_log_format(log_key_e key, log_level_e level, args_t... args)
+{
+  static_assert(sizeof...(args_t) == sl_cr_binlog_format_arg_count(sl_cr_binlog_format_strings[format]),
+                "Argument count does not match format");
+  static_assert(sizeof...(args_t) <= SL_CR_BINLOG_MAX_ARGS, "Too many arguments for binary log");
+  static_assert((... && (std::is_integral<args_t>::value && (sizeof(args_t) <= sizeof(uint32_t)))),
+                "Binary log arguments must be integers of at most 32 bits");
+
+#ifdef _BINARY_LOG_
+  if(level >= SL_CR_ACTIVE_LOG_LEVEL)
+  {
+    const sl_cr_binlog_record_s record =
+      {(uint32_t) micros(), (uint16_t) format, (uint8_t) key, (uint8_t) level, (uint8_t) sizeof...(args_t), {(uint32_t) args...}};
+    sl_cr_binlog_push(record);
+  }
+#else
+  log_snprintf(key, level, sl_cr_binlog_format_strings[format], sl_cr_binlog_format_arg(args)...);
+#endif
+}
+
+#endif /* __SL_CR_BINLOG_HPP__ */
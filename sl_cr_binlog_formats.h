@@ -0,0 +1,31 @@
+/*
+  sl_cr_binlog_formats.h
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_BINLOG_FORMATS_H__
+#define __SL_CR_BINLOG_FORMATS_H__
+
+/* Log message formats, shared by the device and the host decoder (tools/sl_cr_binlog_decode.cpp).
+     X(name, format) - format ID is position in list, so append new formats and never reorder.
+     Arguments are recorded as raw 32-bit words, formats may only use integer conversions (no %s, %f or 64-bit). */
+#define SL_CR_BINLOG_FORMATS(X) \
+  X(BINLOG_DROPPED,          "Binary log dropped %u messages") \
+  X(FAILSAFE_MASK,           "New failsafe mask: 0x%x at %uus") \
+  X(FAILSAFE_SET,            "FAILSAFE SET!") \
+  X(FAILSAFE_ARMED,          "ARMED!") \
+  X(FAILSAFE_DROPPED,        "Failsafe transitions dropped: %u") \
+  X(FAILSAFE_TO_OFF_BOUND,   "Failsafe to motors off took %uus, bound is %uus!") \
+  X(DRIVE_STRATEGY_ARCADE,   "Drive strategy: Arcade.") \
+  X(DRIVE_STRATEGY_TANK,     "Drive strategy: Tank.") \
+  X(MOTOR_STATE,             "Motor %u set_rpm: %d motor commanded_rpm: %d encoder rpm: %d") \
+  X(MOTOR_STATE_CLOSED_LOOP, "Motor %u set_rpm: %d motor commanded_rpm: %d encoder rpm: %d error: %d.") \
+  X(FAST_CONTROL_LOOP,       "Fast control loop %uHz jitter max: %uns execution last: %uns max: %uns ticks: %u.") \
+  X(BLACKBOX_DUMPED,         "Blackbox dump written, trigger %u at %uus drive: %u rc: %u failsafe: %u records.") \
+  X(BLACKBOX_DUMP_FAILED,    "Blackbox dump failed, trigger %u at %uus!") \
+  X(CYCLIC_EXECUTIVE,        "Cyclic executive utilization: %u/1000 overruns: %u minor frames: %u major frame: %u.") \
+  X(CYCLIC_EXECUTIVE_SLOT,   "  Slot %u utilization: %u/1000 execution max: %uns runs: %u.")
+
+#endif /* __SL_CR_BINLOG_FORMATS_H__ */
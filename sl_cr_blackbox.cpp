@@ -0,0 +1,269 @@
+/*
+  sl_cr_blackbox.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#include <Arduino.h>
+#include <atomic>
+
+#include "sl_cr_binlog.hpp"
+#include "sl_cr_blackbox.hpp"
+#include "sl_cr_config.h"
+#include "sl_cr_cyclic_executive.hpp"
+
+using namespace sandor_laboratories::robot;
+
+/* Upper bound of control loop ticks per second */
+#if defined(_CYCLIC_EXECUTIVE_)
+#define SL_CR_BLACKBOX_DRIVE_RATE (1000 / SL_CR_CYCLIC_EXECUTIVE_MINOR_FRAME)
+#elif defined(_PIPELINED_DRIVE_)
+/* Control loop runs early for every RC frame */
+#define SL_CR_BLACKBOX_DRIVE_RATE (1000000 / SL_CR_SBUS_MIN_PERIOD)
+#else
+#define SL_CR_BLACKBOX_DRIVE_RATE (1000 / SL_CR_CONTROL_LOOP_PERIOD)
+#endif
+/* Upper bound of published RC frames per second */
+#define SL_CR_BLACKBOX_RC_RATE (1000000 / SL_CR_SBUS_MIN_PERIOD)
+
+#define SL_CR_BLACKBOX_DRIVE_RECORDS (SL_CR_BLACKBOX_DURATION * SL_CR_BLACKBOX_DRIVE_RATE)
+#define SL_CR_BLACKBOX_RC_RECORDS    (SL_CR_BLACKBOX_DURATION * SL_CR_BLACKBOX_RC_RATE)
+
+/* Operator trigger channel threshold */
+#define SL_CR_BLACKBOX_TRIGGER_THRESHOLD ((SL_CR_RC_CH_MAX_VALUE*90)/100)
+
+/* Last capacity records of one stream, recording overwrites the oldest */
+template <typename record_t, unsigned int capacity>
+class sl_cr_blackbox_stream_c
+{
+  private:
+    record_t              records[capacity];
+    /* Free-running count of records claimed since last reset */
+    std::atomic<uint32_t> next;
+
+  public:
+    sl_cr_blackbox_stream_c() : records(), next(0) {}
+
+    /* Claims the slot for a new record.  Any number of writers */
+    inline record_t *claim()
+    {
+      return &records[next.fetch_add(1, std::memory_order_relaxed) % capacity];
+    }
+
+    /* Number of records held */
+    inline uint32_t get_count() const
+    {
+      const uint32_t claimed = next.load(std::memory_order_relaxed);
+      return (claimed < capacity)?claimed:capacity;
+    }
+
+    /* Writes held records to storage, oldest first.  Only while no writer is recording */
+    bool write(const sl_cr_blackbox_storage_s *storage) const
+    {
+      const uint32_t count = get_count();
+      const uint32_t first = (next.load(std::memory_order_relaxed) - count) % capacity;
+      /* Oldest records run to end of array, the rest wrap to the start */
+      const uint32_t tail_count = ((first + count) > capacity)?(capacity - first):count;
+
+      return storage->write((const uint8_t *) &records[first], tail_count * sizeof(record_t), storage->user_data) &&
+             ((tail_count == count) ||
+              storage->write((const uint8_t *) &records[0], (count - tail_count) * sizeof(record_t), storage->user_data));
+    }
+
+    inline void reset() {next.store(0, std::memory_order_relaxed);}
+};
+
+sl_cr_blackbox_stream_c<sl_cr_blackbox_drive_record_s,    SL_CR_BLACKBOX_DRIVE_RECORDS>    blackbox_drive;
+sl_cr_blackbox_stream_c<sl_cr_blackbox_rc_record_s,       SL_CR_BLACKBOX_RC_RECORDS>       blackbox_rc;
+sl_cr_blackbox_stream_c<sl_cr_blackbox_failsafe_record_s, SL_CR_BLACKBOX_FAILSAFE_RECORDS> blackbox_failsafe;
+
+/* Set by trigger, cleared by flush.  Recording is skipped while set */
+std::atomic<bool> blackbox_frozen(false);
+/* Written only by the trigger that froze recording */
+sl_cr_blackbox_trigger_e blackbox_trigger_reason;
+sl_cr_time_us_t          blackbox_trigger_time;
+combat::failsafe_mask_t  blackbox_trigger_mask;
+
+/* Operator trigger channel was on in last RC frame, owned by SBUS task */
+bool blackbox_operator_on = false;
+
+static inline int16_t sl_cr_blackbox_saturate(int32_t value)
+{
+  return (value > INT16_MAX)?INT16_MAX:((value < INT16_MIN)?INT16_MIN:value);
+}
+
+static void sl_cr_blackbox_failsafe_hook()
+{
+  if(0 != (combat::get_failsafe_mask() & (SL_CR_BLACKBOX_FAILSAFE_TRIGGERS)))
+  {
+    sl_cr_blackbox_trigger(SL_CR_BLACKBOX_TRIGGER_FAILSAFE);
+  }
+}
+
+bool sl_cr_blackbox_init()
+{
+  return combat::register_failsafe_hook(sl_cr_blackbox_failsafe_hook);
+}
+
+void sl_cr_blackbox_record_drive(const sl_cr_drive_motor_state_s *motor_state)
+{
+  if(!blackbox_frozen.load(std::memory_order_acquire))
+  {
+    sl_cr_blackbox_drive_record_s * const record = blackbox_drive.claim();
+
+    record->time = micros();
+    for(unsigned int m = 0; m < SL_CR_DRIVE_MOTOR_COUNT; m++)
+    {
+      record->motor[m].set_rpm       = sl_cr_blackbox_saturate(motor_state->set_rpm[m]);
+      record->motor[m].commanded_rpm = sl_cr_blackbox_saturate(motor_state->commanded_rpm[m]);
+      record->motor[m].real_rpm      = sl_cr_blackbox_saturate(motor_state->real_rpm[m]);
+    }
+  }
+}
+
+void sl_cr_blackbox_record_rc(const sl_cr_sbus_frame_s *frame)
+{
+  if(!blackbox_frozen.load(std::memory_order_acquire))
+  {
+    sl_cr_blackbox_rc_record_s * const record = blackbox_rc.claim();
+
+    record->rx_time = frame->rx_time;
+    record->flags   = (frame->failsafe?SL_CR_BLACKBOX_RC_FAILSAFE:0) |
+                      (frame->lost_frame?SL_CR_BLACKBOX_RC_LOST_FRAME:0) |
+                      (frame->stale?SL_CR_BLACKBOX_RC_STALE:0) |
+                      (frame->receiver << SL_CR_BLACKBOX_RC_RECEIVER_SHIFT);
+    for(unsigned int c = 0; c < SL_CR_SBUS_NUM_CH; c++)
+    {
+      record->ch[c] = frame->ch[c];
+    }
+  }
+
+  /* Trigger on switching on, holding the switch does not retrigger after a flush */
+  const sl_cr_rc_channel_value_t operator_raw = sl_cr_sbus_get_frame_ch_value(frame, SL_CR_BLACKBOX_TRIGGER_CH);
+  const bool operator_on = SL_CR_RC_CH_VALUE_VALID(operator_raw) && (operator_raw > SL_CR_BLACKBOX_TRIGGER_THRESHOLD);
+  if(operator_on && !blackbox_operator_on)
+  {
+    sl_cr_blackbox_trigger(SL_CR_BLACKBOX_TRIGGER_OPERATOR);
+  }
+  blackbox_operator_on = operator_on;
+}
+
+void sl_cr_blackbox_record_failsafe(sl_cr_time_us_t time, combat::failsafe_mask_t old_mask, combat::failsafe_mask_t new_mask)
+{
+  if(!blackbox_frozen.load(std::memory_order_acquire))
+  {
+    sl_cr_blackbox_failsafe_record_s * const record = blackbox_failsafe.claim();
+
+    record->time     = time;
+    record->old_mask = old_mask;
+    record->new_mask = new_mask;
+  }
+}
+
+void sl_cr_blackbox_trigger(sl_cr_blackbox_trigger_e trigger)
+{
+  bool frozen = false;
+
+  if(blackbox_frozen.compare_exchange_strong(frozen, true, std::memory_order_acq_rel))
+  {
+    blackbox_trigger_reason = trigger;
+    blackbox_trigger_time   = micros();
+    blackbox_trigger_mask   = combat::get_failsafe_mask();
+  }
+}
+
+bool sl_cr_blackbox_flush(const sl_cr_blackbox_storage_s *storage, log_key_e log_key)
+{
+  bool ret_val = false;
+
+  /* Writers and the trigger run above flushing task priority, any record or trigger in progress at freeze has completed */
+  if(blackbox_frozen.load(std::memory_order_acquire))
+  {
+    sl_cr_blackbox_header_s header;
+
+    header.magic                = SL_CR_BLACKBOX_MAGIC;
+    header.version              = SL_CR_BLACKBOX_VERSION;
+    header.trigger              = blackbox_trigger_reason;
+    header.motor_count          = SL_CR_DRIVE_MOTOR_COUNT;
+    header.channel_count        = SL_CR_SBUS_NUM_CH;
+    header.trigger_time         = blackbox_trigger_time;
+    header.failsafe_mask        = blackbox_trigger_mask;
+    header.drive_record_size    = sizeof(sl_cr_blackbox_drive_record_s);
+    header.rc_record_size       = sizeof(sl_cr_blackbox_rc_record_s);
+    header.failsafe_record_size = sizeof(sl_cr_blackbox_failsafe_record_s);
+    header.drive_count          = blackbox_drive.get_count();
+    header.rc_count             = blackbox_rc.get_count();
+    header.failsafe_count       = blackbox_failsafe.get_count();
+
+    if(storage->open(storage->user_data))
+    {
+      ret_val = storage->write((const uint8_t *) &header, sizeof(header), storage->user_data) &&
+                blackbox_drive.write(storage) &&
+                blackbox_rc.write(storage) &&
+                blackbox_failsafe.write(storage);
+      ret_val = storage->close(storage->user_data) && ret_val;
+    }
+
+    if(ret_val)
+    {
+      sl_cr_log_format<SL_CR_BINLOG_FMT_BLACKBOX_DUMPED>(log_key, LOG_LEVEL_INFO,
+        (unsigned int) header.trigger, header.trigger_time, header.drive_count, header.rc_count, header.failsafe_count);
+    }
+    else
+    {
+      sl_cr_log_format<SL_CR_BINLOG_FMT_BLACKBOX_DUMP_FAILED>(log_key, LOG_LEVEL_ERROR, (unsigned int) header.trigger, header.trigger_time);
+    }
+
+    /* Resume recording from empty, whether or not dump was written */
+    blackbox_drive.reset();
+    blackbox_rc.reset();
+    blackbox_failsafe.reset();
+    blackbox_frozen.store(false, std::memory_order_release);
+  }
+
+  return ret_val;
+}
+
+#ifndef ARDUINO
+static bool sl_cr_blackbox_file_open(void *user_data)
+{
+  sl_cr_blackbox_file_storage_s * const file_storage = (sl_cr_blackbox_file_storage_s *) user_data;
+  char path[FILENAME_MAX];
+
+  snprintf(path, sizeof(path), "%s%u.bin", file_storage->prefix, file_storage->dumps);
+  file_storage->file = fopen(path, "wb");
+  file_storage->dumps += (nullptr != file_storage->file)?1:0;
+
+  return (nullptr != file_storage->file);
+}
+
+static bool sl_cr_blackbox_file_write(const uint8_t *data, size_t length, void *user_data)
+{
+  sl_cr_blackbox_file_storage_s * const file_storage = (sl_cr_blackbox_file_storage_s *) user_data;
+
+  return (length == fwrite(data, 1, length, file_storage->file));
+}
+
+static bool sl_cr_blackbox_file_close(void *user_data)
+{
+  sl_cr_blackbox_file_storage_s * const file_storage = (sl_cr_blackbox_file_storage_s *) user_data;
+  const bool ret_val = (0 == fclose(file_storage->file));
+
+  file_storage->file = nullptr;
+
+  return ret_val;
+}
+
+void sl_cr_blackbox_file_storage_init(sl_cr_blackbox_file_storage_s *file_storage, const char *prefix, sl_cr_blackbox_storage_s *storage)
+{
+  file_storage->prefix = prefix;
+  file_storage->dumps  = 0;
+  file_storage->file   = nullptr;
+
+  storage->open      = sl_cr_blackbox_file_open;
+  storage->write     = sl_cr_blackbox_file_write;
+  storage->close     = sl_cr_blackbox_file_close;
+  storage->user_data = file_storage;
+}
+#endif
@@ -0,0 +1,157 @@
+/*
+  sl_cr_blackbox.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_BLACKBOX_HPP__
+#define __SL_CR_BLACKBOX_HPP__
+
+#include <stddef.h>
+#include <stdint.h>
+#ifndef ARDUINO
+#include <stdio.h>
+#endif
+
+#include "sl_cr_drive.hpp"
+#include "sl_cr_failsafe.hpp"
+#include "sl_cr_sbus.hpp"
+#include "sl_cr_types.hpp"
+#include "sl_robot_log.hpp"
+
+/* Blackbox dump format (little-endian), one dump per trigger:
+     sl_cr_blackbox_header_s
+     sl_cr_blackbox_drive_record_s    drive_count times,    oldest first
+     sl_cr_blackbox_rc_record_s       rc_count times,       oldest first
+     sl_cr_blackbox_failsafe_record_s failsafe_count times, oldest first
+   Drive and RC streams hold at least the last SL_CR_BLACKBOX_DURATION seconds before the trigger, failsafe transitions the last
+     SL_CR_BLACKBOX_FAILSAFE_RECORDS.  Records are fixed width, sizes are in the header so a decoder can check layout. */
+#define SL_CR_BLACKBOX_MAGIC   0x42424C53 /* "SLBB" */
+#define SL_CR_BLACKBOX_VERSION 1
+
+/* Failsafe transitions kept */
+#define SL_CR_BLACKBOX_FAILSAFE_RECORDS 64
+
+/* Reason recording was frozen */
+typedef enum
+{
+  /* Failsafe entered for a reason in SL_CR_BLACKBOX_FAILSAFE_TRIGGERS */
+  SL_CR_BLACKBOX_TRIGGER_FAILSAFE,
+  /* Watchdog fed late, close to expiring */
+  SL_CR_BLACKBOX_TRIGGER_WATCHDOG,
+  /* Operator switched SL_CR_BLACKBOX_TRIGGER_CH on */
+  SL_CR_BLACKBOX_TRIGGER_OPERATOR,
+} sl_cr_blackbox_trigger_e;
+
+typedef struct __attribute__((packed))
+{
+  uint32_t magic;
+  uint16_t version;
+  /* sl_cr_blackbox_trigger_e */
+  uint8_t  trigger;
+  uint8_t  motor_count;
+  uint8_t  channel_count;
+  /* Time of trigger (us) and failsafe mask at trigger */
+  uint32_t trigger_time;
+  uint32_t failsafe_mask;
+  /* Size of each record in bytes */
+  uint16_t drive_record_size;
+  uint16_t rc_record_size;
+  uint16_t failsafe_record_size;
+  /* Number of records of each stream that follow */
+  uint32_t drive_count;
+  uint32_t rc_count;
+  uint32_t failsafe_count;
+} sl_cr_blackbox_header_s;
+
+typedef struct __attribute__((packed))
+{
+  int16_t set_rpm;
+  int16_t commanded_rpm;
+  int16_t real_rpm;
+} sl_cr_blackbox_motor_s;
+
+/* One control loop tick */
+typedef struct __attribute__((packed))
+{
+  /* Control loop tick time (us) */
+  uint32_t               time;
+  sl_cr_blackbox_motor_s motor[SL_CR_DRIVE_MOTOR_COUNT];
+} sl_cr_blackbox_drive_record_s;
+
+/* Flags of an RC record */
+#define SL_CR_BLACKBOX_RC_FAILSAFE   0x01
+#define SL_CR_BLACKBOX_RC_LOST_FRAME 0x02
+#define SL_CR_BLACKBOX_RC_STALE      0x04
+/* Receiver index in upper bits */
+#define SL_CR_BLACKBOX_RC_RECEIVER_SHIFT 4
+
+/* One published RC frame */
+typedef struct __attribute__((packed))
+{
+  /* Receive time (us), or time stale state was published */
+  uint32_t rx_time;
+  uint8_t  flags;
+  uint16_t ch[SL_CR_SBUS_NUM_CH];
+} sl_cr_blackbox_rc_record_s;
+
+/* One failsafe mask transition */
+typedef struct __attribute__((packed))
+{
+  uint32_t time;
+  uint16_t old_mask;
+  uint16_t new_mask;
+} sl_cr_blackbox_failsafe_record_s;
+
+/* Layout is fixed by host decoder */
+static_assert(35 == sizeof(sl_cr_blackbox_header_s),          "Blackbox header layout changed");
+static_assert(6  == sizeof(sl_cr_blackbox_motor_s),           "Blackbox motor layout changed");
+static_assert(37 == sizeof(sl_cr_blackbox_rc_record_s),       "Blackbox RC record layout changed");
+static_assert(8  == sizeof(sl_cr_blackbox_failsafe_record_s), "Blackbox failsafe record layout changed");
+
+/* Persistent storage a dump is written to.  Called only from the flushing task, may block */
+typedef struct
+{
+  /* Starts a new dump, returns false if storage is unavailable */
+  bool (*open)(void *user_data);
+  /* Appends bytes to dump, returns false on error */
+  bool (*write)(const uint8_t *data, size_t length, void *user_data);
+  /* Completes dump, returns false on error */
+  bool (*close)(void *user_data);
+  void  *user_data;
+} sl_cr_blackbox_storage_s;
+
+/* Registers failsafe entry trigger, returns false if no failsafe hook is free.
+     Call after registering any failsafe hook that turns motors off, so the off tick is recorded before freezing */
+bool sl_cr_blackbox_init();
+
+/* Records one control loop tick.  Call from control loop after motor state is updated */
+void sl_cr_blackbox_record_drive(const sl_cr_drive_motor_state_s *motor_state);
+/* Records a published RC frame and checks operator trigger channel.  Call from SBUS task */
+void sl_cr_blackbox_record_rc(const sl_cr_sbus_frame_s *frame);
+/* Records a failsafe mask transition.  Any task */
+void sl_cr_blackbox_record_failsafe(sl_cr_time_us_t time, sandor_laboratories::robot::combat::failsafe_mask_t old_mask,
+                                    sandor_laboratories::robot::combat::failsafe_mask_t new_mask);
+
+/* Freezes recording until the next flush.  Ignored if already frozen.  Any task or ISR */
+void sl_cr_blackbox_trigger(sl_cr_blackbox_trigger_e trigger);
+
+/* Writes frozen recording to storage and logs the result, then resumes recording.  Returns true if a dump was written.
+     Call from a task below every recording task's priority, so no record is still being written when it is read */
+bool sl_cr_blackbox_flush(const sl_cr_blackbox_storage_s *storage, log_key_e log_key);
+
+#ifndef ARDUINO
+/* Host stand-in for persistent storage, dump n is written to file "<prefix><n>.bin" */
+typedef struct
+{
+  const char   *prefix;
+  unsigned int  dumps;
+  FILE         *file;
+} sl_cr_blackbox_file_storage_s;
+
+/* Fills storage with callbacks writing to files */
+void sl_cr_blackbox_file_storage_init(sl_cr_blackbox_file_storage_s *file_storage, const char *prefix, sl_cr_blackbox_storage_s *storage);
+#endif
+
+#endif /* __SL_CR_BLACKBOX_HPP__ */
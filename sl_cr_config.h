@@ -21,15 +21,35 @@
 /////////////////TOP LEVEL CONFIGURATION ////////////////////////
 //#define _BENCH_SAFE_MODE_
 //#define _COMBAT_MODE_
+/* Robot descriptor to build (see sl_cr_robot.hpp), host tools supply their own */
+#ifndef SL_CR_ROBOT
+#define SL_CR_ROBOT sl_cr_robot_drv8256p_s
+#endif
 /////////////////////////////////////////////////////////////////
 
 
 
 /////////////////////////////////////////////////////////////////
 //////////////////// FEATURIZATION //////////////////////////////
-#define _ARCADE_DRIVE_
 //#define _FORCE_LIMP_MODE_
 //#define _SERIAL_DEBUG_MODE_
+/* New SBUS frames immediately wake drive strategy, which immediately wakes control loop */
+//#define _PIPELINED_DRIVE_
+/* Second SBUS receiver on Serial3, merged per frame with the receiver on Serial1 */
+//#define _DUAL_SBUS_RECEIVER_
+/* Stream raw SBUS frames in replayable binary format (see sl_cr_sbus_record.hpp) over SL_CR_SBUS_RECORD_PORT */
+//#define _SBUS_RECORD_
+/* Encoder, PID and motor drivers run from a hardware timer at SL_CR_FAST_CONTROL_LOOP_RATE, control loop task only samples motor state */
+//#define _FAST_CONTROL_LOOP_
+/* Drive, control loop and SBUS run from one task on a static schedule (see sl_cr_cyclic_executive.hpp) */
+//#define _CYCLIC_EXECUTIVE_
+/* Messages from the binary log format table are queued unformatted and streamed over SL_CR_BINLOG_PORT (see sl_cr_binlog.hpp) */
+//#define _BINARY_LOG_
+/* Stream every control loop tick's motor, failsafe and RC state over SL_CR_TELEMETRY_PORT (see sl_cr_telemetry.hpp) */
+//#define _TELEMETRY_
+/* Keep the last seconds of drive, RC and failsafe state in RAM, dumped to SD card on a trigger (see sl_cr_blackbox.hpp).
+     Fixed size records and no allocation, safe to keep in _COMBAT_MODE_ builds */
+//#define _BLACKBOX_
 /////////////////////////////////////////////////////////////////
 //////////////// IMPLICIT FEATURIZATION /////////////////////////
 #ifdef _BENCH_SAFE_MODE_
@@ -40,6 +60,16 @@
   #define _VIRTUAL_MOTORS_
   #undef  _COMBAT_MODE_
 #endif
+#if defined(_CYCLIC_EXECUTIVE_) && defined(_PIPELINED_DRIVE_)
+  #error "_CYCLIC_EXECUTIVE_ runs on a static schedule and cannot be pipelined"
+#endif
+#if defined(_BINARY_LOG_) && defined(_SBUS_RECORD_)
+  #error "_BINARY_LOG_ and _SBUS_RECORD_ share a port"
+#endif
+#ifdef _VIRTUAL_MOTORS_
+  #undef  SL_CR_ROBOT
+  #define SL_CR_ROBOT sl_cr_robot_virtual_s
+#endif
 /////////////////////////////////////////////////////////////////
 
 
@@ -57,6 +87,7 @@
 
 /////////////////////////////////////////////////////////////////
 /////////////////// Pin Assignments /////////////////////////////
+/* Pin 0 (Serial1 RX) and pin 15 (Serial3 RX) are reserved for SBUS receivers */
 #define SL_CR_PIN_DRIVE_MOTOR_1_IN1   2
 #define SL_CR_PIN_DRIVE_MOTOR_1_IN2   3
 #define SL_CR_PIN_DRIVE_MOTOR_1_FAULT SL_CR_PIN_INVALID
@@ -81,6 +112,67 @@
 
 
 
+/////////////////////////////////////////////////////////////////
+////////////////// RC Channel Calibration ///////////////////////
+/* {min, center, max, deadzone, expo (%), reverse}, see sl_cr_rc_map_config_s.
+     Divisions are done at compile time, changing these has no runtime cost */
+#define SL_CR_RC_MAP_DEFAULT_CONFIG {SL_CR_RC_CH_MIN_VALUE, SL_CR_RC_CH_CENTER_VALUE, SL_CR_RC_CH_MAX_VALUE, 50, 0, false}
+#define SL_CR_RC_MAP_CH1_CONFIG     SL_CR_RC_MAP_DEFAULT_CONFIG
+#define SL_CR_RC_MAP_CH2_CONFIG     SL_CR_RC_MAP_DEFAULT_CONFIG
+#define SL_CR_RC_MAP_CH3_CONFIG     SL_CR_RC_MAP_DEFAULT_CONFIG
+#define SL_CR_RC_MAP_CH4_CONFIG     SL_CR_RC_MAP_DEFAULT_CONFIG
+/////////////////////////////////////////////////////////////////
+
+
+
+/////////////////////////////////////////////////////////////////
+/////////////////// SBUS Recording //////////////////////////////
+/* Second USB serial port, requires USB Type "Dual Serial" */
+#define SL_CR_SBUS_RECORD_PORT   SerialUSB1
+/* Period to flush recorded frames (ms) */
+#define SL_CR_SBUS_RECORD_PERIOD 50
+/////////////////////////////////////////////////////////////////
+
+
+
+/////////////////////////////////////////////////////////////////
+///////////////////// Binary Log ////////////////////////////////
+/* Second USB serial port, requires USB Type "Dual Serial" */
+#define SL_CR_BINLOG_PORT   SerialUSB1
+/* Period to flush queued messages (ms) */
+#define SL_CR_BINLOG_PERIOD 50
+/////////////////////////////////////////////////////////////////
+
+
+
+/////////////////////////////////////////////////////////////////
+////////////////////// Telemetry ////////////////////////////////
+/* Third USB serial port, requires USB Type "Triple Serial" */
+#define SL_CR_TELEMETRY_PORT       SerialUSB2
+/* Period to flush queued frames (ms) */
+#define SL_CR_TELEMETRY_PERIOD     10
+/* Control loop ticks per telemetry frame */
+#define SL_CR_TELEMETRY_DECIMATION 1
+/////////////////////////////////////////////////////////////////
+
+
+
+/////////////////////////////////////////////////////////////////
+/////////////////////// Blackbox ////////////////////////////////
+/* Seconds of history kept before a trigger.  RAM use is ~16 bytes per control loop tick and ~37 bytes per RC frame per second
+     (~28kB/s with _CYCLIC_EXECUTIVE_, ~14kB/s otherwise) */
+#define SL_CR_BLACKBOX_DURATION          5
+/* Failsafe reasons whose entry triggers a dump.  Not the arm switch, every disarm would freeze the recording; the watchdog and
+     the operator channel trigger on their own */
+#define SL_CR_BLACKBOX_FAILSAFE_TRIGGERS ((1 << combat::FAILSAFE_SBUS) | (1 << combat::FAILSAFE_SBUS_STALE))
+/* Period to check for a frozen recording to dump (ms) */
+#define SL_CR_BLACKBOX_PERIOD            100
+/* Dumps are written to Teensy 4.1 SD socket as BB000.BIN to BB999.BIN */
+#define SL_CR_BLACKBOX_SD_MAX_FILES      1000
+/////////////////////////////////////////////////////////////////
+
+
+
 /////////////////////////////////////////////////////////////////
 /////////////////////// FreeRTOS ////////////////////////////////
 /* Default stack size to use for FreeRTOS Tasks (in words) */
@@ -88,6 +180,8 @@
 #define SL_CR_DEFAULT_TASK_STACK_SIZE 256
 /* Loop Task stack sizes */
 #define SL_CR_CONTROL_LOOP_TASK_STACK_SIZE SL_CR_DEFAULT_TASK_STACK_SIZE
+/* SD card file system needs a larger stack */
+#define SL_CR_BLACKBOX_TASK_STACK_SIZE 1024
 #ifdef _VIRTUAL_MOTORS_
 /* Larger stack required for strings */
 #undef  SL_CR_CONTROL_LOOP_TASK_STACK_SIZE
@@ -0,0 +1,214 @@
+/*
+  sl_cr_cyclic_executive.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_CYCLIC_EXECUTIVE_HPP__
+#define __SL_CR_CYCLIC_EXECUTIVE_HPP__
+
+#include <Arduino.h>
+#include <atomic>
+#include <stdint.h>
+
+#include "sl_robot_utils.hpp"
+
+/* Minor frame length (ms), one FreeRTOS tick */
+#define SL_CR_CYCLIC_EXECUTIVE_MINOR_FRAME 1
+/* Minor frames per utilization measurement window */
+#define SL_CR_CYCLIC_EXECUTIVE_STATS_WINDOW 1000
+
+typedef void (*sl_cr_cyclic_executive_f)();
+
+/* One entry of a static schedule */
+typedef struct
+{
+  const char               *name;
+  sl_cr_cyclic_executive_f  function;
+  /* Runs every period minor frames, in the minor frame offset into that period */
+  unsigned int              period;
+  unsigned int              offset;
+} sl_cr_cyclic_executive_slot_s;
+
+typedef struct
+{
+  /* Number of runs */
+  unsigned int runs;
+  /* Latest and worst-case execution time (cycles) */
+  uint32_t     execution_last;
+  uint32_t     execution_max;
+  /* Share of CPU over last measurement window (per mille) */
+  unsigned int utilization;
+} sl_cr_cyclic_executive_slot_stats_s;
+
+typedef struct
+{
+  /* Minor frames run */
+  unsigned int minor_frames;
+  /* Minor frames whose slots did not finish within the frame */
+  unsigned int overruns;
+  /* Share of CPU used by all slots over last measurement window (per mille) */
+  unsigned int utilization;
+} sl_cr_cyclic_executive_stats_s;
+
+constexpr unsigned int sl_cr_cyclic_executive_gcd(unsigned int a, unsigned int b)
+{
+  return (0 == b)?a:sl_cr_cyclic_executive_gcd(b, a % b);
+}
+
+/* Major frame length (minor frames), least common multiple of all slot periods */
+template <unsigned int slot_count>
+constexpr unsigned int sl_cr_cyclic_executive_major_frame(const sl_cr_cyclic_executive_slot_s (&schedule)[slot_count])
+{
+  unsigned int ret_val = 1;
+  for(unsigned int s = 0; s < slot_count; s++)
+  {
+    ret_val = (ret_val / sl_cr_cyclic_executive_gcd(ret_val, schedule[s].period)) * schedule[s].period;
+  }
+  return ret_val;
+}
+
+/* True if every slot has a valid offset and slots are ordered from highest to lowest rate */
+template <unsigned int slot_count>
+constexpr bool sl_cr_cyclic_executive_valid(const sl_cr_cyclic_executive_slot_s (&schedule)[slot_count])
+{
+  bool ret_val = true;
+  for(unsigned int s = 0; s < slot_count; s++)
+  {
+    ret_val = ret_val && (schedule[s].period > 0) && (schedule[s].offset < schedule[s].period) &&
+              ((0 == s) || (schedule[s - 1].period <= schedule[s].period));
+  }
+  return ret_val;
+}
+
+/* Runs a static schedule from a single task.
+     Each minor frame runs every due slot in table order, so a rate-monotonic table gives higher rates first.
+     Slots are run to completion, never preempted by each other, and must not block.
+     A slot can be requested to run early (request_run()), it runs from the executive task as soon as the slot in progress returns. */
+template <unsigned int slot_count>
+class sl_cr_cyclic_executive_c
+{
+  static_assert(slot_count <= 32, "Slot run requests are one bit per slot");
+
+  private:
+    const sl_cr_cyclic_executive_slot_s (&schedule)[slot_count];
+    const unsigned int major_frame;
+    const uint32_t     minor_frame_cycles;
+
+    /* Minor frame within major frame */
+    unsigned int frame;
+
+    /* Busy cycles in current measurement window */
+    uint32_t     window_cycles[slot_count];
+    unsigned int window_frames;
+
+    /* Written only by executive task */
+    sl_cr_cyclic_executive_stats_s      stats;
+    sl_cr_cyclic_executive_slot_stats_s slot_stats[slot_count];
+
+    /* Slots requested to run early, one bit per slot */
+    std::atomic<uint32_t> requested_slots;
+
+    void run_slot(unsigned int s)
+    {
+      const uint32_t start = ARM_DWT_CYCCNT;
+      schedule[s].function();
+      const uint32_t execution = ARM_DWT_CYCCNT - start;
+
+      window_cycles[s] += execution;
+
+      critical_section_enter();
+      slot_stats[s].runs++;
+      slot_stats[s].execution_last = execution;
+      slot_stats[s].execution_max  = (execution > slot_stats[s].execution_max)?execution:slot_stats[s].execution_max;
+      critical_section_exit();
+    }
+
+    /* Runs every requested slot once, in table order */
+    void run_requested_slots()
+    {
+      uint32_t requested = requested_slots.exchange(0, std::memory_order_acquire);
+      for(unsigned int s = 0; (s < slot_count) && (0 != requested); s++)
+      {
+        if(requested & (1UL << s))
+        {
+          requested &= ~(1UL << s);
+          run_slot(s);
+        }
+      }
+    }
+
+  public:
+    sl_cr_cyclic_executive_c(const sl_cr_cyclic_executive_slot_s (&schedule)[slot_count])
+      : schedule(schedule),
+        major_frame(sl_cr_cyclic_executive_major_frame(schedule)),
+        minor_frame_cycles((F_CPU_ACTUAL / 1000) * SL_CR_CYCLIC_EXECUTIVE_MINOR_FRAME),
+        frame(0), window_cycles{0}, window_frames(0), stats{0}, slot_stats{}, requested_slots(0)
+    {
+    }
+
+    /* Runs slots due this minor frame.  Call once per minor frame, returns true on overrun */
+    bool minor_frame()
+    {
+      const uint32_t frame_start = ARM_DWT_CYCCNT;
+
+      /* Requested between frames */
+      run_requested_slots();
+      for(unsigned int s = 0; s < slot_count; s++)
+      {
+        if((frame % schedule[s].period) == schedule[s].offset)
+        {
+          run_slot(s);
+          /* Requested by the slot just run */
+          run_requested_slots();
+        }
+      }
+
+      const bool overrun = ((ARM_DWT_CYCCNT - frame_start) > minor_frame_cycles);
+      frame = (frame + 1) % major_frame;
+
+      critical_section_enter();
+      stats.minor_frames++;
+      stats.overruns += overrun?1:0;
+      if(++window_frames >= SL_CR_CYCLIC_EXECUTIVE_STATS_WINDOW)
+      {
+        const uint64_t window_total = (uint64_t) minor_frame_cycles * window_frames;
+        uint64_t       busy_total   = 0;
+        for(unsigned int s = 0; s < slot_count; s++)
+        {
+          slot_stats[s].utilization = (unsigned int) ((window_cycles[s] * 1000ULL) / window_total);
+          busy_total      += window_cycles[s];
+          window_cycles[s] = 0;
+        }
+        stats.utilization = (unsigned int) ((busy_total * 1000ULL) / window_total);
+        window_frames     = 0;
+      }
+      critical_section_exit();
+
+      return overrun;
+    }
+
+    /* Requests slot s to run once more, ahead of its schedule, from the executive task once the slot in progress returns.
+         Any task or interrupt, never runs the slot in the caller */
+    inline void request_run(unsigned int s)
+    {
+      requested_slots.fetch_or(1UL << s, std::memory_order_release);
+    }
+
+    /* Copies executive and per slot stats, in schedule order */
+    void get_stats(sl_cr_cyclic_executive_stats_s *executive_stats, sl_cr_cyclic_executive_slot_stats_s (&slots)[slot_count]) const
+    {
+      critical_section_enter();
+      *executive_stats = stats;
+      for(unsigned int s = 0; s < slot_count; s++)
+      {
+        slots[s] = slot_stats[s];
+      }
+      critical_section_exit();
+    }
+
+    inline unsigned int get_major_frame() const {return major_frame;}
+};
+
+#endif /* __SL_CR_CYCLIC_EXECUTIVE_HPP__ */
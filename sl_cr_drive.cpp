@@ -6,140 +6,119 @@
 */
 
 #include <Arduino.h>
+#include <utility>
 
+#include "sl_cr_blackbox.hpp"
 #include "sl_cr_config.h"
 #include "sl_cr_drive.hpp"
 
-#ifdef _VIRTUAL_MOTORS_
-#include "sl_robot_motor_driver_virtual.hpp"
-#else
-#include "sl_robot_motor_driver_drv8256p.hpp"
-#endif
 #include "sl_cr_failsafe.hpp"
+#include "sl_cr_latency.hpp"
+#include "sl_cr_telemetry.hpp"
 #include "sl_robot_utils.hpp"
 
 using namespace sandor_laboratories::robot;
 
-const pid_loop_params_s pid_params = 
-{
-  .p_num = 50,
-  .p_den = 100,
-  .i_num = 25,
-  .i_den = 100,
-  .d_num = 12,
-  .d_den = 100,
-};
-
-const pwm_config_s pwm_config
-{
-  .frequency  = SL_CR_DEFAULT_PWM_FREQ,
-  .resolution = SL_CR_PWM_RESOLUTION,
-  .max_value  = SL_CR_PWM_MAX_VALUE
-};
-
-const pin_t right_motor_in1_pin   = SL_CR_PIN_DRIVE_MOTOR_1_IN1;
-const pin_t right_motor_in2_pin   = SL_CR_PIN_DRIVE_MOTOR_1_IN2;
-const pin_t right_motor_sleep_pin = SL_CR_PIN_DRIVE_MOTOR_1_SLEEP;
-const pin_t right_encoder_a_pin   = SL_CR_PIN_DRIVE_ENCODER_1_A;
-const pin_t right_encoder_b_pin   = SL_CR_PIN_DRIVE_ENCODER_1_B;
-const pin_t left_motor_in1_pin    = SL_CR_PIN_DRIVE_MOTOR_2_IN1;
-const pin_t left_motor_in2_pin    = SL_CR_PIN_DRIVE_MOTOR_2_IN2;
-const pin_t left_motor_sleep_pin  = SL_CR_PIN_DRIVE_MOTOR_2_SLEEP;
-const pin_t left_encoder_a_pin    = SL_CR_PIN_DRIVE_ENCODER_2_A;
-const pin_t left_encoder_b_pin    = SL_CR_PIN_DRIVE_ENCODER_2_B;
+/* Strategy while switch channel is low (or invalid at boot), switch channel high selects alternate */
+#define SL_CR_DRIVE_DEFAULT_STRATEGY   sl_cr_robot_t::default_drive_strategy
+#define SL_CR_DRIVE_ALTERNATE_STRATEGY \
+  ((SL_CR_DRIVE_STRATEGY_ARCADE == SL_CR_DRIVE_DEFAULT_STRATEGY)?SL_CR_DRIVE_STRATEGY_TANK:SL_CR_DRIVE_STRATEGY_ARCADE)
 
 /* Drive Data */
 sl_cr_drive_data_s drive_data = {0};
 
-/* Encoder interrupts */
-void interrupt_left_encoder_a()
-{
-  if(drive_data.left_motor_stack.encoder)
-  {
-    critical_section_enter_interrupt();
-    drive_data.left_motor_stack.encoder->sample_channel_a();
-    critical_section_exit_interrupt();
-  }
-}
-void interrupt_left_encoder_b()
+/* Static storage for all drive objects, nothing in the drive subsystem is heap allocated */
+sl_cr_drive_motor_stack_storage_s           drive_motor_stack_storage[SL_CR_DRIVE_MOTOR_COUNT];
+sl_cr_static_slot_c<sl_cr_drive_strategy_c> drive_strategy_storage[SL_CR_DRIVE_STRATEGY_COUNT];
+
+/* Total statically allocated drive subsystem RAM (bytes) */
+#define SL_CR_DRIVE_STATIC_RAM_SIZE (sizeof(drive_data) + sizeof(drive_motor_stack_storage) + sizeof(drive_strategy_storage))
+
+/* Fast control loop timing, only written by fast control loop */
+sl_cr_drive_fast_loop_stats_s fast_loop_stats = {0};
+#ifdef _FAST_CONTROL_LOOP_
+uint32_t                      fast_loop_last_cycles = 0;
+IntervalTimer                 fast_loop_timer;
+#endif
+
+/* Encoders by motor, nullptr if motor has none.  Read by edge interrupts */
+sl_cr_robot_t::encoder_t *drive_encoder[SL_CR_DRIVE_MOTOR_COUNT] = {nullptr};
+
+/* Encoder edge interrupt, one per motor for both channels */
+template <unsigned int motor>
+void sl_cr_drive_encoder_isr()
 {
-  if(drive_data.left_motor_stack.encoder)
+  sl_cr_robot_t::encoder_t * const encoder = drive_encoder[motor];
+  if(encoder)
   {
-    critical_section_enter_interrupt();
-    drive_data.left_motor_stack.encoder->sample_channel_b();
-    critical_section_exit_interrupt();
+    encoder->sample();
   }
 }
-void interrupt_right_encoder_a()
+
+typedef void (*sl_cr_drive_isr_f)();
+typedef struct
 {
-  if(drive_data.right_motor_stack.encoder)
-  {
-    critical_section_enter_interrupt();
-    drive_data.right_motor_stack.encoder->sample_channel_a();
-    critical_section_exit_interrupt();
-  }
-}
-void interrupt_right_encoder_b()
+  sl_cr_drive_isr_f encoder[SL_CR_DRIVE_MOTOR_COUNT];
+} sl_cr_drive_isr_table_s;
+
+template <unsigned int... motors>
+constexpr sl_cr_drive_isr_table_s sl_cr_drive_build_isr_table(std::integer_sequence<unsigned int, motors...>)
 {
-  if(drive_data.right_motor_stack.encoder)
-  {
-    critical_section_enter_interrupt();
-    drive_data.right_motor_stack.encoder->sample_channel_b();
-    critical_section_exit_interrupt();
-  }
+  return {{sl_cr_drive_encoder_isr<motors>...}};
 }
 
+/* Encoder interrupt table, indexed by motor */
+constexpr sl_cr_drive_isr_table_s drive_isr_table =
+  sl_cr_drive_build_isr_table(std::make_integer_sequence<unsigned int, SL_CR_DRIVE_MOTOR_COUNT>());
+
 void sl_cr_drive_init_motor_stacks()
 {
   motor_driver_config_s drive_motor_config;
-  motor_driver_c::init_config(&drive_motor_config);
+  sl_cr_robot_t::motor_driver_t::init_config(&drive_motor_config);
   drive_motor_config.failsafe = combat::failsafe_check;
   drive_motor_config.min_rpm  = SL_CR_MOTOR_DRIVER_REAL_MIN_RPM;
   drive_motor_config.max_rpm  = SL_CR_MOTOR_DRIVER_REAL_MAX_RPM;
 
-#ifdef _VIRTUAL_MOTORS_
-  drive_motor_config.min_commanded_rpm = -100;
-  drive_motor_config.max_commanded_rpm =  100;
-  drive_motor_config.log_key      = LOG_KEY_MOTOR_DRIVER_LEFT;
-  drive_data.left_motor_stack.driver = new sl_cr_motor_driver_virtual_c("Left Motor", drive_motor_config);
-  drive_motor_config.log_key      = LOG_KEY_MOTOR_DRIVER_RIGHT;
-  drive_data.right_motor_stack.driver = new sl_cr_motor_driver_virtual_c("Right Motor", drive_motor_config);
-#else
-  drive_motor_config.min_commanded_rpm = -SL_CR_PWM_MAX_VALUE;
-  drive_motor_config.max_commanded_rpm =  SL_CR_PWM_MAX_VALUE;
-
-  drive_data.left_motor_stack.control_loop = new pid_loop_c<rpm_t,rpm_t>
-  (
-    drive_motor_config.min_rpm, drive_motor_config.max_rpm, 
-    drive_motor_config.min_commanded_rpm, drive_motor_config.max_commanded_rpm,
-    pid_params, LOG_KEY_MOTOR_CONTROL_LOOP_LEFT
-  );
-  drive_data.right_motor_stack.control_loop = new pid_loop_c<rpm_t,rpm_t>
-  (
-    drive_motor_config.min_rpm, drive_motor_config.max_rpm, 
-    drive_motor_config.min_commanded_rpm, drive_motor_config.max_commanded_rpm,
-    pid_params, LOG_KEY_MOTOR_CONTROL_LOOP_RIGHT
-  );
-
-  /* Left Motor */
-  drive_data.left_motor_stack.encoder = new encoder_c(left_encoder_a_pin, left_encoder_b_pin,false,12,1,30);
-  drive_motor_config.log_key      = LOG_KEY_MOTOR_DRIVER_LEFT;
-  drive_motor_config.encoder      = drive_data.left_motor_stack.encoder;
-  drive_motor_config.control_loop = drive_data.left_motor_stack.control_loop;
-  drive_data.left_motor_stack.driver  = new motor_driver_drv8256p_c(left_motor_sleep_pin, left_motor_in1_pin, left_motor_in2_pin, pwm_config, drive_motor_config);
-
-  /* Right Motor */
-  drive_data.right_motor_stack.encoder = new encoder_c(right_encoder_a_pin, right_encoder_b_pin,true,12,1,30);
-  drive_motor_config.log_key      = LOG_KEY_MOTOR_DRIVER_RIGHT;
-  drive_motor_config.encoder      = drive_data.right_motor_stack.encoder;
-  drive_motor_config.control_loop = drive_data.right_motor_stack.control_loop;
-  drive_data.right_motor_stack.driver = new motor_driver_drv8256p_c(right_motor_sleep_pin, right_motor_in1_pin, right_motor_in2_pin, pwm_config, drive_motor_config);
-#endif
+  drive_motor_config.min_commanded_rpm = sl_cr_robot_t::min_commanded_rpm;
+  drive_motor_config.max_commanded_rpm = sl_cr_robot_t::max_commanded_rpm;
+
+  for(unsigned int m = 0; m < SL_CR_DRIVE_MOTOR_COUNT; m++)
+  {
+    const sl_cr_robot_motor_s         &motor   = sl_cr_robot_t::motors[m];
+    sl_cr_drive_motor_stack_storage_s *storage = &drive_motor_stack_storage[m];
+
+    sl_cr_robot_t::encoder_t      *encoder      = sl_cr_robot_t::create_encoder(&storage->encoder, motor);
+    sl_cr_robot_t::control_loop_t *control_loop = sl_cr_robot_t::create_control_loop(&storage->control_loop, motor, drive_motor_config,
+                                                                                        SL_CR_DRIVE_PID_PERIOD_US);
+    /* Driver runs open loop, motor stack closes speed loop */
+    drive_motor_config.log_key      = motor.driver_log_key;
+    drive_motor_config.encoder      = nullptr;
+    drive_motor_config.control_loop = nullptr;
+    sl_cr_robot_t::motor_driver_t *driver       = sl_cr_robot_t::create_motor_driver(&storage->driver, motor, drive_motor_config);
+
+    drive_encoder[m]          = encoder;
+    drive_data.motor_stack[m] = storage->motor_stack.construct(driver, encoder, control_loop, drive_motor_config.failsafe);
 
-  #ifdef _FORCE_LIMP_MODE_
-  drive_data.left_motor_stack.driver->set_limp_mode(true);
-  drive_data.right_motor_stack.driver->set_limp_mode(true);
-  #endif
+    #ifdef _FORCE_LIMP_MODE_
+    drive_data.motor_stack[m]->set_limp_mode(true);
+    #endif
+  }
+}
+
+/* Expands a left/right mixing matrix to every motor by side */
+void sl_cr_drive_build_matrix
+(
+  const sl_cr_mixer_matrix_t<SL_CR_DRIVE_STRATEGY_INPUTS,SL_CR_ROBOT_SIDE_COUNT> &side_matrix,
+  sl_cr_mixer_matrix_t<SL_CR_DRIVE_STRATEGY_INPUTS,SL_CR_DRIVE_STRATEGY_OUTPUTS> &matrix
+)
+{
+  for(unsigned int m = 0; m < SL_CR_DRIVE_STRATEGY_OUTPUTS; m++)
+  {
+    for(unsigned int i = 0; i < SL_CR_DRIVE_STRATEGY_INPUTS; i++)
+    {
+      matrix[m][i] = side_matrix[sl_cr_robot_t::motors[m].side][i];
+    }
+  }
 }
 
 const sl_cr_drive_data_s *sl_cr_drive_init()
@@ -147,53 +126,165 @@ const sl_cr_drive_data_s *sl_cr_drive_init()
   /* Init Motor Stacks */
   sl_cr_drive_init_motor_stacks();
 
-  /* Init Drive Strategy */
-#ifdef _ARCADE_DRIVE_
-  drive_data.arcade_drive = new sl_cr_arcade_drive_c(drive_data.left_motor_stack.driver, drive_data.right_motor_stack.driver, SL_CR_ARCADE_DRIVE_THROTTLE_CH, SL_CR_ARCADE_DRIVE_STEERING_CH);
-#else
-  drive_data.tank_drive = new sl_cr_tank_drive_c(drive_data.left_motor_stack.driver, drive_data.right_motor_stack.driver, SL_CR_TANK_DRIVE_LEFT_CH, SL_CR_TANK_DRIVE_RIGHT_CH);
-#endif
+  /* Init Drive Strategies */
+  sl_cr_drive_motor_stack_c *drive_motors[SL_CR_DRIVE_STRATEGY_OUTPUTS];
+  for(unsigned int m = 0; m < SL_CR_DRIVE_STRATEGY_OUTPUTS; m++)
+  {
+    drive_motors[m] = drive_data.motor_stack[m];
+  }
+  sl_cr_mixer_matrix_t<SL_CR_DRIVE_STRATEGY_INPUTS,SL_CR_DRIVE_STRATEGY_OUTPUTS> matrix;
+
+  const sl_cr_rc_channel_t arcade_channels[SL_CR_DRIVE_STRATEGY_INPUTS] = {SL_CR_ARCADE_DRIVE_THROTTLE_CH, SL_CR_ARCADE_DRIVE_STEERING_CH};
+  sl_cr_drive_build_matrix(sl_cr_mixer_arcade, matrix);
+  drive_data.drive_strategy[SL_CR_DRIVE_STRATEGY_ARCADE] =
+    drive_strategy_storage[SL_CR_DRIVE_STRATEGY_ARCADE].construct(drive_motors, arcade_channels, matrix, false);
+
+  const sl_cr_rc_channel_t tank_channels[SL_CR_DRIVE_STRATEGY_INPUTS]   = {SL_CR_TANK_DRIVE_LEFT_CH, SL_CR_TANK_DRIVE_RIGHT_CH};
+  sl_cr_drive_build_matrix(sl_cr_mixer_tank, matrix);
+  drive_data.drive_strategy[SL_CR_DRIVE_STRATEGY_TANK] =
+    drive_strategy_storage[SL_CR_DRIVE_STRATEGY_TANK].construct(drive_motors, tank_channels, matrix, true);
+
+  drive_data.active_drive_strategy = SL_CR_DRIVE_DEFAULT_STRATEGY;
+  drive_data.drive_strategy[drive_data.active_drive_strategy]->activate();
+
+  log_snprintf(LOG_KEY_BOOT, LOG_LEVEL_INFO, "Drive static RAM: %u bytes (motor stacks: %u, strategies: %u).",
+    (unsigned int) SL_CR_DRIVE_STATIC_RAM_SIZE, (unsigned int) sizeof(drive_motor_stack_storage), (unsigned int) sizeof(drive_strategy_storage));
 
   return &drive_data;
 }
 
 void sl_cr_drive_register_interrupts()
 {
-  if(drive_data.left_motor_stack.encoder)
+  for(unsigned int m = 0; m < SL_CR_DRIVE_MOTOR_COUNT; m++)
   {
-    attachInterrupt(left_encoder_a_pin, interrupt_left_encoder_a, arduino::CHANGE);
-    attachInterrupt(left_encoder_b_pin, interrupt_left_encoder_b, arduino::CHANGE);
+    if(drive_encoder[m])
+    {
+      attachInterrupt(sl_cr_robot_t::motors[m].encoder_a_pin, drive_isr_table.encoder[m], arduino::CHANGE);
+      attachInterrupt(sl_cr_robot_t::motors[m].encoder_b_pin, drive_isr_table.encoder[m], arduino::CHANGE);
+    }
   }
 
-  if(drive_data.right_motor_stack.encoder)
+#ifdef _FAST_CONTROL_LOOP_
+  fast_loop_timer.priority(SL_CR_FAST_CONTROL_LOOP_PRIORITY);
+  fast_loop_timer.begin(sl_cr_drive_fast_loop_isr, SL_CR_FAST_CONTROL_LOOP_PERIOD_US);
+#endif
+}
+
+/* Motor drivers have just run, by whichever loop owns them */
+void sl_cr_drive_complete_latencies()
+{
+  /* Outputs now reflect latest RC frame applied by drive strategy */
+  sl_cr_latency_complete(SL_CR_LATENCY_STICK_TO_OUTPUT);
+  if(combat::get_failsafe_set())
   {
-    attachInterrupt(right_encoder_a_pin, interrupt_right_encoder_a, arduino::CHANGE);
-    attachInterrupt(right_encoder_b_pin, interrupt_right_encoder_b, arduino::CHANGE);
+    /* Motor drivers have seen failsafe and are off */
+    sl_cr_latency_complete(SL_CR_LATENCY_DISARM_TO_OFF);
+    sl_cr_latency_complete(SL_CR_LATENCY_FAILSAFE_TO_OFF);
   }
 }
 
-void sl_cr_drive_motor_stack_control_loop(sl_cr_drive_motor_stack_s *motor_stack)
+#ifdef _FAST_CONTROL_LOOP_
+void sl_cr_drive_fast_loop_isr()
 {
-  if(motor_stack->encoder)
+  const uint32_t start = ARM_DWT_CYCCNT;
+
+  for(unsigned int m = 0; m < SL_CR_DRIVE_MOTOR_COUNT; m++)
+  {
+    drive_data.motor_stack[m]->loop();
+  }
+  sl_cr_drive_complete_latencies();
+
+  if(fast_loop_stats.count > 0)
   {
-    motor_stack->encoder->loop();
+    /* Deviation of this tick from one period after the last */
+    const uint32_t period   = (F_CPU_ACTUAL / 1000000) * SL_CR_FAST_CONTROL_LOOP_PERIOD_US;
+    const uint32_t interval = start - fast_loop_last_cycles;
+    const uint32_t jitter   = (interval > period)?(interval - period):(period - interval);
+    fast_loop_stats.jitter_max = (jitter > fast_loop_stats.jitter_max)?jitter:fast_loop_stats.jitter_max;
   }
-  motor_stack->driver->loop();
+  fast_loop_last_cycles = start;
+
+  const uint32_t execution = ARM_DWT_CYCCNT - start;
+  fast_loop_stats.count++;
+  fast_loop_stats.execution_last = execution;
+  fast_loop_stats.execution_max  = (execution > fast_loop_stats.execution_max)?execution:fast_loop_stats.execution_max;
 }
+#endif
 
 void sl_cr_drive_control_loop()
 {
-  sl_cr_drive_motor_stack_control_loop(&drive_data.left_motor_stack);
-  sl_cr_drive_motor_stack_control_loop(&drive_data.right_motor_stack);
+  sl_cr_drive_motor_state_s * const state = &drive_data.motor_state;
+
+  for(unsigned int m = 0; m < SL_CR_DRIVE_MOTOR_COUNT; m++)
+  {
+    sl_cr_drive_motor_stack_c * const motor_stack = drive_data.motor_stack[m];
+
+#ifndef _FAST_CONTROL_LOOP_
+    motor_stack->loop();
+#endif
+
+    state->set_rpm[m]       = motor_stack->get_set_rpm();
+    state->commanded_rpm[m] = motor_stack->get_commanded_rpm();
+    state->real_rpm[m]      = motor_stack->get_real_rpm();
+  }
+
+#ifndef _FAST_CONTROL_LOOP_
+  sl_cr_drive_complete_latencies();
+#endif
+
+#ifdef _TELEMETRY_
+  sl_cr_telemetry_sample(&drive_data);
+#endif
+#ifdef _BLACKBOX_
+  sl_cr_blackbox_record_drive(state);
+#endif
+}
+
+/* Strategy requested by switch channel of frame, current strategy if switch is invalid */
+sl_cr_drive_strategy_e sl_cr_drive_get_requested_strategy(const sl_cr_sbus_frame_s *frame)
+{
+  sl_cr_drive_strategy_e ret_val = drive_data.active_drive_strategy;
+
+  const sl_cr_rc_channel_value_t switch_raw = sl_cr_sbus_get_frame_ch_value(frame, SL_CR_DRIVE_STRATEGY_SWITCH_CH);
+  if(SL_CR_RC_CH_VALUE_VALID(switch_raw))
+  {
+    ret_val = (switch_raw > SL_CR_RC_CH_CENTER_VALUE)?SL_CR_DRIVE_ALTERNATE_STRATEGY:SL_CR_DRIVE_DEFAULT_STRATEGY;
+  }
+
+  return ret_val;
+}
+
+bool sl_cr_drive_strategy_loop()
+{
+  sl_cr_sbus_frame_s frame;
+
+  /* One snapshot per tick, so the strategy switch and drive inputs always come from the same frame */
+  sl_cr_sbus_get_frame(&frame);
+
+  const sl_cr_drive_strategy_e requested_strategy = sl_cr_drive_get_requested_strategy(&frame);
+
+  if(requested_strategy != drive_data.active_drive_strategy)
+  {
+    /* Switch within this tick, old strategy stops motors and new strategy holds them until its inputs are neutral */
+    drive_data.drive_strategy[drive_data.active_drive_strategy]->deactivate();
+    drive_data.drive_strategy[requested_strategy]->activate();
+    drive_data.active_drive_strategy = requested_strategy;
+  }
+
+  sl_cr_drive_strategy_c * const drive_strategy = drive_data.drive_strategy[drive_data.active_drive_strategy];
+  const bool frame_applied = drive_strategy->loop(&frame);
+
+  if(frame_applied)
+  {
+    sl_cr_latency_start(SL_CR_LATENCY_STICK_TO_OUTPUT, drive_strategy->get_last_frame_rx_time());
+  }
+
+  return frame_applied;
 }
 
-void sl_cr_drive_strategy_loop()
+void sl_cr_drive_get_fast_loop_stats(sl_cr_drive_fast_loop_stats_s *stats)
 {
-  #ifdef _ARCADE_DRIVE_
-    /* Arcade Drive loop */
-    drive_data.arcade_drive->loop();
-  #else
-    /* Tank Drive loop */
-    drive_data.tank_drive->loop();
-  #endif
-}
\ No newline at end of file
+  critical_section_enter();
+  *stats = fast_loop_stats;
+  critical_section_exit();
+}
@@ -8,55 +8,115 @@
 #ifndef __SL_CR_DRIVE_HPP__
 #define __SL_CR_DRIVE_HPP__
 
-#ifdef _ARCADE_DRIVE_
-#include "sl_cr_arcade_drive.hpp"
-#else
-#include "sl_cr_tank_drive.hpp"
+#include "sl_cr_mixer_drive.hpp"
+#include "sl_cr_motor_stack.hpp"
+#include "sl_cr_robot.hpp"
+#ifdef _CYCLIC_EXECUTIVE_
+#include "sl_cr_cyclic_executive.hpp"
 #endif
-#include "sl_robot_encoder.hpp"
-#include "sl_robot_motor_driver.hpp"
-#include "sl_robot_pid_loop.hpp"
 
 /* Loop Task periods in ms */
 #define SL_CR_CONTROL_LOOP_PERIOD 10
+/* Drive strategy normally runs at detected SBUS frame rate, this is the fallback period when pipelined */
 #define SL_CR_DRIVE_PERIOD 10
 
+#ifdef _FAST_CONTROL_LOOP_
+/* Fast control loop rate (Hz) and timer interrupt priority, below encoder edge interrupts so edges are never delayed */
+#define SL_CR_FAST_CONTROL_LOOP_RATE      4000
+#define SL_CR_FAST_CONTROL_LOOP_PRIORITY  144
+#define SL_CR_FAST_CONTROL_LOOP_PERIOD_US (1000000 / SL_CR_FAST_CONTROL_LOOP_RATE)
+static_assert((SL_CR_FAST_CONTROL_LOOP_RATE >= 2000) && (SL_CR_FAST_CONTROL_LOOP_RATE <= 5000), "Fast control loop rate must be 2-5kHz");
+#endif
+
+/* Period (us) of whichever loop runs the speed control loop, control loop gains are rescaled to it */
+#if defined(_FAST_CONTROL_LOOP_)
+#define SL_CR_DRIVE_PID_PERIOD_US SL_CR_FAST_CONTROL_LOOP_PERIOD_US
+#elif defined(_CYCLIC_EXECUTIVE_)
+/* Control loop slot runs every minor frame */
+#define SL_CR_DRIVE_PID_PERIOD_US (SL_CR_CYCLIC_EXECUTIVE_MINOR_FRAME * 1000)
+#else
+#define SL_CR_DRIVE_PID_PERIOD_US (SL_CR_CONTROL_LOOP_PERIOD * 1000)
+#endif
+
 #define SL_CR_MOTOR_DRIVER_REAL_MAX_RPM 1000
 #define SL_CR_MOTOR_DRIVER_REAL_MIN_RPM (-SL_CR_MOTOR_DRIVER_REAL_MAX_RPM)
 
+/* Number of motor stacks */
+#define SL_CR_DRIVE_MOTOR_COUNT sl_cr_robot_t::motor_count
+
+/* Motor, encoder and speed control of one drive motor.  The fast control loop timer owns the motor drivers when running */
+#ifdef _FAST_CONTROL_LOOP_
+typedef sl_cr_motor_stack_c<sl_cr_robot_t, true> sl_cr_drive_motor_stack_c;
+#else
+typedef sl_cr_motor_stack_c<sl_cr_robot_t> sl_cr_drive_motor_stack_c;
+#endif
+
+/* Drive strategy mixes two RC channels onto every motor, by side */
+#define SL_CR_DRIVE_STRATEGY_INPUTS  2
+#define SL_CR_DRIVE_STRATEGY_OUTPUTS SL_CR_DRIVE_MOTOR_COUNT
+typedef sl_cr_mixer_drive_c<SL_CR_DRIVE_STRATEGY_INPUTS,SL_CR_DRIVE_STRATEGY_OUTPUTS,sl_cr_drive_motor_stack_c> sl_cr_drive_strategy_c;
+
+/* Static storage for motor stack layers */
 typedef struct
 {
-  sandor_laboratories::robot::motor_driver_c                              *driver;
-  sandor_laboratories::robot::encoder_c                                   *encoder;
-  sandor_laboratories::robot::control_loop_c
-    <sandor_laboratories::robot::rpm_t,sandor_laboratories::robot::rpm_t> *control_loop;
-} sl_cr_drive_motor_stack_s;
+  sl_cr_static_slot_c<sl_cr_robot_t::motor_driver_t> driver;
+  sl_cr_static_slot_c<sl_cr_robot_t::encoder_t>      encoder;
+  sl_cr_static_slot_c<sl_cr_robot_t::control_loop_t> control_loop;
+  sl_cr_static_slot_c<sl_cr_drive_motor_stack_c>     motor_stack;
+} sl_cr_drive_motor_stack_storage_s;
+
+/* Motor state snapshot, one array per value so the control loop writes each sequentially */
+typedef struct
+{
+  sandor_laboratories::robot::rpm_t set_rpm[SL_CR_DRIVE_MOTOR_COUNT];
+  sandor_laboratories::robot::rpm_t commanded_rpm[SL_CR_DRIVE_MOTOR_COUNT];
+  sandor_laboratories::robot::rpm_t real_rpm[SL_CR_DRIVE_MOTOR_COUNT];
+} sl_cr_drive_motor_state_s;
 
 typedef struct 
 {
-  /* Physical Motor Stacks */
-  sl_cr_drive_motor_stack_s left_motor_stack;
-  sl_cr_drive_motor_stack_s right_motor_stack;
+  /* Physical Motor Stacks, in robot descriptor order */
+  sl_cr_drive_motor_stack_c *motor_stack[SL_CR_DRIVE_MOTOR_COUNT];
+  /* Motor state as of last control loop */
+  sl_cr_drive_motor_state_s motor_state;
 
-  /* Drive Strategy */
-  #ifdef _ARCADE_DRIVE_
-  sl_cr_arcade_drive_c *arcade_drive;
-  #else
-  sl_cr_tank_drive_c *tank_drive;
-  #endif
+  /* Drive Strategies, statically allocated and indexed by sl_cr_drive_strategy_e */
+  sl_cr_drive_strategy_c *drive_strategy[SL_CR_DRIVE_STRATEGY_COUNT];
+  /* Strategy currently in control of motors */
+  sl_cr_drive_strategy_e  active_drive_strategy;
 
 } sl_cr_drive_data_s;
 
+/* Fast control loop timing, in CPU cycles */
+typedef struct
+{
+  /* Number of timer ticks */
+  unsigned int count;
+  /* Worst-case deviation of tick interval from period */
+  uint32_t     jitter_max;
+  /* Latest and worst-case execution time */
+  uint32_t     execution_last;
+  uint32_t     execution_max;
+} sl_cr_drive_fast_loop_stats_s;
+
 /* Initializes data for drive data */
 const sl_cr_drive_data_s *sl_cr_drive_init();
 
-/* Registers required drive interrupts */
+/* Registers required drive interrupts, and starts fast control loop timer when enabled */
 void sl_cr_drive_register_interrupts();
 
-/* Loop to manage physical control loops */
+#ifdef _FAST_CONTROL_LOOP_
+/* Fast control loop tick, encoder, PID and motor driver of every motor.  Called by hardware timer, or by any periodic stand-in */
+void sl_cr_drive_fast_loop_isr();
+#endif
+
+/* Loop to manage physical control loops.  With the fast control loop, only samples motor state */
 void sl_cr_drive_control_loop();
 
-/* Loop to manage higher level drive strategy */
-void sl_cr_drive_strategy_loop();
+/* Loop to manage higher level drive strategy.  Returns true if a new RC frame was applied */
+bool sl_cr_drive_strategy_loop();
+
+/* Copies fast control loop timing, all zero unless fast control loop is running */
+void sl_cr_drive_get_fast_loop_stats(sl_cr_drive_fast_loop_stats_s *stats);
 
 #endif /* __SL_CR_DRIVE_HPP__ */
\ No newline at end of file
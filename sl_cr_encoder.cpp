@@ -0,0 +1,141 @@
+/*
+  sl_cr_encoder.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#include "sl_cr_encoder.hpp"
+
+using namespace sandor_laboratories::robot;
+
+/* Seconds per minute */
+#define SL_CR_ENCODER_S_PER_MINUTE 60LL
+
+sl_cr_encoder_c::sl_cr_encoder_c(pin_t a_pin, pin_t b_pin, bool reverse, unsigned int cpr, unsigned int gear_num, unsigned int gear_den,
+                                 sl_cr_encoder_velocity_mode_e velocity_mode)
+  : count(0), invalid_transitions(0), edge_cycles(0),
+    velocity_mode(velocity_mode), reverse(reverse), revs_per_count_num(gear_num), revs_per_count_den(cpr*gear_den)
+{
+  pinMode(a_pin, arduino::INPUT);
+  pinMode(b_pin, arduino::INPUT);
+
+  a_register = portInputRegister(a_pin);
+  a_mask     = digitalPinToBitMask(a_pin);
+  b_register = portInputRegister(b_pin);
+  b_mask     = digitalPinToBitMask(b_pin);
+
+  state            = read_state();
+  last_count       = 0;
+  last_cycles      = ARM_DWT_CYCCNT;
+  last_edge_count  = 0;
+  last_edge_cycles = last_cycles;
+  stopped          = true;
+  edge_cycles.store(last_cycles, std::memory_order_relaxed);
+  rpm              = 0;
+}
+
+rpm_t sl_cr_encoder_c::counts_to_rpm(int32_t counts, uint32_t cycles) const
+{
+  rpm_t ret_val = 0;
+
+  if(cycles > 0)
+  {
+    ret_val = (rpm_t) ((counts * SL_CR_ENCODER_S_PER_MINUTE * F_CPU_ACTUAL * revs_per_count_num) /
+                       ((int64_t) cycles * revs_per_count_den));
+  }
+
+  return ret_val;
+}
+
+rpm_t sl_cr_encoder_c::edge_timing_rpm(int32_t current_count, uint32_t current_edge_cycles, uint32_t now, rpm_t count_rpm)
+{
+  rpm_t          ret_val;
+  const int32_t  edge_counts    = current_count - last_edge_count;
+  const uint32_t stopped_cycles = (F_CPU_ACTUAL / 1000) * SL_CR_ENCODER_STOPPED_TIMEOUT;
+
+  if(0 != edge_counts)
+  {
+    const uint32_t edge_interval = current_edge_cycles - last_edge_cycles;
+
+    if(!stopped && (edge_interval < stopped_cycles))
+    {
+      /* Counts over exact time between first and last edge */
+      ret_val = counts_to_rpm(edge_counts, edge_interval);
+    }
+    else
+    {
+      /* Starting from stop, previous edge is too old to time from (interval may have wrapped) */
+      ret_val = count_rpm;
+    }
+
+    stopped          = false;
+    last_edge_count  = current_count;
+    last_edge_cycles = current_edge_cycles;
+  }
+  else
+  {
+    const uint32_t since_edge = now - last_edge_cycles;
+
+    if(stopped || (since_edge >= stopped_cycles))
+    {
+      /* Latch, since_edge wraps back below the timeout if the motor stays stopped past the cycle counter period */
+      stopped = true;
+      ret_val = 0;
+    }
+    else
+    {
+      /* No edge yet, speed can be no more than one count since last edge */
+      const rpm_t bound    = counts_to_rpm(1, since_edge);
+      const rpm_t previous = reverse?-rpm:rpm;
+      ret_val = (previous > bound)?bound:((previous < -bound)?-bound:previous);
+    }
+  }
+
+  return ret_val;
+}
+
+void sl_cr_encoder_c::loop()
+{
+  const uint32_t now = ARM_DWT_CYCCNT;
+  int32_t        current_count;
+  uint32_t       current_edge_cycles;
+
+  /* Consistent count and timestamp of the same edge, retry if an edge interrupted reading */
+  do
+  {
+    current_count       = count.load(std::memory_order_acquire);
+    current_edge_cycles = edge_cycles.load(std::memory_order_acquire);
+  } while(current_count != count.load(std::memory_order_acquire));
+
+  const uint32_t elapsed = now - last_cycles;
+
+  if(elapsed > 0)
+  {
+    const int32_t delta     = current_count - last_count;
+    const rpm_t   count_rpm = counts_to_rpm(delta, elapsed);
+    rpm_t         speed     = count_rpm;
+
+    if(SL_CR_ENCODER_VELOCITY_EDGE_TIMING == velocity_mode)
+    {
+      const int32_t magnitude = (delta < 0)?-delta:delta;
+      const rpm_t   edge_rpm  = edge_timing_rpm(current_count, current_edge_cycles, now, count_rpm);
+
+      if(magnitude <= SL_CR_ENCODER_BLEND_MIN_COUNTS)
+      {
+        speed = edge_rpm;
+      }
+      else if(magnitude < SL_CR_ENCODER_BLEND_MAX_COUNTS)
+      {
+        /* Linear blend between estimates */
+        speed = (edge_rpm  * (SL_CR_ENCODER_BLEND_MAX_COUNTS - magnitude) +
+                 count_rpm * (magnitude - SL_CR_ENCODER_BLEND_MIN_COUNTS)) /
+                (SL_CR_ENCODER_BLEND_MAX_COUNTS - SL_CR_ENCODER_BLEND_MIN_COUNTS);
+      }
+    }
+
+    rpm         = reverse?-speed:speed;
+    last_count  = current_count;
+    last_cycles = now;
+  }
+}
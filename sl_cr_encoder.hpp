@@ -0,0 +1,125 @@
+/*
+  sl_cr_encoder.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_ENCODER_HPP__
+#define __SL_CR_ENCODER_HPP__
+
+#include <Arduino.h>
+#include <atomic>
+#include <stdint.h>
+
+#include "sl_cr_types.hpp"
+#include "sl_robot_types.hpp"
+
+/* Velocity estimation modes */
+typedef enum
+{
+  /* Counts accumulated over the control loop period.  Resolution is 1 count per period, coarse at low speed */
+  SL_CR_ENCODER_VELOCITY_COUNT,
+  /* Counts over the exact time between cycle counter timestamped edges, blending to count based at high speed */
+  SL_CR_ENCODER_VELOCITY_EDGE_TIMING,
+} sl_cr_encoder_velocity_mode_e;
+
+/* Counts per loop where edge timing starts blending into count based estimation, fully count based at max */
+#define SL_CR_ENCODER_BLEND_MIN_COUNTS 8
+#define SL_CR_ENCODER_BLEND_MAX_COUNTS 32
+/* Edge timing treats motor as stopped once no edge is seen for this long (ms), must be well below cycle counter wrap (~7s at 600MHz) */
+#define SL_CR_ENCODER_STOPPED_TIMEOUT  100
+
+/* Quadrature encoder with a lock-free interrupt path.
+     Edge interrupts only read both pins and accumulate the quadrature step into an atomic counter (no critical section, no virtual call).
+     Decoding stays in the interrupt, the table step costs less than latching pin state for the control loop to decode, which would need
+     a ring holding every edge of a control loop period (8kB per encoder at 200kHz and 10ms) and would lose position when it overflows.
+     Velocity is computed once per control loop, from the accumulated count or from edge timestamps (see sl_cr_encoder_velocity_mode_e). */
+class sl_cr_encoder_c
+{
+  private:
+    /* Pin input registers and masks, resolved once so the ISR avoids pin lookups */
+    volatile uint32_t *a_register;
+    uint32_t           a_mask;
+    volatile uint32_t *b_register;
+    uint32_t           b_mask;
+
+    /* Written only by edge interrupts */
+    uint8_t               state;
+    std::atomic<int32_t>  count;
+    std::atomic<uint32_t> invalid_transitions;
+    /* Cycle counter at last counted edge */
+    std::atomic<uint32_t> edge_cycles;
+
+    /* Written only by control loop */
+    int32_t                           last_count;
+    uint32_t                          last_cycles;
+    /* Last edge seen by control loop */
+    int32_t                           last_edge_count;
+    uint32_t                          last_edge_cycles;
+    /* No edge within SL_CR_ENCODER_STOPPED_TIMEOUT.  Latched until the next edge, as intervals to an old edge wrap with the cycle counter */
+    bool                              stopped;
+    sandor_laboratories::robot::rpm_t rpm;
+
+    const sl_cr_encoder_velocity_mode_e velocity_mode;
+    const bool                          reverse;
+    /* Output shaft revolutions per count, as a fraction */
+    const uint32_t                      revs_per_count_num;
+    const uint32_t                      revs_per_count_den;
+
+    inline uint8_t read_state() const
+    {
+      return ((((*a_register) & a_mask)?2:0) | (((*b_register) & b_mask)?1:0));
+    }
+
+    /* Output shaft speed for counts over cycle counter interval */
+    sandor_laboratories::robot::rpm_t counts_to_rpm(int32_t counts, uint32_t cycles) const;
+
+    /* Speed from edge timestamps, count_rpm is used when starting from stop */
+    sandor_laboratories::robot::rpm_t edge_timing_rpm(int32_t current_count, uint32_t current_edge_cycles, uint32_t now,
+                                                      sandor_laboratories::robot::rpm_t count_rpm);
+
+  public:
+    /* cpr is quadrature counts (all edges of both channels) per motor revolution, gear_num/gear_den is output/motor speed */
+    sl_cr_encoder_c(sandor_laboratories::robot::pin_t a_pin, sandor_laboratories::robot::pin_t b_pin, bool reverse,
+                    unsigned int cpr, unsigned int gear_num, unsigned int gear_den,
+                    sl_cr_encoder_velocity_mode_e velocity_mode = SL_CR_ENCODER_VELOCITY_COUNT);
+
+    /* Edge interrupt for either channel */
+    inline void sample()
+    {
+      /* Step for each {previous, current} state pair, 0 for no change or an invalid double transition */
+      static const int8_t step[16] = { 0, -1,  1,  0,
+                                       1,  0,  0, -1,
+                                      -1,  0,  0,  1,
+                                       0,  1, -1,  0 };
+      const uint32_t cycles     = ARM_DWT_CYCCNT;
+      const uint8_t  current    = read_state();
+      const uint8_t  transition = (state << 2) | current;
+
+      if(0 != step[transition])
+      {
+        /* Count first, timestamp second.  Reader checks count is unchanged around reading timestamp */
+        count.store(count.load(std::memory_order_relaxed) + step[transition], std::memory_order_release);
+        edge_cycles.store(cycles, std::memory_order_release);
+      }
+      else if(state != current)
+      {
+        /* Both channels changed, an edge was missed */
+        invalid_transitions.store(invalid_transitions.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      }
+      state = current;
+    }
+
+    /* Computes velocity from edges accumulated since last call.  Call from control loop at a fixed rate */
+    void loop();
+
+    /* Output shaft speed as of last loop() */
+    inline sandor_laboratories::robot::rpm_t get_rpm() const {return rpm;}
+    /* Accumulated position (counts) */
+    inline int32_t get_count() const {return count.load(std::memory_order_relaxed);}
+    /* Number of transitions where both channels changed between interrupts */
+    inline uint32_t get_invalid_transitions() const {return invalid_transitions.load(std::memory_order_relaxed);}
+};
+
+#endif /* __SL_CR_ENCODER_HPP__ */
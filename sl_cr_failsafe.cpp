@@ -6,11 +6,16 @@
 */
 
 #include <Arduino.h>
+#include <atomic>
 
+#include "sl_cr_binlog.hpp"
+#include "sl_cr_blackbox.hpp"
 #include "sl_cr_failsafe.hpp"
+#include "sl_cr_latency.hpp"
+#include "sl_cr_ring_buffer.hpp"
 #include "sl_robot_log.hpp"
-#include "sl_cr_sbus.hpp"
 #include "sl_robot_utils.hpp"
+#include "sl_cr_sbus.hpp"
 
 using namespace sandor_laboratories::robot;
 
@@ -25,9 +30,33 @@ void* failsafe_check_user_data_ptr = nullptr;
 
 /* Master failsafe mask. Each bit corresponds to a reason from failsafe_mask_t.  
    Motors are to be powered if and only if mask is 0x0.
-   Initialize with BOOT bit and ARM_SWITCH_DISARM bit such that nothing can activate until bootup is complete and the arm switch is cleared to avoid unexpected arming */
-volatile combat::failsafe_mask_t sl_cr_failsafe_mask = SL_CR_FAILSAFE_BIT(combat::FAILSAFE_BOOT) | SL_CR_FAILSAFE_BIT(combat::FAILSAFE_ARM_SWITCH_DISARM);
+   Initialize with BOOT bit and ARM_SWITCH_DISARM bit such that nothing can activate until bootup is complete and the arm switch is cleared to avoid unexpected arming.
+   Read lock-free.  Changed only inside a critical section, together with the rearm state and the transition log */
+std::atomic<combat::failsafe_mask_t> sl_cr_failsafe_mask(SL_CR_FAILSAFE_BIT(combat::FAILSAFE_BOOT) | SL_CR_FAILSAFE_BIT(combat::FAILSAFE_ARM_SWITCH_DISARM));
+static_assert(std::atomic<combat::failsafe_mask_t>::is_always_lock_free, "Failsafe mask must be lock-free");
+
+/* Mask transition, logged later by log task */
+typedef struct
+{
+  /* Time of transition (us) */
+  sl_cr_time_us_t         time;
+  combat::failsafe_mask_t old_mask;
+  combat::failsafe_mask_t new_mask;
+} sl_cr_failsafe_transition_s;
 
+/* Transitions awaiting logging.  Pushed only inside the mask critical section, so writers never race and entries are in mask order */
+#define SL_CR_FAILSAFE_TRANSITION_BUFFER_SIZE 32
+sl_cr_ring_buffer_c<sl_cr_failsafe_transition_s, SL_CR_FAILSAFE_TRANSITION_BUFFER_SIZE> failsafe_transitions;
+/* Dropped count as of last log, only used by log task */
+uint32_t failsafe_transitions_dropped_logged = 0;
+
+/* Failsafe entry hooks, registered before scheduler starts */
+combat::failsafe_hook_f failsafe_hooks[SL_CR_FAILSAFE_HOOK_COUNT] = {nullptr};
+
+/* Failsafe-to-off over budget count as of last log, only used by log task */
+unsigned int failsafe_to_off_over_budget_logged = 0;
+
+/* Rearm state, only accessed inside a critical section */
 /* Timeout timer reference time (last failsafe entry) to force rearming */
 time_t armswitch_rearm_timeout_start = 0; //millis() starts from 0 at bootup
 bool         rearm_timeout_expired = false;
@@ -35,45 +64,77 @@ bool         rearm_timeout_expired = false;
 unsigned int repeat_failsafe_rearm_counter = 0;
 bool         repeat_failsafe_rearm_required = false;
 
-void combat::set_failsafe_mask(failsafe_reason_e reason)
+/* Applies set or clear of a reason bit, returns mask before change.
+     A change updates the mask, the rearm state on failsafe entry and the transition log in one critical section, then runs the
+     failsafe entry hooks outside it.  No change takes no lock */
+combat::failsafe_mask_t sl_cr_failsafe_update(combat::failsafe_reason_e reason, bool set)
 {
-  critical_section_enter();
-  failsafe_mask_t old_failsafe_mask = sl_cr_failsafe_mask;
-  sl_cr_failsafe_mask |= SL_CR_FAILSAFE_BIT(reason);
-  failsafe_mask_t new_failsafe_mask = sl_cr_failsafe_mask;
-  critical_section_exit();
-  
-  if(0 == (old_failsafe_mask & SL_CR_FAILSAFE_BIT(reason)))
+  combat::failsafe_mask_t old_mask = sl_cr_failsafe_mask.load(std::memory_order_acquire);
+  combat::failsafe_mask_t new_mask = set?(old_mask | SL_CR_FAILSAFE_BIT(reason)):(old_mask & ~SL_CR_FAILSAFE_BIT(reason));
+
+  if(new_mask != old_mask)
   {
-    log_snprintf(LOG_KEY_FAILSAFE, LOG_LEVEL_INFO, "New failsafe mask: 0x%x", new_failsafe_mask);
+    critical_section_enter();
+    old_mask = sl_cr_failsafe_mask.load(std::memory_order_relaxed);
+    new_mask = set?(old_mask | SL_CR_FAILSAFE_BIT(reason)):(old_mask & ~SL_CR_FAILSAFE_BIT(reason));
+    const sl_cr_time_us_t now = micros();
+    if(new_mask != old_mask)
+    {
+      sl_cr_failsafe_mask.store(new_mask, std::memory_order_release);
+      if(0 == old_mask)
+      {
+        /* Entered failsafe state, start rearm timer and count failsafe event */
+        armswitch_rearm_timeout_start = millis();
+        rearm_timeout_expired = false;
+        repeat_failsafe_rearm_counter++;
+      }
+      failsafe_transitions.push({now, old_mask, new_mask});
+#ifdef _BLACKBOX_
+      sl_cr_blackbox_record_failsafe(now, old_mask, new_mask);
+#endif
+    }
+    critical_section_exit();
 
-    if(0 == old_failsafe_mask)
+    if((0 == old_mask) && (0 != new_mask))
     {
-      log_cstring(LOG_KEY_FAILSAFE, LOG_LEVEL_INFO, "FAILSAFE SET!");
-      /* Entered failsafe state, start rearm timer */
-      armswitch_rearm_timeout_start = millis();
-      rearm_timeout_expired = false;
-      /* Count failsafe event */
-      repeat_failsafe_rearm_counter++;
+      /* Entered failsafe, push it to motor outputs now rather than at their next poll */
+      sl_cr_latency_start(SL_CR_LATENCY_FAILSAFE_TO_OFF, now);
+      for(unsigned int h = 0; h < SL_CR_FAILSAFE_HOOK_COUNT; h++)
+      {
+        if(failsafe_hooks[h])
+        {
+          failsafe_hooks[h]();
+        }
+      }
     }
   }
+
+  return old_mask;
 }
-void combat::clear_failsafe_mask(failsafe_reason_e reason)
+
+bool combat::register_failsafe_hook(failsafe_hook_f hook)
 {
-  critical_section_enter();
-  failsafe_mask_t old_failsafe_mask = sl_cr_failsafe_mask;
-  sl_cr_failsafe_mask &= ~(SL_CR_FAILSAFE_BIT(reason));
-  failsafe_mask_t new_failsafe_mask = sl_cr_failsafe_mask;
-  critical_section_exit();
-  
-  if(0 != (old_failsafe_mask & SL_CR_FAILSAFE_BIT(reason)))
+  bool ret_val = false;
+
+  for(unsigned int h = 0; (h < SL_CR_FAILSAFE_HOOK_COUNT) && !ret_val; h++)
   {
-    log_snprintf(LOG_KEY_FAILSAFE, LOG_LEVEL_INFO, "New failsafe mask: 0x%x", new_failsafe_mask);
-    if(0 == new_failsafe_mask)
+    if(nullptr == failsafe_hooks[h])
     {
-      log_cstring(LOG_KEY_FAILSAFE, LOG_LEVEL_INFO, "ARMED!");
+      failsafe_hooks[h] = hook;
+      ret_val = true;
     }
   }
+
+  return ret_val;
+}
+
+void combat::set_failsafe_mask(failsafe_reason_e reason)
+{
+  sl_cr_failsafe_update(reason, true);
+}
+void combat::clear_failsafe_mask(failsafe_reason_e reason)
+{
+  sl_cr_failsafe_update(reason, false);
 }
 void combat::set_failsafe_mask_value(failsafe_reason_e reason, bool value)
 {
@@ -88,13 +149,7 @@ void combat::set_failsafe_mask_value(failsafe_reason_e reason, bool value)
 }
 combat::failsafe_mask_t combat::get_failsafe_mask()
 {
-  failsafe_mask_t ret_val = SL_CR_FAILSAFE_INVALID_MASK;
-
-  critical_section_enter();
-  ret_val = sl_cr_failsafe_mask;
-  critical_section_exit();
-
-  return ret_val;
+  return sl_cr_failsafe_mask.load(std::memory_order_acquire);
 }
 bool combat::get_failsafe_set()
 {
@@ -114,12 +169,16 @@ bool prearmswitch_first = false;
 bool armswitches_released_first = false;
 void combat::failsafe_armswitch_loop()
 {
+  /* Both switches are read from the same RC frame */
+  sl_cr_sbus_frame_s frame;
+  sl_cr_sbus_get_frame(&frame);
+
   /* Check if arm switch is requsting robot to be armed */
-  const sl_cr_rc_channel_value_t armswitch_raw = sl_cr_sbus_get_ch_value(SL_CR_ARM_SWITCH_CH);
+  const sl_cr_rc_channel_value_t armswitch_raw = sl_cr_sbus_get_frame_ch_value(&frame, SL_CR_ARM_SWITCH_CH);
   const bool armswitch_armed = SL_CR_RC_CH_VALUE_VALID(armswitch_raw) && (armswitch_raw > SL_CR_ARM_SWITCH_THRESHOLD);
 
   /* Check prearm switch state */
-  const sl_cr_rc_channel_value_t prearmswitch_raw = sl_cr_sbus_get_ch_value(SL_CR_PREARM_SWITCH_CH);
+  const sl_cr_rc_channel_value_t prearmswitch_raw = sl_cr_sbus_get_frame_ch_value(&frame, SL_CR_PREARM_SWITCH_CH);
   const bool prearmswitch_armed = SL_CR_RC_CH_VALUE_VALID(prearmswitch_raw) && (prearmswitch_raw > SL_CR_ARM_SWITCH_THRESHOLD);
 
   if(armswitches_released_first && prearmswitch_first && prearmswitch_armed && armswitch_armed)
@@ -131,33 +190,51 @@ void combat::failsafe_armswitch_loop()
   }
   else if(!armswitch_armed)
   {
+    if(!get_failsafe_set())
+    {
+      /* Disarming from armed, trace this frame until motors are off */
+      sl_cr_latency_start(SL_CR_LATENCY_DISARM_TO_OFF, frame.rx_time);
+    }
     /* If arm switch is not requesting arming, set failsafe */
     set_failsafe_mask(FAILSAFE_ARM_SWITCH);
   }
 
+  /* Rearm state is shared with every failsafe writer, check and update it in one critical section */
+  critical_section_enter();
+  bool force_rearm = false;
   /* Check if failsafe timeout is exceeded and force rearm */
   if(!rearm_timeout_expired &&
      get_failsafe_set() && 
      ((millis()-armswitch_rearm_timeout_start) > SL_CR_FAILSAFE_ARMSWITCH_REARM_TIMEOUT))
   {
-    set_failsafe_mask(FAILSAFE_ARM_SWITCH_DISARM);
+    force_rearm = true;
     rearm_timeout_expired = true;
   }
   if(!repeat_failsafe_rearm_required &&
       get_failsafe_set() &&
       repeat_failsafe_rearm_counter > SL_CR_FAILSAFE_REPEAT_REARM_THRESHOLD)
   {
-    set_failsafe_mask(FAILSAFE_ARM_SWITCH_DISARM);
+    force_rearm = true;
     repeat_failsafe_rearm_required = true;
   }
   /* If armswitch not requesting arming, clear disarm wait */
-  if(SL_CR_RC_CH_VALUE_VALID(armswitch_raw) && !armswitch_armed)
+  const bool clear_rearm = SL_CR_RC_CH_VALUE_VALID(armswitch_raw) && !armswitch_armed;
+  if(clear_rearm)
   {
-    clear_failsafe_mask(FAILSAFE_ARM_SWITCH_DISARM);
     /* Reset repeat failsafe counter */
     repeat_failsafe_rearm_counter = 0;
     repeat_failsafe_rearm_required = false;
   }
+  critical_section_exit();
+
+  if(force_rearm)
+  {
+    set_failsafe_mask(FAILSAFE_ARM_SWITCH_DISARM);
+  }
+  if(clear_rearm)
+  {
+    clear_failsafe_mask(FAILSAFE_ARM_SWITCH_DISARM);
+  }
 
   /* Prearm is armed before arming switch is armed */
   prearmswitch_first = prearmswitch_armed && !armswitch_armed;
@@ -171,4 +248,38 @@ void combat::failsafe_armswitch_loop()
 bool combat::failsafe_check(const void*) 
 {
   return get_failsafe_set();
-};
\ No newline at end of file
+};
+
+void combat::failsafe_log_transitions()
+{
+  sl_cr_failsafe_transition_s transition;
+
+  while(failsafe_transitions.pop(&transition))
+  {
+    sl_cr_log_format<SL_CR_BINLOG_FMT_FAILSAFE_MASK>(LOG_KEY_FAILSAFE, LOG_LEVEL_INFO, transition.new_mask, transition.time);
+    if(0 == transition.old_mask)
+    {
+      sl_cr_log_format<SL_CR_BINLOG_FMT_FAILSAFE_SET>(LOG_KEY_FAILSAFE, LOG_LEVEL_INFO);
+    }
+    else if(0 == transition.new_mask)
+    {
+      sl_cr_log_format<SL_CR_BINLOG_FMT_FAILSAFE_ARMED>(LOG_KEY_FAILSAFE, LOG_LEVEL_INFO);
+    }
+  }
+
+  const uint32_t dropped = failsafe_transitions.get_dropped();
+  if(dropped != failsafe_transitions_dropped_logged)
+  {
+    sl_cr_log_format<SL_CR_BINLOG_FMT_FAILSAFE_DROPPED>(LOG_KEY_FAILSAFE, LOG_LEVEL_WARNING, dropped);
+    failsafe_transitions_dropped_logged = dropped;
+  }
+
+  sl_cr_latency_stats_s failsafe_to_off;
+  sl_cr_latency_get_stats(SL_CR_LATENCY_FAILSAFE_TO_OFF, &failsafe_to_off);
+  if(failsafe_to_off.over_budget != failsafe_to_off_over_budget_logged)
+  {
+    sl_cr_log_format<SL_CR_BINLOG_FMT_FAILSAFE_TO_OFF_BOUND>(LOG_KEY_FAILSAFE, LOG_LEVEL_ERROR,
+      failsafe_to_off.last, (sl_cr_time_us_t) SL_CR_LATENCY_FAILSAFE_TO_OFF_BUDGET);
+    failsafe_to_off_over_budget_logged = failsafe_to_off.over_budget;
+  }
+}
@@ -59,6 +59,16 @@ namespace sandor_laboratories
       #define SL_CR_FAILSAFE_REPEAT_REARM_THRESHOLD 5
       /* Arm switch maintenance, to be called every loop */
       void failsafe_armswitch_loop();
+
+      /* Called in the context of whichever task enters failsafe (mask going from 0 to non-zero), after the mask and rearm state are
+           updated and outside the failsafe critical section.  Must be short and must not block */
+      typedef void (*failsafe_hook_f)();
+      #define SL_CR_FAILSAFE_HOOK_COUNT 2
+      /* Registers hook for failsafe entry.  Call before scheduler starts.  Returns false if all hooks are in use */
+      bool register_failsafe_hook(failsafe_hook_f hook);
+
+      /* Logs failsafe mask transitions recorded since last call.  Mask changes never format or log inline, call from log task */
+      void failsafe_log_transitions();
     }
   }
 }
@@ -0,0 +1,98 @@
+/*
+  sl_cr_fixed_pid.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#include "sl_cr_fixed_pid.hpp"
+
+using namespace sandor_laboratories::robot;
+
+sl_cr_fixed_pid_c::sl_cr_fixed_pid_c(rpm_t min_set_point, rpm_t max_set_point, rpm_t min_output, rpm_t max_output,
+                                     pid_loop_params_s params, log_key_e log_key, uint32_t period_us)
+  : min_set_point(min_set_point), max_set_point(max_set_point),
+    min_output_q(((int64_t) min_output) << SL_CR_FIXED_PID_Q), max_output_q(((int64_t) max_output) << SL_CR_FIXED_PID_Q),
+    kp(gain_q(params.p_num, params.p_den)),
+    /* Integral accumulates per loop, scale by period.  Derivative differences per loop, scale by 1/period */
+    ki(gain_q((int64_t) params.i_num * period_us, (int64_t) params.i_den * SL_CR_FIXED_PID_TUNING_PERIOD)),
+    kd(gain_q((int64_t) params.d_num * SL_CR_FIXED_PID_TUNING_PERIOD, (int64_t) params.d_den * period_us)),
+    /* First order filter with the time constant the fixed step has at the tuning period */
+    d_alpha(gain_q(period_us, period_us + (int64_t) SL_CR_FIXED_PID_TUNING_PERIOD * ((1 << SL_CR_FIXED_PID_D_FILTER_SHIFT) - 1)))
+{
+  reset();
+
+  log_snprintf(log_key, LOG_LEVEL_DEBUG, "Fixed PID gains (Q%d) at %luus: P %ld, I %ld, D %ld, D filter %ld",
+    SL_CR_FIXED_PID_Q, (unsigned long) period_us, (long) kp, (long) ki, (long) kd, (long) d_alpha);
+}
+
+rpm_t sl_cr_fixed_pid_c::loop(rpm_t set_point, rpm_t measured)
+{
+  rpm_t ret_val;
+
+  if(set_point > max_set_point)
+  {
+    set_point = max_set_point;
+  }
+  else if(set_point < min_set_point)
+  {
+    set_point = min_set_point;
+  }
+
+  error = set_point - measured;
+
+  /* Derivative on measurement, filtered */
+  if(primed)
+  {
+    const int64_t raw_derivative = -kd * (measured - last_measured);
+    derivative += ((raw_derivative - derivative) * d_alpha) >> SL_CR_FIXED_PID_Q;
+  }
+  last_measured = measured;
+  primed        = true;
+
+  int64_t next_integral = integral + (ki * error);
+  if(next_integral > max_output_q)
+  {
+    next_integral = max_output_q;
+  }
+  else if(next_integral < min_output_q)
+  {
+    next_integral = min_output_q;
+  }
+
+  int64_t output = (kp * error) + next_integral + derivative;
+  if(output > max_output_q)
+  {
+    output = max_output_q;
+    /* Saturated, only integrate away from the limit */
+    if(error < 0)
+    {
+      integral = next_integral;
+    }
+  }
+  else if(output < min_output_q)
+  {
+    output = min_output_q;
+    if(error > 0)
+    {
+      integral = next_integral;
+    }
+  }
+  else
+  {
+    integral = next_integral;
+  }
+
+  ret_val = (rpm_t) (output >> SL_CR_FIXED_PID_Q);
+
+  return ret_val;
+}
+
+void sl_cr_fixed_pid_c::reset()
+{
+  integral      = 0;
+  derivative    = 0;
+  error         = 0;
+  last_measured = 0;
+  primed        = false;
+}
@@ -0,0 +1,71 @@
+/*
+  sl_cr_fixed_pid.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_FIXED_PID_HPP__
+#define __SL_CR_FIXED_PID_HPP__
+
+#include <stdint.h>
+
+#include "sl_robot_control_loop.hpp"
+#include "sl_robot_log.hpp"
+#include "sl_robot_pid_loop.hpp"
+#include "sl_robot_types.hpp"
+
+/* Fractional bits of gains and accumulated terms */
+#define SL_CR_FIXED_PID_Q 16
+/* Derivative low pass, at the tuning period each loop moves 1/2^shift of the way to the new derivative */
+#define SL_CR_FIXED_PID_D_FILTER_SHIFT 2
+/* Loop period (us) pid_loop_params_s gains are tuned at.  Gains are per loop, as for pid_loop_c in the 10ms control loop */
+#define SL_CR_FIXED_PID_TUNING_PERIOD  10000
+
+/* PID speed loop in Q16 fixed point.
+     Gains are converted from pid_loop_params_s num/den pairs once at construction, so each loop is multiplies and shifts only.
+     Integral and derivative gains and the derivative filter are rescaled from the tuning period to the actual loop period, so one
+     tuning behaves the same at any loop rate.
+     Integral is clamped to the output range and stops accumulating while the output saturates in the direction of the error.
+     Derivative acts on the measurement (no kick on set point steps) and is low pass filtered.
+     Constructor matches pid_loop_c so descriptors can use either. */
+class sl_cr_fixed_pid_c : public sandor_laboratories::robot::control_loop_c<sandor_laboratories::robot::rpm_t,sandor_laboratories::robot::rpm_t>
+{
+  private:
+    const sandor_laboratories::robot::rpm_t min_set_point;
+    const sandor_laboratories::robot::rpm_t max_set_point;
+    const int64_t                           min_output_q;
+    const int64_t                           max_output_q;
+
+    /* Gains, Q16 */
+    const int64_t kp;
+    const int64_t ki;
+    const int64_t kd;
+    /* Derivative filter step, Q16 */
+    const int64_t d_alpha;
+
+    /* Q16 */
+    int64_t integral;
+    int64_t derivative;
+
+    sandor_laboratories::robot::rpm_t error;
+    sandor_laboratories::robot::rpm_t last_measured;
+    /* False until a measurement is available for the derivative */
+    bool                              primed;
+
+    static inline int64_t gain_q(int64_t num, int64_t den) {return (0 != den)?((num << SL_CR_FIXED_PID_Q) / den):0;}
+
+  public:
+    sl_cr_fixed_pid_c(sandor_laboratories::robot::rpm_t min_set_point, sandor_laboratories::robot::rpm_t max_set_point,
+                      sandor_laboratories::robot::rpm_t min_output,    sandor_laboratories::robot::rpm_t max_output,
+                      sandor_laboratories::robot::pid_loop_params_s params, log_key_e log_key,
+                      uint32_t period_us = SL_CR_FIXED_PID_TUNING_PERIOD);
+
+    sandor_laboratories::robot::rpm_t loop(sandor_laboratories::robot::rpm_t set_point, sandor_laboratories::robot::rpm_t measured) override;
+
+    inline sandor_laboratories::robot::rpm_t get_error() const override {return error;}
+
+    void reset() override;
+};
+
+#endif /* __SL_CR_FIXED_PID_HPP__ */
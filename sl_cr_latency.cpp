@@ -0,0 +1,99 @@
+/*
+  sl_cr_latency.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#include <Arduino.h>
+#include <atomic>
+
+#include "sl_cr_latency.hpp"
+#include "sl_cr_seqlock.hpp"
+
+/* Tag value meaning no frame awaits output.  A frame received at exactly this time is tagged 1us early */
+#define SL_CR_LATENCY_NO_TAG UINT32_MAX
+
+typedef struct
+{
+  const char                           *name;
+  const sl_cr_time_us_t                 budget;
+  /* Receive time of tagged frame awaiting output, or SL_CR_LATENCY_NO_TAG.  Set by any task, taken by completing task */
+  std::atomic<sl_cr_time_us_t>          tag;
+  /* Written only by completing task (control loop), published for readers */
+  sl_cr_latency_stats_s                 stats;
+  sl_cr_seqlock_c<sl_cr_latency_stats_s> published;
+} sl_cr_latency_path_s;
+
+/* Lock-free, starting is a single store and completing a single exchange, so neither disables interrupts */
+sl_cr_latency_path_s latency_paths[SL_CR_LATENCY_COUNT] =
+{
+  {"Stick-to-output", SL_CR_LATENCY_STICK_TO_OUTPUT_BUDGET, {SL_CR_LATENCY_NO_TAG}, {}, {}},
+  {"Disarm-to-off",   SL_CR_LATENCY_DISARM_TO_OFF_BUDGET,   {SL_CR_LATENCY_NO_TAG}, {}, {}},
+  {"Failsafe-to-off", SL_CR_LATENCY_FAILSAFE_TO_OFF_BUDGET, {SL_CR_LATENCY_NO_TAG}, {}, {}},
+};
+static_assert(std::atomic<sl_cr_time_us_t>::is_always_lock_free, "Latency tag must be lock-free");
+
+void sl_cr_latency_start(sl_cr_latency_e path, sl_cr_time_us_t rx_time)
+{
+  latency_paths[path].tag.store((SL_CR_LATENCY_NO_TAG != rx_time)?rx_time:(rx_time-1), std::memory_order_relaxed);
+}
+
+void sl_cr_latency_complete(sl_cr_latency_e path)
+{
+  sl_cr_latency_path_s * const data = &latency_paths[path];
+
+  /* Cheap check first, only exchange when a tag is waiting */
+  if(SL_CR_LATENCY_NO_TAG != data->tag.load(std::memory_order_relaxed))
+  {
+    const sl_cr_time_us_t now     = micros();
+    const sl_cr_time_us_t rx_time = data->tag.exchange(SL_CR_LATENCY_NO_TAG, std::memory_order_relaxed);
+
+    if(SL_CR_LATENCY_NO_TAG != rx_time)
+    {
+      const sl_cr_time_us_t latency = now - rx_time;
+      unsigned int bin = latency / SL_CR_LATENCY_HISTOGRAM_BIN_WIDTH;
+      bin = (bin < SL_CR_LATENCY_HISTOGRAM_BINS)?bin:(SL_CR_LATENCY_HISTOGRAM_BINS-1);
+
+      data->stats.count++;
+      data->stats.last = latency;
+      data->stats.max  = (latency > data->stats.max)?latency:data->stats.max;
+      data->stats.over_budget += (latency > data->budget)?1:0;
+      data->stats.histogram[bin]++;
+      data->published.write(data->stats);
+    }
+  }
+}
+
+void sl_cr_latency_get_stats(sl_cr_latency_e path, sl_cr_latency_stats_s *stats)
+{
+  latency_paths[path].published.read(stats);
+}
+
+sl_cr_time_us_t sl_cr_latency_get_budget(sl_cr_latency_e path)
+{
+  return latency_paths[path].budget;
+}
+
+void sl_cr_latency_log_stats(log_key_e log_key)
+{
+  static_assert(16 == SL_CR_LATENCY_HISTOGRAM_BINS, "Histogram log format expects 16 bins");
+  sl_cr_latency_stats_s stats;
+
+  for(unsigned int p = 0; p < SL_CR_LATENCY_COUNT; p++)
+  {
+    sl_cr_latency_get_stats((sl_cr_latency_e) p, &stats);
+
+    log_snprintf(log_key, LOG_LEVEL_DEBUG,
+      "%s latency last: %uus max: %uus frames: %u over %uus budget: %u.",
+      latency_paths[p].name, (unsigned int) stats.last, (unsigned int) stats.max, stats.count, (unsigned int) latency_paths[p].budget,
+      stats.over_budget);
+    log_snprintf(log_key, LOG_LEVEL_DEBUG,
+      "%s latency histogram (%ums bins): %u %u %u %u %u %u %u %u %u %u %u %u %u %u %u %u",
+      latency_paths[p].name, SL_CR_LATENCY_HISTOGRAM_BIN_WIDTH/1000,
+      stats.histogram[0],  stats.histogram[1],  stats.histogram[2],  stats.histogram[3],
+      stats.histogram[4],  stats.histogram[5],  stats.histogram[6],  stats.histogram[7],
+      stats.histogram[8],  stats.histogram[9],  stats.histogram[10], stats.histogram[11],
+      stats.histogram[12], stats.histogram[13], stats.histogram[14], stats.histogram[15]);
+  }
+}
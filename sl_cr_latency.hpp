@@ -0,0 +1,62 @@
+/*
+  sl_cr_latency.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_LATENCY_HPP__
+#define __SL_CR_LATENCY_HPP__
+
+#include "sl_cr_types.hpp"
+#include "sl_robot_log.hpp"
+
+/* Traced paths from an RC frame's receipt to motor output */
+typedef enum
+{
+  /* Stick input applied by drive strategy until motor outputs are updated with it */
+  SL_CR_LATENCY_STICK_TO_OUTPUT,
+  /* Arm switch disarming until motors are off */
+  SL_CR_LATENCY_DISARM_TO_OFF,
+  /* Any failsafe entry until motors are off */
+  SL_CR_LATENCY_FAILSAFE_TO_OFF,
+  SL_CR_LATENCY_COUNT,
+} sl_cr_latency_e;
+
+/* Latency budgets (us), measurements above budget are counted */
+#define SL_CR_LATENCY_STICK_TO_OUTPUT_BUDGET 30000
+#define SL_CR_LATENCY_DISARM_TO_OFF_BUDGET   20000
+/* Failsafe entry immediately wakes control loop, bounded by its execution time rather than its period */
+#define SL_CR_LATENCY_FAILSAFE_TO_OFF_BUDGET 1000
+
+/* Latency histogram, last bin also counts all longer latencies */
+#define SL_CR_LATENCY_HISTOGRAM_BINS      16
+#define SL_CR_LATENCY_HISTOGRAM_BIN_WIDTH 2000 /* us */
+
+/* Measurements of one traced path since boot */
+typedef struct
+{
+  /* Number of frames measured */
+  unsigned int    count;
+  /* Latest and worst-case measured latency (us) */
+  sl_cr_time_us_t last;
+  sl_cr_time_us_t max;
+  /* Measurements above budget */
+  unsigned int    over_budget;
+  unsigned int    histogram[SL_CR_LATENCY_HISTOGRAM_BINS];
+} sl_cr_latency_stats_s;
+
+/* Tags path with receive time (us) of the RC frame that triggered it.  A newer frame replaces an incomplete tag.
+     A single atomic store, any task */
+void sl_cr_latency_start(sl_cr_latency_e path, sl_cr_time_us_t rx_time);
+/* Records latency of tagged frame, if any, as the path's output is now applied.  Lock-free, control loop only */
+void sl_cr_latency_complete(sl_cr_latency_e path);
+
+/* Copies measurements of a path */
+void sl_cr_latency_get_stats(sl_cr_latency_e path, sl_cr_latency_stats_s *stats);
+/* Returns latency budget of a path (us) */
+sl_cr_time_us_t sl_cr_latency_get_budget(sl_cr_latency_e path);
+/* Logs measurements of all paths.  Formatting happens in the caller's context */
+void sl_cr_latency_log_stats(log_key_e log_key);
+
+#endif /* __SL_CR_LATENCY_HPP__ */
@@ -0,0 +1,109 @@
+/*
+  sl_cr_mixer.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_MIXER_HPP__
+#define __SL_CR_MIXER_HPP__
+
+#include <stdint.h>
+
+#include "sl_cr_rc_map.hpp"
+
+/* Mixing coefficient of 1.0 (Q12, same scale as normalized RC commands) */
+#define SL_CR_MIXER_UNITY SL_CR_RC_NORM_MAX
+/* Fractional bits of saturation scale factor */
+#define SL_CR_MIXER_SCALE_SHIFT 15
+
+/* Mixing matrix, one row of input coefficients per output */
+template <unsigned int inputs, unsigned int outputs>
+using sl_cr_mixer_matrix_t = sl_cr_rc_norm_t[outputs][inputs];
+
+/* Tank: inputs {left, right}, outputs {left, right} */
+constexpr sl_cr_mixer_matrix_t<2,2> sl_cr_mixer_tank =
+{
+  {SL_CR_MIXER_UNITY, 0                },
+  {0,                 SL_CR_MIXER_UNITY},
+};
+/* Arcade: inputs {throttle, steering}, outputs {left, right} */
+constexpr sl_cr_mixer_matrix_t<2,2> sl_cr_mixer_arcade =
+{
+  {SL_CR_MIXER_UNITY,  SL_CR_MIXER_UNITY},
+  {SL_CR_MIXER_UNITY, -SL_CR_MIXER_UNITY},
+};
+/* 4WD arcade: inputs {throttle, steering}, outputs {front left, rear left, front right, rear right} */
+constexpr sl_cr_mixer_matrix_t<2,4> sl_cr_mixer_arcade_4wd =
+{
+  {SL_CR_MIXER_UNITY,  SL_CR_MIXER_UNITY},
+  {SL_CR_MIXER_UNITY,  SL_CR_MIXER_UNITY},
+  {SL_CR_MIXER_UNITY, -SL_CR_MIXER_UNITY},
+  {SL_CR_MIXER_UNITY, -SL_CR_MIXER_UNITY},
+};
+/* Arcade with weapon passthrough: inputs {throttle, steering, weapon}, outputs {left, right, weapon} */
+constexpr sl_cr_mixer_matrix_t<3,3> sl_cr_mixer_arcade_weapon =
+{
+  {SL_CR_MIXER_UNITY,  SL_CR_MIXER_UNITY, 0                },
+  {SL_CR_MIXER_UNITY, -SL_CR_MIXER_UNITY, 0                },
+  {0,                  0,                 SL_CR_MIXER_UNITY},
+};
+
+/* Applies a compile-time sized mixing matrix to normalized inputs.
+     If any output saturates, all outputs are scaled down together so their ratios (e.g. turn radius) are preserved */
+template <unsigned int inputs, unsigned int outputs>
+class sl_cr_mixer_c
+{
+  private:
+    sl_cr_rc_norm_t matrix[outputs][inputs];
+
+  public:
+    sl_cr_mixer_c(const sl_cr_mixer_matrix_t<inputs,outputs> &matrix)
+    {
+      for(unsigned int o = 0; o < outputs; o++)
+      {
+        for(unsigned int i = 0; i < inputs; i++)
+        {
+          this->matrix[o][i] = matrix[o][i];
+        }
+      }
+    }
+
+    /* Mixes valid normalized inputs into normalized outputs */
+    void mix(const sl_cr_rc_norm_t (&in)[inputs], sl_cr_rc_norm_t (&out)[outputs]) const
+    {
+      int32_t sum[outputs];
+      int32_t peak = SL_CR_RC_NORM_MAX;
+
+      for(unsigned int o = 0; o < outputs; o++)
+      {
+        int32_t accumulator = 0;
+        for(unsigned int i = 0; i < inputs; i++)
+        {
+          accumulator += ((int32_t) in[i]) * matrix[o][i];
+        }
+        sum[o] = accumulator >> SL_CR_RC_NORM_SHIFT;
+
+        const int32_t magnitude = (sum[o] < 0)?-sum[o]:sum[o];
+        peak = (magnitude > peak)?magnitude:peak;
+      }
+
+      if(peak > SL_CR_RC_NORM_MAX)
+      {
+        /* Saturated, single divide for all outputs.  Scale rounds up and magnitudes round down, so the peak output lands exactly on
+             full scale in either direction */
+        const int32_t scale = ((SL_CR_RC_NORM_MAX << SL_CR_MIXER_SCALE_SHIFT) + peak - 1) / peak;
+        for(unsigned int o = 0; o < outputs; o++)
+        {
+          sum[o] = (sum[o] < 0)?-((-sum[o] * scale) >> SL_CR_MIXER_SCALE_SHIFT):((sum[o] * scale) >> SL_CR_MIXER_SCALE_SHIFT);
+        }
+      }
+
+      for(unsigned int o = 0; o < outputs; o++)
+      {
+        out[o] = (sl_cr_rc_norm_t) sum[o];
+      }
+    }
+};
+
+#endif /* __SL_CR_MIXER_HPP__ */
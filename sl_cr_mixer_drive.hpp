@@ -0,0 +1,187 @@
+/*
+  sl_cr_mixer_drive.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_MIXER_DRIVE_HPP__
+#define __SL_CR_MIXER_DRIVE_HPP__
+
+#include "sl_robot_motor_driver.hpp"
+#include "sl_cr_mixer.hpp"
+#include "sl_cr_rc_map.hpp"
+#include "sl_cr_sbus.hpp"
+#include "sl_cr_types.hpp"
+
+/* Drive strategy mixing RC channels onto any number of motors (tank, arcade, 4WD, weapon passthrough, etc. are mixing matrices).
+     motor_t is any type providing the motor_driver_c drive interface (change_set_rpm, brake_motor, enable, disable, get_min/max_rpm) */
+template <unsigned int inputs, unsigned int outputs, typename motor_t = sandor_laboratories::robot::motor_driver_c>
+class sl_cr_mixer_drive_c
+{
+  private:
+    motor_t                                    *motors[outputs];
+    sl_cr_rc_channel_t                          input_channels[inputs];
+    /* Calibration maps for input channels */
+    const sl_cr_rc_map_s                       *input_maps[inputs];
+
+    sl_cr_mixer_c<inputs, outputs>              mixer;
+
+    /* Brake motors when their output is neutral, otherwise hold 0 rpm */
+    bool neutral_brake;
+    /* Hold motors disabled until all inputs return to neutral (e.g. after switching strategies) */
+    bool neutral_required;
+
+    /* Sequence number of last RC frame applied to motors */
+    uint32_t last_frame_sequence;
+    /* Receive time of last RC frame applied to motors */
+    sl_cr_time_us_t last_frame_rx_time;
+
+    const void * failsafe_user_data_ptr = nullptr;
+    /* Function pointer to call to check if failsafe has been triggered */
+    sandor_laboratories::robot::failsafe_f failsafe;
+
+    /* Stops all motors */
+    void disable_motors()
+    {
+      for(unsigned int o = 0; o < outputs; o++)
+      {
+        motors[o]->disable(sandor_laboratories::robot::MOTOR_DISABLE_DRIVE_STRATEGY);
+      }
+    }
+
+    /* Compute motor speeds */
+    void set_motor_speeds(const sl_cr_sbus_frame_s *frame)
+    {
+      sl_cr_rc_norm_t in[inputs];
+      sl_cr_rc_norm_t out[outputs];
+      bool            valid = true;
+
+      for(unsigned int i = 0; i < inputs; i++)
+      {
+        in[i] = sl_cr_rc_map(input_maps[i], sl_cr_sbus_get_frame_ch_value(frame, input_channels[i]));
+        valid = valid && (SL_CR_RC_NORM_INVALID != in[i]);
+      }
+
+      if(valid && neutral_required)
+      {
+        for(unsigned int i = 0; i < inputs; i++)
+        {
+          valid = valid && (0 == in[i]);
+        }
+        neutral_required = !valid;
+      }
+
+      if(!valid)
+      {
+        /* Invalid input or waiting for neutral, disable motors */
+        disable_motors();
+      }
+      else
+      {
+        mixer.mix(in, out);
+
+        for(unsigned int o = 0; o < outputs; o++)
+        {
+          motor_t *motor = motors[o];
+
+          if(neutral_brake && 0 == out[o])
+          {
+            /* Output is neutral, brake motor */
+            motor->brake_motor();
+          }
+          else
+          {
+            motor->change_set_rpm(sl_cr_rc_map_scale(out[o], motor->get_min_rpm(), motor->get_max_rpm()));
+          }
+
+          /* Input is valid, enable motor */
+          motor->enable(sandor_laboratories::robot::MOTOR_DISABLE_DRIVE_STRATEGY);
+        }
+      }
+    }
+
+  public:
+    sl_cr_mixer_drive_c
+    (
+      motor_t * const (&motors)[outputs],
+      const sl_cr_rc_channel_t (&input_channels)[inputs],
+      const sl_cr_mixer_matrix_t<inputs,outputs> &matrix,
+      bool neutral_brake
+    ) : mixer(matrix)
+    {
+      for(unsigned int o = 0; o < outputs; o++)
+      {
+        this->motors[o] = motors[o];
+      }
+      for(unsigned int i = 0; i < inputs; i++)
+      {
+        this->input_channels[i] = input_channels[i];
+        this->input_maps[i]     = sl_cr_rc_map_get(input_channels[i]);
+      }
+
+      this->neutral_brake       = neutral_brake;
+      this->neutral_required    = false;
+      this->last_frame_sequence = SL_CR_SBUS_SEQUENCE_INVALID;
+      this->last_frame_rx_time  = 0;
+      this->failsafe            = nullptr;
+    }
+
+    /* Checks if drive is currently disabled */
+    bool disabled()
+    {
+      bool ret_val = false;
+
+      if(failsafe != nullptr &&
+         failsafe(failsafe_user_data_ptr) == true )
+      {
+        ret_val = true;
+      }
+
+      return ret_val;
+    }
+
+    /* Receive time of last RC frame applied to motors */
+    inline sl_cr_time_us_t get_last_frame_rx_time() const {return last_frame_rx_time;}
+
+    /* Takes control of motors.  Motors stay disabled until all inputs are neutral */
+    void activate()
+    {
+      neutral_required    = true;
+      last_frame_sequence = SL_CR_SBUS_SEQUENCE_INVALID;
+    }
+
+    /* Releases control of motors, leaving them disabled */
+    void deactivate()
+    {
+      disable_motors();
+      last_frame_sequence = SL_CR_SBUS_SEQUENCE_INVALID;
+    }
+
+    /* To be called regularly as part of the software's main loop with the latest RC frame.  Returns true if a new RC frame was
+         applied to motors */
+    bool loop(const sl_cr_sbus_frame_s *frame)
+    {
+      bool frame_applied = false;
+
+      if(disabled())
+      {
+        /* Drive disabled, stop motors */
+        disable_motors();
+        /* Reapply next frame once re-enabled */
+        last_frame_sequence = SL_CR_SBUS_SEQUENCE_INVALID;
+      }
+      else if(frame->sequence != last_frame_sequence)
+      {
+        /* Set motor speeds, only if RC input has changed */
+        set_motor_speeds(frame);
+        last_frame_sequence = frame->sequence;
+        last_frame_rx_time  = frame->rx_time;
+        frame_applied       = true;
+      }
+
+      return frame_applied;
+    }
+};
+
+#endif /* __SL_CR_MIXER_DRIVE_HPP__ */
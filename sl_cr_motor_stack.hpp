@@ -0,0 +1,190 @@
+/*
+  sl_cr_motor_stack.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_MOTOR_STACK_HPP__
+#define __SL_CR_MOTOR_STACK_HPP__
+
+#include "sl_robot_motor_driver.hpp"
+#include "sl_robot_types.hpp"
+
+/* Reason passed by drive strategies to enable/disable */
+typedef decltype(sandor_laboratories::robot::MOTOR_DISABLE_DRIVE_STRATEGY) sl_cr_motor_disable_reason_t;
+
+/* One motor with its (optional) encoder and speed control loop.
+     Speed feedback is closed here rather than in the motor driver, so encoder edges never touch the driver.  The driver runs open loop and
+     receives the control loop output as its set point.  Limp mode bypasses the control loop, as it bypassed the driver's own.  Provides the
+     motor interface used by drive strategies.
+     timer_owned: loop() runs from a hardware timer, which is the driver's only caller.  The drive strategy interface then only records
+       the request, the next timer tick applies it */
+template <typename robot_t, bool timer_owned = false>
+class sl_cr_motor_stack_c
+{
+  public:
+    typedef typename robot_t::motor_driver_t motor_driver_t;
+    typedef typename robot_t::encoder_t      encoder_t;
+    typedef typename robot_t::control_loop_t control_loop_t;
+
+  private:
+    motor_driver_t *driver;
+    encoder_t      *encoder;
+    control_loop_t *control_loop;
+
+    /* Function pointer to call to check if failsafe has been triggered */
+    sandor_laboratories::robot::failsafe_f failsafe;
+
+    /* Written by drive strategy, read by control loop */
+    volatile sandor_laboratories::robot::rpm_t set_rpm;
+    volatile bool                              braking;
+    volatile bool                              enabled;
+    volatile sl_cr_motor_disable_reason_t      enable_reason;
+
+    /* Set point passed to driver open loop, encoder only measures */
+    bool limp;
+
+    /* Enable and brake state last applied to driver, timer_owned only */
+    bool driver_enabled;
+    bool driver_braking;
+
+    inline bool closed_loop() const {return (!limp && nullptr != encoder && nullptr != control_loop);}
+
+    /* Applies drive strategy's enable and brake requests to driver, from the timer */
+    inline void apply_requests()
+    {
+      const bool enable_request = enabled;
+      const bool brake_request  = braking;
+
+      if(enable_request != driver_enabled)
+      {
+        if(enable_request)
+        {
+          driver->enable(enable_reason);
+        }
+        else
+        {
+          driver->disable(enable_reason);
+        }
+        driver_enabled = enable_request;
+      }
+
+      if(brake_request && !driver_braking)
+      {
+        driver->brake_motor();
+      }
+      else if(!brake_request && !closed_loop())
+      {
+        driver->change_set_rpm(set_rpm);
+      }
+      driver_braking = brake_request;
+    }
+
+  public:
+    sl_cr_motor_stack_c(motor_driver_t *driver, encoder_t *encoder, control_loop_t *control_loop, sandor_laboratories::robot::failsafe_f failsafe)
+    {
+      this->driver         = driver;
+      this->encoder        = encoder;
+      this->control_loop   = control_loop;
+      this->failsafe       = failsafe;
+      this->set_rpm        = 0;
+      this->braking        = false;
+      this->enabled        = false;
+      this->enable_reason  = sandor_laboratories::robot::MOTOR_DISABLE_DRIVE_STRATEGY;
+      this->limp           = false;
+      this->driver_enabled = false;
+      this->driver_braking = false;
+    }
+
+    /* Drive strategy interface */
+    void change_set_rpm(sandor_laboratories::robot::rpm_t rpm)
+    {
+      set_rpm = rpm;
+      braking = false;
+      if(!timer_owned && !closed_loop())
+      {
+        driver->change_set_rpm(rpm);
+      }
+    }
+    void brake_motor()
+    {
+      set_rpm = 0;
+      braking = true;
+      if(!timer_owned)
+      {
+        driver->brake_motor();
+      }
+    }
+    void enable(sl_cr_motor_disable_reason_t reason)
+    {
+      enable_reason = reason;
+      enabled       = true;
+      if(!timer_owned)
+      {
+        driver->enable(reason);
+      }
+    }
+    void disable(sl_cr_motor_disable_reason_t reason)
+    {
+      enable_reason = reason;
+      enabled       = false;
+      if(!timer_owned)
+      {
+        driver->disable(reason);
+      }
+    }
+    /* Runs motor open loop regardless of encoder.  Call before the control loop starts */
+    void set_limp_mode(bool limp)
+    {
+      this->limp = limp;
+      if(control_loop)
+      {
+        control_loop->control_loop_t::reset();
+      }
+      driver->set_limp_mode(limp);
+    }
+    inline sandor_laboratories::robot::rpm_t get_min_rpm() const {return driver->get_min_rpm();}
+    inline sandor_laboratories::robot::rpm_t get_max_rpm() const {return driver->get_max_rpm();}
+
+    /* Control loop step: batches encoder edges into a speed measurement, runs the control loop into the driver set point, then driver
+         housekeeping (failsafe, enable state, PWM).  Qualified calls dispatch statically.
+         timer_owned: call only from the timer, which also applies the drive strategy's latest requests, so the PWM follows the control
+         loop at the timer rate.  Otherwise call from the control loop task */
+    inline void loop()
+    {
+      if(encoder)
+      {
+        encoder->encoder_t::loop();
+      }
+
+      if(timer_owned)
+      {
+        apply_requests();
+      }
+
+      if(closed_loop())
+      {
+        if(braking || !enabled || (failsafe && failsafe(nullptr)))
+        {
+          /* Not driving, do not accumulate error or apply a stale output */
+          control_loop->control_loop_t::reset();
+        }
+        else
+        {
+          driver->change_set_rpm(control_loop->control_loop_t::loop(set_rpm, encoder->get_rpm()));
+        }
+      }
+
+      driver->motor_driver_t::loop();
+    }
+
+    inline sandor_laboratories::robot::rpm_t get_set_rpm()       const {return set_rpm;}
+    inline sandor_laboratories::robot::rpm_t get_commanded_rpm() const {return driver->get_commanded_rpm();}
+    inline sandor_laboratories::robot::rpm_t get_real_rpm()      const {return encoder?encoder->get_rpm():driver->get_real_rpm();}
+
+    inline encoder_t      *get_encoder()      const {return encoder;}
+    inline control_loop_t *get_control_loop() const {return control_loop;}
+};
+
+#endif /* __SL_CR_MOTOR_STACK_HPP__ */
@@ -0,0 +1,119 @@
+/*
+  sl_cr_profiler.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#include <Arduino.h>
+
+#include "sl_cr_profiler.hpp"
+#include "sl_cr_seqlock.hpp"
+
+/* CPU cycles per us */
+#define SL_CR_PROFILER_CYCLES_PER_US (F_CPU_ACTUAL / 1000000)
+
+typedef struct
+{
+  /* Owned by profiled task */
+  sl_cr_profiler_stats_s                  stats;
+  uint32_t                                start;
+  uint32_t                                period;
+  bool                                    started;
+  /* Last iteration ran longer than its period, its deadline miss is already counted */
+  bool                                    overran;
+
+  /* Published copy for readers */
+  sl_cr_seqlock_c<sl_cr_profiler_stats_s> stats_published;
+} sl_cr_profiler_task_s;
+
+sl_cr_profiler_task_s profiler_tasks[SL_CR_PROFILER_TASK_COUNT];
+
+static const char * const profiler_task_names[SL_CR_PROFILER_TASK_COUNT] =
+{
+  "SBUS",
+  "Drive",
+  "Control Loop",
+  "Watchdog",
+  "Log",
+};
+
+void sl_cr_profiler_begin(sl_cr_profiler_task_e task, sl_cr_time_us_t period)
+{
+  const uint32_t         now  = ARM_DWT_CYCCNT;
+  sl_cr_profiler_task_s *data = &profiler_tasks[task];
+
+  if(data->started && (SL_CR_PROFILER_APERIODIC != data->period))
+  {
+    const uint32_t interval = now - data->start;
+    const uint32_t jitter   = ((interval > data->period)?(interval - data->period):(data->period - interval)) / SL_CR_PROFILER_CYCLES_PER_US;
+
+    /* Bin is floor(log2(jitter)), jitter below 2us in bin 0 */
+    unsigned int bin = (jitter < 2)?0:(31 - __builtin_clz(jitter));
+    bin = (bin < SL_CR_PROFILER_JITTER_HISTOGRAM_BINS)?bin:(SL_CR_PROFILER_JITTER_HISTOGRAM_BINS-1);
+    data->stats.jitter_histogram[bin]++;
+
+    if((interval >= (2 * data->period)) && !data->overran)
+    {
+      /* Started a whole period late without overrunning, a release was skipped */
+      data->stats.deadline_misses++;
+    }
+  }
+
+  data->start   = now;
+  data->period  = period * SL_CR_PROFILER_CYCLES_PER_US;
+  data->started = true;
+}
+
+void sl_cr_profiler_end(sl_cr_profiler_task_e task)
+{
+  sl_cr_profiler_task_s *data      = &profiler_tasks[task];
+  const uint32_t         execution = ARM_DWT_CYCCNT - data->start;
+
+  data->stats.execution_min    = ((0 == data->stats.runs) || (execution < data->stats.execution_min))?execution:data->stats.execution_min;
+  data->stats.execution_max    = (execution > data->stats.execution_max)?execution:data->stats.execution_max;
+  data->stats.execution_total += execution;
+  data->stats.runs++;
+
+  data->overran = (SL_CR_PROFILER_APERIODIC != data->period) && (execution > data->period);
+  if(data->overran)
+  {
+    /* Still running when next iteration was due, next begin() does not count the late start again */
+    data->stats.deadline_misses++;
+  }
+
+  data->stats_published.write(data->stats);
+}
+
+void sl_cr_profiler_get_stats(sl_cr_profiler_task_e task, sl_cr_profiler_stats_s *stats)
+{
+  profiler_tasks[task].stats_published.read(stats);
+}
+
+void sl_cr_profiler_log_stats(log_key_e log_key)
+{
+  static_assert(10 == SL_CR_PROFILER_JITTER_HISTOGRAM_BINS, "Histogram log format expects 10 bins");
+  sl_cr_profiler_stats_s stats;
+
+  for(unsigned int t = 0; t < SL_CR_PROFILER_TASK_COUNT; t++)
+  {
+    sl_cr_profiler_get_stats((sl_cr_profiler_task_e) t, &stats);
+
+    if(stats.runs > 0)
+    {
+      log_snprintf(log_key, LOG_LEVEL_INFO,
+        "%s runs: %u execution min: %uus avg: %uus max: %uus deadline misses: %u",
+        profiler_task_names[t], stats.runs,
+        (unsigned int) (stats.execution_min / SL_CR_PROFILER_CYCLES_PER_US),
+        (unsigned int) ((stats.execution_total / stats.runs) / SL_CR_PROFILER_CYCLES_PER_US),
+        (unsigned int) (stats.execution_max / SL_CR_PROFILER_CYCLES_PER_US),
+        stats.deadline_misses);
+      log_snprintf(log_key, LOG_LEVEL_INFO,
+        "%s start jitter histogram (<2us, then doubling): %u %u %u %u %u %u %u %u %u %u",
+        profiler_task_names[t],
+        stats.jitter_histogram[0], stats.jitter_histogram[1], stats.jitter_histogram[2], stats.jitter_histogram[3],
+        stats.jitter_histogram[4], stats.jitter_histogram[5], stats.jitter_histogram[6], stats.jitter_histogram[7],
+        stats.jitter_histogram[8], stats.jitter_histogram[9]);
+    }
+  }
+}
@@ -0,0 +1,60 @@
+/*
+  sl_cr_profiler.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_PROFILER_HPP__
+#define __SL_CR_PROFILER_HPP__
+
+#include <stdint.h>
+
+#include "sl_cr_types.hpp"
+#include "sl_robot_log.hpp"
+
+/* Profiled tasks */
+typedef enum
+{
+  SL_CR_PROFILER_TASK_SBUS,
+  SL_CR_PROFILER_TASK_DRIVE,
+  SL_CR_PROFILER_TASK_CONTROL_LOOP,
+  SL_CR_PROFILER_TASK_WATCHDOG,
+  SL_CR_PROFILER_TASK_LOG,
+  SL_CR_PROFILER_TASK_COUNT,
+} sl_cr_profiler_task_e;
+
+/* Start jitter histogram, bin 0 is below 2us and each following bin doubles (bin n is 2^n to 2^(n+1) us).
+     Last bin also counts all larger jitter */
+#define SL_CR_PROFILER_JITTER_HISTOGRAM_BINS 10
+
+/* Period passed for event driven loops, no jitter or deadline checks */
+#define SL_CR_PROFILER_APERIODIC 0
+
+/* Loop timing of one task since boot, times in CPU cycles */
+typedef struct
+{
+  /* Loop iterations profiled */
+  unsigned int runs;
+  /* Execution time of loop body */
+  uint32_t     execution_min;
+  uint32_t     execution_max;
+  uint64_t     execution_total;
+  /* Iterations that ran longer than their period, or started a whole period late.  Each iteration counts at most once */
+  unsigned int deadline_misses;
+  /* Deviation of start from previous start plus period */
+  unsigned int jitter_histogram[SL_CR_PROFILER_JITTER_HISTOGRAM_BINS];
+} sl_cr_profiler_stats_s;
+
+/* Marks start of a task's loop body.  period is the task's expected start interval (us), or SL_CR_PROFILER_APERIODIC.
+     Each task must only profile itself */
+void sl_cr_profiler_begin(sl_cr_profiler_task_e task, sl_cr_time_us_t period);
+/* Marks end of a task's loop body and publishes its stats */
+void sl_cr_profiler_end(sl_cr_profiler_task_e task);
+
+/* Copies latest stats of a task (lock-free) */
+void sl_cr_profiler_get_stats(sl_cr_profiler_task_e task, sl_cr_profiler_stats_s *stats);
+/* Logs latest stats of all tasks.  Formatting happens in the caller's context */
+void sl_cr_profiler_log_stats(log_key_e log_key);
+
+#endif /* __SL_CR_PROFILER_HPP__ */
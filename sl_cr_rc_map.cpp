@@ -0,0 +1,36 @@
+/*
+  sl_cr_rc_map.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#include <Arduino.h>
+
+#include "sl_cr_config.h"
+#include "sl_cr_rc_map.hpp"
+
+/* Maps are computed by the compiler, each conversion is a few compares, multiplies and shifts */
+constexpr sl_cr_rc_map_s rc_map_default = sl_cr_rc_map_build(SL_CR_RC_MAP_DEFAULT_CONFIG);
+constexpr sl_cr_rc_map_s rc_map_ch1     = sl_cr_rc_map_build(SL_CR_RC_MAP_CH1_CONFIG);
+constexpr sl_cr_rc_map_s rc_map_ch2     = sl_cr_rc_map_build(SL_CR_RC_MAP_CH2_CONFIG);
+constexpr sl_cr_rc_map_s rc_map_ch3     = sl_cr_rc_map_build(SL_CR_RC_MAP_CH3_CONFIG);
+constexpr sl_cr_rc_map_s rc_map_ch4     = sl_cr_rc_map_build(SL_CR_RC_MAP_CH4_CONFIG);
+
+/* Indexed by channel, stick channels 1-4 are individually calibrated */
+const sl_cr_rc_map_s * const rc_maps[SL_CR_SBUS_NUM_CH+1] =
+{
+  &rc_map_default,
+  &rc_map_ch1,
+  &rc_map_ch2,
+  &rc_map_ch3,
+  &rc_map_ch4,
+  &rc_map_default, &rc_map_default, &rc_map_default, &rc_map_default,
+  &rc_map_default, &rc_map_default, &rc_map_default, &rc_map_default,
+  &rc_map_default, &rc_map_default, &rc_map_default, &rc_map_default,
+};
+
+const sl_cr_rc_map_s *sl_cr_rc_map_get(sl_cr_rc_channel_t channel)
+{
+  return (channel <= SL_CR_SBUS_NUM_CH)?rc_maps[channel]:&rc_map_default;
+}
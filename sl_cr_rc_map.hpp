@@ -0,0 +1,95 @@
+/*
+  sl_cr_rc_map.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_RC_MAP_HPP__
+#define __SL_CR_RC_MAP_HPP__
+
+#include <stdint.h>
+
+#include "sl_cr_sbus_decoder.hpp"
+#include "sl_cr_types.hpp"
+
+/* Normalized RC command, Q12 fixed point: -SL_CR_RC_NORM_MAX (full reverse) to SL_CR_RC_NORM_MAX (full forward) */
+typedef int16_t sl_cr_rc_norm_t;
+#define SL_CR_RC_NORM_SHIFT   12
+#define SL_CR_RC_NORM_MAX     (1<<SL_CR_RC_NORM_SHIFT)
+/* Raw value outside calibrated range */
+#define SL_CR_RC_NORM_INVALID INT16_MIN
+
+/* Calibration of one RC channel */
+typedef struct
+{
+  /* Raw values outside [min, max] are invalid */
+  sl_cr_rc_channel_value_t min;
+  sl_cr_rc_channel_value_t center;
+  sl_cr_rc_channel_value_t max;
+  /* Raw values within center +/- deadzone are treated as neutral */
+  sl_cr_rc_channel_value_t deadzone;
+  /* Expo in percent, 0 is linear, 100 is fully cubic */
+  unsigned int             expo;
+  /* Invert direction */
+  bool                     reverse;
+} sl_cr_rc_map_config_s;
+
+/* Calibration with the divisions done at compile time */
+typedef struct
+{
+  sl_cr_rc_map_config_s config;
+  /* Normalized command per raw step from center (Q16, rounded), above and below center, negative when reversed */
+  int32_t               scale_above;
+  int32_t               scale_below;
+} sl_cr_rc_map_s;
+
+#define SL_CR_RC_MAP_SCALE_SHIFT 16
+
+constexpr int32_t sl_cr_rc_map_build_scale(int32_t range, bool reverse)
+{
+  const int32_t scale = (range > 0)?(int32_t) ((((int64_t) SL_CR_RC_NORM_MAX << SL_CR_RC_MAP_SCALE_SHIFT) + (range / 2)) / range):0;
+  return reverse?-scale:scale;
+}
+
+/* Builds channel map at compile time */
+constexpr sl_cr_rc_map_s sl_cr_rc_map_build(const sl_cr_rc_map_config_s &config)
+{
+  return {config, sl_cr_rc_map_build_scale(config.max - config.center, config.reverse),
+                  sl_cr_rc_map_build_scale(config.center - config.min, config.reverse)};
+}
+
+/* Converts raw channel value to normalized command with compares, a multiply and a shift, no division.  Written as selects rather than
+     branches, stick values are not predictable */
+inline sl_cr_rc_norm_t sl_cr_rc_map(const sl_cr_rc_map_s *map, sl_cr_rc_channel_value_t raw)
+{
+  const sl_cr_rc_map_config_s &config = map->config;
+
+  /* Linear position from center, each side scaled to its own half range, rounded to nearest */
+  const int32_t offset  = (int32_t) raw - config.center;
+  int32_t       command = ((offset * ((offset > 0)?map->scale_above:map->scale_below)) + (1 << (SL_CR_RC_MAP_SCALE_SHIFT-1))) >>
+                          SL_CR_RC_MAP_SCALE_SHIFT;
+
+  if(0 != config.expo)
+  {
+    /* Blend linear and cubic response */
+    const int32_t cubic = (int32_t) (((int64_t) command * command * command) / ((int64_t) SL_CR_RC_NORM_MAX * SL_CR_RC_NORM_MAX));
+    command = ((command * (int32_t) (100 - config.expo)) + (cubic * (int32_t) config.expo)) / 100;
+  }
+
+  const bool invalid = ((uint32_t) (raw - config.min) > (uint32_t) (config.max - config.min));
+  const bool neutral = ((uint32_t) (offset + config.deadzone) <= (2U * config.deadzone));
+
+  return invalid?SL_CR_RC_NORM_INVALID:(neutral?0:(sl_cr_rc_norm_t) command);
+}
+
+/* Scales valid normalized command into [min, max] with a multiply and shift */
+inline int32_t sl_cr_rc_map_scale(sl_cr_rc_norm_t norm, int32_t min, int32_t max)
+{
+  return (norm >= 0)?((norm*max) >> SL_CR_RC_NORM_SHIFT):-(((-norm)*(-min)) >> SL_CR_RC_NORM_SHIFT);
+}
+
+/* Returns calibrated map for an RC channel */
+const sl_cr_rc_map_s *sl_cr_rc_map_get(sl_cr_rc_channel_t channel);
+
+#endif /* __SL_CR_RC_MAP_HPP__ */
@@ -0,0 +1,165 @@
+/*
+  sl_cr_ring_buffer.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_RING_BUFFER_HPP__
+#define __SL_CR_RING_BUFFER_HPP__
+
+#include <atomic>
+#include <stdint.h>
+
+/* Lock-free single-producer single-consumer ring buffer.
+     Producer may be an ISR.  Pushing to a full buffer drops the new entry and counts it, it never blocks. */
+template <typename data_t, unsigned int capacity>
+class sl_cr_ring_buffer_c
+{
+  static_assert(0 == (capacity & (capacity-1)), "Ring buffer capacity must be a power of 2");
+
+  private:
+    data_t                buffer[capacity];
+    /* Free-running indices, wrap naturally */
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+    std::atomic<uint32_t> dropped;
+
+  public:
+    sl_cr_ring_buffer_c() : buffer(), head(0), tail(0), dropped(0) {}
+
+    /* Producer only.  Returns false if full and entry was dropped */
+    bool push(const data_t &data)
+    {
+      bool ret_val = false;
+      const uint32_t current_head = head.load(std::memory_order_relaxed);
+
+      if((current_head - tail.load(std::memory_order_acquire)) < capacity)
+      {
+        buffer[current_head & (capacity-1)] = data;
+        head.store(current_head+1, std::memory_order_release);
+        ret_val = true;
+      }
+      else
+      {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      return ret_val;
+    }
+
+    /* Consumer only.  Returns false if empty */
+    bool pop(data_t *data)
+    {
+      bool ret_val = false;
+      const uint32_t current_tail = tail.load(std::memory_order_relaxed);
+
+      if(current_tail != head.load(std::memory_order_acquire))
+      {
+        *data = buffer[current_tail & (capacity-1)];
+        tail.store(current_tail+1, std::memory_order_release);
+        ret_val = true;
+      }
+
+      return ret_val;
+    }
+
+    /* Number of entries waiting */
+    inline uint32_t get_count() const {return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);}
+    /* Number of entries dropped because buffer was full */
+    inline uint32_t get_dropped() const {return dropped.load(std::memory_order_relaxed);}
+};
+
+/* Lock-free multi-producer single-consumer ring buffer.
+     Producers claim a slot with compare-and-swap and publish it through the slot's sequence, so any number of tasks or ISRs may push.
+     Pushing to a full buffer drops the new entry and counts it, it never blocks.  A producer preempted between claiming and publishing
+     only delays the consumer until it resumes, entries are never lost or reordered. */
+template <typename data_t, unsigned int capacity>
+class sl_cr_mpsc_ring_buffer_c
+{
+  static_assert(0 == (capacity & (capacity-1)), "Ring buffer capacity must be a power of 2");
+
+  private:
+    typedef struct
+    {
+      /* Index this slot next accepts a push for, or that index+1 once published */
+      std::atomic<uint32_t> sequence;
+      data_t                data;
+    } slot_s;
+
+    slot_s                slots[capacity];
+    /* Free-running indices, wrap naturally */
+    std::atomic<uint32_t> head;
+    uint32_t              tail;
+    std::atomic<uint32_t> dropped;
+
+  public:
+    sl_cr_mpsc_ring_buffer_c() : head(0), tail(0), dropped(0)
+    {
+      for(uint32_t i = 0; i < capacity; i++)
+      {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+      }
+    }
+
+    /* Any producer.  Returns false if full and entry was dropped */
+    bool push(const data_t &data)
+    {
+      bool     ret_val      = false;
+      bool     done         = false;
+      uint32_t current_head = head.load(std::memory_order_relaxed);
+
+      while(!done)
+      {
+        slot_s * const slot = &slots[current_head & (capacity-1)];
+        const int32_t  diff = (int32_t) (slot->sequence.load(std::memory_order_acquire) - current_head);
+
+        if(0 == diff)
+        {
+          /* Slot free for this index, claim it.  On failure current_head is reloaded */
+          if(head.compare_exchange_weak(current_head, current_head+1, std::memory_order_relaxed))
+          {
+            slot->data = data;
+            slot->sequence.store(current_head+1, std::memory_order_release);
+            ret_val = true;
+            done    = true;
+          }
+        }
+        else if(diff < 0)
+        {
+          /* Slot still holds an entry from one lap ago, full */
+          dropped.fetch_add(1, std::memory_order_relaxed);
+          done = true;
+        }
+        else
+        {
+          /* Another producer claimed this index */
+          current_head = head.load(std::memory_order_relaxed);
+        }
+      }
+
+      return ret_val;
+    }
+
+    /* Consumer only.  Returns false if empty (or next entry not yet published) */
+    bool pop(data_t *data)
+    {
+      bool ret_val = false;
+      slot_s * const slot = &slots[tail & (capacity-1)];
+
+      if(slot->sequence.load(std::memory_order_acquire) == (tail+1))
+      {
+        *data = slot->data;
+        slot->sequence.store(tail+capacity, std::memory_order_release);
+        tail++;
+        ret_val = true;
+      }
+
+      return ret_val;
+    }
+
+    /* Number of entries dropped because buffer was full */
+    inline uint32_t get_dropped() const {return dropped.load(std::memory_order_relaxed);}
+};
+
+#endif /* __SL_CR_RING_BUFFER_HPP__ */
@@ -0,0 +1,163 @@
+/*
+  sl_cr_robot.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_ROBOT_HPP__
+#define __SL_CR_ROBOT_HPP__
+
+#include "sl_cr_config.h"
+#include "sl_cr_encoder.hpp"
+#include "sl_cr_fixed_pid.hpp"
+#include "sl_cr_static_slot.hpp"
+#include "sl_cr_types.hpp"
+#include "sl_robot_log.hpp"
+#include "sl_robot_motor_driver.hpp"
+#include "sl_robot_motor_driver_drv8256p.hpp"
+#include "sl_robot_motor_driver_virtual.hpp"
+#include "sl_robot_pid_loop.hpp"
+
+/* Robot descriptors name the concrete types and hardware of one robot variant.  SL_CR_ROBOT selects which is built.
+     Each descriptor provides:
+       motor_driver_t, encoder_t, control_loop_t - concrete types of each motor stack layer
+       default_drive_strategy                    - strategy while strategy switch is low
+       min/max_commanded_rpm                     - motor driver output range
+       motor_count, motors[]                     - per-motor hardware, any number of motors per side
+       create_motor_driver/encoder/control_loop  - construct into static slots, encoder and control loop may return nullptr for open loop.
+                                                   Motor drivers always run open loop, speed feedback is closed by sl_cr_motor_stack_c.
+                                                   Control loop is given the period (us) it will run at */
+
+/* Side of robot a drive motor is on, matches output order of left/right mixing matrices */
+typedef enum
+{
+  SL_CR_ROBOT_SIDE_LEFT,
+  SL_CR_ROBOT_SIDE_RIGHT,
+  SL_CR_ROBOT_SIDE_COUNT,
+} sl_cr_robot_side_e;
+
+/* Hardware of one drive motor */
+typedef struct
+{
+  const char                              *name;
+  sl_cr_robot_side_e                       side;
+  sandor_laboratories::robot::pin_t        in1_pin;
+  sandor_laboratories::robot::pin_t        in2_pin;
+  sandor_laboratories::robot::pin_t        sleep_pin;
+  sandor_laboratories::robot::pin_t        encoder_a_pin;
+  sandor_laboratories::robot::pin_t        encoder_b_pin;
+  bool                                     encoder_reverse;
+  log_key_e                                driver_log_key;
+  log_key_e                                control_loop_log_key;
+} sl_cr_robot_motor_s;
+
+/* Bench robot, virtual motors without feedback */
+struct sl_cr_robot_virtual_s
+{
+  typedef sl_cr_motor_driver_virtual_c                                                        motor_driver_t;
+  typedef sl_cr_encoder_c                                                                     encoder_t;
+  typedef sl_cr_fixed_pid_c                                                                   control_loop_t;
+
+  static constexpr sl_cr_drive_strategy_e            default_drive_strategy = SL_CR_DRIVE_STRATEGY_ARCADE;
+  static constexpr sandor_laboratories::robot::rpm_t min_commanded_rpm      = -100;
+  static constexpr sandor_laboratories::robot::rpm_t max_commanded_rpm      =  100;
+
+  static constexpr unsigned int        motor_count = 2;
+  static constexpr sl_cr_robot_motor_s motors[motor_count] =
+  {
+    {"Left Motor",  SL_CR_ROBOT_SIDE_LEFT,  SL_CR_PIN_INVALID, SL_CR_PIN_INVALID, SL_CR_PIN_INVALID, SL_CR_PIN_INVALID, SL_CR_PIN_INVALID, false,
+      LOG_KEY_MOTOR_DRIVER_LEFT,  LOG_KEY_MOTOR_CONTROL_LOOP_LEFT},
+    {"Right Motor", SL_CR_ROBOT_SIDE_RIGHT, SL_CR_PIN_INVALID, SL_CR_PIN_INVALID, SL_CR_PIN_INVALID, SL_CR_PIN_INVALID, SL_CR_PIN_INVALID, false,
+      LOG_KEY_MOTOR_DRIVER_RIGHT, LOG_KEY_MOTOR_CONTROL_LOOP_RIGHT},
+  };
+
+  static encoder_t *create_encoder(sl_cr_static_slot_c<encoder_t> *, const sl_cr_robot_motor_s &)
+  {
+    return nullptr;
+  }
+  static control_loop_t *create_control_loop(sl_cr_static_slot_c<control_loop_t> *, const sl_cr_robot_motor_s &,
+                                             const sandor_laboratories::robot::motor_driver_config_s &, uint32_t)
+  {
+    return nullptr;
+  }
+  static motor_driver_t *create_motor_driver(sl_cr_static_slot_c<motor_driver_t> *slot, const sl_cr_robot_motor_s &motor,
+                                             const sandor_laboratories::robot::motor_driver_config_s &config)
+  {
+    return slot->construct(motor.name, config);
+  }
+};
+
+/* DRV8256P motor drivers with quadrature encoders and PID speed control */
+struct sl_cr_robot_drv8256p_s
+{
+  typedef sandor_laboratories::robot::motor_driver_drv8256p_c                                 motor_driver_t;
+  typedef sl_cr_encoder_c                                                                     encoder_t;
+  typedef sl_cr_fixed_pid_c                                                                   control_loop_t;
+
+  static constexpr sl_cr_drive_strategy_e            default_drive_strategy = SL_CR_DRIVE_STRATEGY_ARCADE;
+  static constexpr sandor_laboratories::robot::rpm_t min_commanded_rpm      = -SL_CR_PWM_MAX_VALUE;
+  static constexpr sandor_laboratories::robot::rpm_t max_commanded_rpm      =  SL_CR_PWM_MAX_VALUE;
+
+  /* Encoder counts per revolution and gearbox ratio */
+  static constexpr unsigned int encoder_cpr      = 12;
+  static constexpr unsigned int encoder_gear_num = 1;
+  static constexpr unsigned int encoder_gear_den = 30;
+  /* Edge timing for usable low speed feedback */
+  static constexpr sl_cr_encoder_velocity_mode_e encoder_velocity_mode = SL_CR_ENCODER_VELOCITY_EDGE_TIMING;
+
+  static constexpr sandor_laboratories::robot::pwm_config_s pwm_config =
+  {
+    .frequency  = SL_CR_DEFAULT_PWM_FREQ,
+    .resolution = SL_CR_PWM_RESOLUTION,
+    .max_value  = SL_CR_PWM_MAX_VALUE
+  };
+
+  static constexpr sandor_laboratories::robot::pid_loop_params_s pid_params =
+  {
+    .p_num = 50,
+    .p_den = 100,
+    .i_num = 25,
+    .i_den = 100,
+    .d_num = 12,
+    .d_den = 100,
+  };
+
+  static constexpr unsigned int        motor_count = 2;
+  static constexpr sl_cr_robot_motor_s motors[motor_count] =
+  {
+    {"Left Motor",  SL_CR_ROBOT_SIDE_LEFT,  SL_CR_PIN_DRIVE_MOTOR_2_IN1, SL_CR_PIN_DRIVE_MOTOR_2_IN2, SL_CR_PIN_DRIVE_MOTOR_2_SLEEP,
+      SL_CR_PIN_DRIVE_ENCODER_2_A, SL_CR_PIN_DRIVE_ENCODER_2_B, false,
+      LOG_KEY_MOTOR_DRIVER_LEFT,  LOG_KEY_MOTOR_CONTROL_LOOP_LEFT},
+    {"Right Motor", SL_CR_ROBOT_SIDE_RIGHT, SL_CR_PIN_DRIVE_MOTOR_1_IN1, SL_CR_PIN_DRIVE_MOTOR_1_IN2, SL_CR_PIN_DRIVE_MOTOR_1_SLEEP,
+      SL_CR_PIN_DRIVE_ENCODER_1_A, SL_CR_PIN_DRIVE_ENCODER_1_B, true,
+      LOG_KEY_MOTOR_DRIVER_RIGHT, LOG_KEY_MOTOR_CONTROL_LOOP_RIGHT},
+  };
+
+  static encoder_t *create_encoder(sl_cr_static_slot_c<encoder_t> *slot, const sl_cr_robot_motor_s &motor)
+  {
+    return slot->construct(motor.encoder_a_pin, motor.encoder_b_pin, motor.encoder_reverse, encoder_cpr, encoder_gear_num, encoder_gear_den,
+                           encoder_velocity_mode);
+  }
+  static control_loop_t *create_control_loop(sl_cr_static_slot_c<control_loop_t> *slot, const sl_cr_robot_motor_s &motor,
+                                             const sandor_laboratories::robot::motor_driver_config_s &config, uint32_t period_us)
+  {
+    /* Output is the open loop motor driver's set point.  pid_params are tuned at SL_CR_FIXED_PID_TUNING_PERIOD, rescaled to period_us */
+    return slot->construct
+    (
+      config.min_rpm, config.max_rpm,
+      config.min_rpm, config.max_rpm,
+      pid_params, motor.control_loop_log_key, period_us
+    );
+  }
+  static motor_driver_t *create_motor_driver(sl_cr_static_slot_c<motor_driver_t> *slot, const sl_cr_robot_motor_s &motor,
+                                             const sandor_laboratories::robot::motor_driver_config_s &config)
+  {
+    return slot->construct(motor.sleep_pin, motor.in1_pin, motor.in2_pin, pwm_config, config);
+  }
+};
+
+/* Robot being built */
+typedef SL_CR_ROBOT sl_cr_robot_t;
+
+#endif /* __SL_CR_ROBOT_HPP__ */
@@ -6,64 +6,483 @@
 */
 
 #include <Arduino.h>
-#include <sbus.h>
+#include <arduino_freertos.h>
 
+#include "sl_cr_blackbox.hpp"
 #include "sl_cr_types.hpp"
 #include "sl_cr_failsafe.hpp"
 #include "sl_cr_sbus.hpp"
+#include "sl_cr_sbus_decoder.hpp"
+#include "sl_cr_sbus_record.hpp"
+#include "sl_cr_seqlock.hpp"
 
 using namespace sandor_laboratories::robot;
 
-/* Time since last SBUS update to declare data stale (ms) */
-#define SL_CR_SBUS_STALE_TIMEOUT (4*SL_CR_SBUS_UPDATE_PERIOD)
+/* Time since last SBUS update to declare data stale, in detected frame periods */
+#define SL_CR_SBUS_STALE_TIMEOUT_PERIODS 4
+/* Frame period detection.  Intervals within 1/SL_CR_SBUS_PERIOD_TOLERANCE of the estimate are averaged in with weight 1/SL_CR_SBUS_PERIOD_FILTER.
+     After SL_CR_SBUS_PERIOD_RESEED_COUNT consecutive intervals outside tolerance the rate is assumed to have changed and estimate is reseeded */
+#define SL_CR_SBUS_PERIOD_TOLERANCE    4
+#define SL_CR_SBUS_PERIOD_FILTER       8
+#define SL_CR_SBUS_PERIOD_RESEED_COUNT 8
 /* Channel to array mapping */
 #define SL_CR_CH_TO_ARRAY_INDEX(channel) (channel-1)
-/* SbusRx object on Serial1 */
-bfs::SbusRx sbus_rx(&Serial1);
-/* Array for storing SBUS data */
-std::array<int16_t, bfs::SbusRx::NUM_CH()> sbus_data = {0};
-/* TIme of last update */
-time_ms_t last_sbus_read_time;
+/* SBUS UART configuration */
+#define SL_CR_SBUS_UART_0    Serial1
+#define SL_CR_SBUS_UART_1    Serial3
+#define SL_CR_SBUS_BAUD      100000
+#define SL_CR_SBUS_UART_MODE SERIAL_8E2_RXINV_TXINV
 
-void sl_cr_sbus_init()
+#if defined(__IMXRT1062__)
+/* Decode directly from the UART RX/idle interrupts.  Serial1 is LPUART6 and Serial3 is LPUART2 on Teensy 4.x */
+#define SL_CR_SBUS_RX_INTERRUPT
+#define SL_CR_SBUS_UART_0_PORT IMXRT_LPUART6
+#define SL_CR_SBUS_UART_0_IRQ  IRQ_LPUART6
+#define SL_CR_SBUS_UART_1_PORT IMXRT_LPUART2
+#define SL_CR_SBUS_UART_1_IRQ  IRQ_LPUART2
+/* Must not be higher (numerically lower) than FreeRTOS's max syscall interrupt priority */
+#define SL_CR_SBUS_UART_IRQ_PRIORITY 64
+/* Write-1-to-clear status flags.  STAT also holds configuration (RXINV is set for SBUS), so a flag is cleared by writing back the
+     configuration with only that flag set, never with |= which clears every pending flag unseen */
+#define SL_CR_SBUS_UART_STAT_W1C (LPUART_STAT_LBKDIF | LPUART_STAT_RXEDGIF | LPUART_STAT_IDLE | LPUART_STAT_OR | LPUART_STAT_NF | \
+                                  LPUART_STAT_FE | LPUART_STAT_PF | LPUART_STAT_MA1F | LPUART_STAT_MA2F)
+#define SL_CR_SBUS_UART_STAT_CLEAR(port, flag) ((port)->STAT = ((port)->STAT & ~SL_CR_SBUS_UART_STAT_W1C) | (flag))
+#endif
+
+/* State for one SBUS receiver */
+typedef struct
+{
+  /* Decoder, owned by the UART interrupt (or sbus task if polling) */
+  sl_cr_sbus_decoder_c                    decoder;
+  /* Frames published by decoder */
+  sl_cr_seqlock_c<sl_cr_sbus_raw_frame_s> rx_frames;
+
+  /* Remaining state owned by sbus task */
+  /* Latest processed frame and its decoder sequence number */
+  sl_cr_sbus_raw_frame_s                  frame;
+  uint32_t                                rx_sequence;
+  /* Time of last update (ms) */
+  time_ms_t                               read_time;
+  bool                                    stale;
+  /* Detected frame period (us) */
+  sl_cr_time_us_t                         frame_period;
+  unsigned int                            frame_period_mismatches;
+  /* Link statistics */
+  sl_cr_sbus_stats_s                      stats;
+  sl_cr_seqlock_c<sl_cr_sbus_stats_s>     stats_published;
+} sl_cr_sbus_receiver_s;
+
+sl_cr_sbus_receiver_s sbus_receivers[SL_CR_SBUS_RECEIVER_COUNT];
+/* Task to wake on new frames */
+TaskHandle_t *sbus_task_handle_ptr = nullptr;
+
+/* Frames published to consumers, written only by sbus task */
+sl_cr_seqlock_c<sl_cr_sbus_frame_s> sbus_frames;
+/* Latest consumer frame */
+sl_cr_sbus_frame_s sbus_frame;
+/* Frame period of receiver supplying RC input (us) */
+volatile sl_cr_time_us_t sbus_frame_period = SL_CR_SBUS_UPDATE_PERIOD*1000;
+
+/* Feeds one byte to decoder and publishes completed frames, returns true if a frame was completed */
+inline bool sl_cr_sbus_decode_byte(sl_cr_sbus_receiver_s *receiver, uint8_t byte, sl_cr_time_us_t rx_time)
+{
+  const bool new_frame = receiver->decoder.decode(byte, rx_time);
+
+  if(new_frame)
+  {
+    receiver->rx_frames.write(*receiver->decoder.get_frame());
+#ifdef _SBUS_RECORD_
+    sl_cr_sbus_record_frame(receiver - sbus_receivers, receiver->decoder.get_raw_frame(), rx_time);
+#endif
+  }
+
+  return new_frame;
+}
+
+/* Drops partial frame due to line error */
+inline void sl_cr_sbus_decode_error(sl_cr_sbus_receiver_s *receiver, sl_cr_time_us_t rx_time)
+{
+  receiver->decoder.error();
+#ifdef _SBUS_RECORD_
+  sl_cr_sbus_record_error(receiver - sbus_receivers, rx_time);
+#endif
+}
+
+#ifdef SL_CR_SBUS_RX_INTERRUPT
+void sl_cr_sbus_uart_isr(sl_cr_sbus_receiver_s *receiver, IMXRT_LPUART_t *port)
+{
+  const sl_cr_time_us_t rx_time = micros();
+  bool new_frame = false;
+
+  /* Drain RX FIFO */
+  while(0 != ((port->WATER >> 24) & 0x7))
+  {
+    const uint32_t data = port->DATA;
+
+    if(data & (LPUART_DATA_PARITYE | LPUART_DATA_FRETSC))
+    {
+      sl_cr_sbus_decode_error(receiver, rx_time);
+    }
+    else if(sl_cr_sbus_decode_byte(receiver, (uint8_t) data, rx_time))
+    {
+      new_frame = true;
+    }
+  }
+
+  if(port->STAT & LPUART_STAT_OR)
+  {
+    /* Overrun, bytes lost */
+    SL_CR_SBUS_UART_STAT_CLEAR(port, LPUART_STAT_OR);
+    sl_cr_sbus_decode_error(receiver, rx_time);
+  }
+  if(port->STAT & LPUART_STAT_IDLE)
+  {
+    /* Line idle between frames, resynchronize */
+    SL_CR_SBUS_UART_STAT_CLEAR(port, LPUART_STAT_IDLE);
+    receiver->decoder.reset();
+  }
+
+  if(new_frame && sbus_task_handle_ptr && *sbus_task_handle_ptr)
+  {
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(*sbus_task_handle_ptr, &higher_priority_task_woken);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+  }
+}
+void sl_cr_sbus_uart_0_isr()
+{
+  sl_cr_sbus_uart_isr(&sbus_receivers[0], &SL_CR_SBUS_UART_0_PORT);
+}
+#if (SL_CR_SBUS_RECEIVER_COUNT > 1)
+void sl_cr_sbus_uart_1_isr()
+{
+  sl_cr_sbus_uart_isr(&sbus_receivers[1], &SL_CR_SBUS_UART_1_PORT);
+}
+#endif
+#else
+void sl_cr_sbus_poll_uarts()
+{
+  const sl_cr_time_us_t rx_time = micros();
+
+  while(SL_CR_SBUS_UART_0.available() > 0)
+  {
+    sl_cr_sbus_decode_byte(&sbus_receivers[0], (uint8_t) SL_CR_SBUS_UART_0.read(), rx_time);
+  }
+#if (SL_CR_SBUS_RECEIVER_COUNT > 1)
+  while(SL_CR_SBUS_UART_1.available() > 0)
+  {
+    sl_cr_sbus_decode_byte(&sbus_receivers[1], (uint8_t) SL_CR_SBUS_UART_1.read(), rx_time);
+  }
+#endif
+}
+#endif
+
+void sl_cr_sbus_inject(sl_cr_sbus_receiver_t receiver, const uint8_t *data, size_t length, sl_cr_time_us_t rx_time)
+{
+  if(receiver < SL_CR_SBUS_RECEIVER_COUNT)
+  {
+    for(size_t i = 0; i < length; i++)
+    {
+      sl_cr_sbus_decode_byte(&sbus_receivers[receiver], data[i], rx_time);
+    }
+  }
+}
+
+void sl_cr_sbus_publish_frame()
+{
+  sbus_frame.sequence = sbus_frames.get_sequence()+1;
+  sbus_frames.write(sbus_frame);
+}
+
+/* Updates detected frame period with interval between consecutive frames */
+void sl_cr_sbus_update_frame_period(sl_cr_sbus_receiver_s *receiver, sl_cr_time_us_t interval)
+{
+  const sl_cr_time_us_t estimate  = receiver->frame_period;
+  const sl_cr_time_us_t tolerance = estimate / SL_CR_SBUS_PERIOD_TOLERANCE;
+  const sl_cr_time_diff_us_t error = (sl_cr_time_diff_us_t)(interval - estimate);
+
+  if(interval < SL_CR_SBUS_MIN_PERIOD || interval > SL_CR_SBUS_MAX_PERIOD)
+  {
+    /* Not a plausible frame rate (e.g. link dropout) */
+  }
+  else if((error <= (sl_cr_time_diff_us_t) tolerance) && (error >= -((sl_cr_time_diff_us_t) tolerance)))
+  {
+    receiver->frame_period = estimate + (error / SL_CR_SBUS_PERIOD_FILTER);
+    receiver->frame_period_mismatches = 0;
+  }
+  else if(++receiver->frame_period_mismatches >= SL_CR_SBUS_PERIOD_RESEED_COUNT)
+  {
+    /* Rate changed */
+    receiver->frame_period = interval;
+    receiver->frame_period_mismatches = 0;
+  }
+}
+
+void sl_cr_sbus_update_stats(sl_cr_sbus_receiver_s *receiver, const sl_cr_sbus_raw_frame_s *frame, uint32_t rx_sequence)
+{
+  sl_cr_sbus_stats_s *stats = &receiver->stats;
+
+  /* Interval is only meaningful after first frame */
+  if(stats->frames > 0)
+  {
+    const sl_cr_time_us_t interval = frame->rx_time - receiver->frame.rx_time;
+    unsigned int bin = interval / SL_CR_SBUS_STATS_HISTOGRAM_BIN_WIDTH;
+
+    bin = (bin < SL_CR_SBUS_STATS_HISTOGRAM_BINS)?bin:(SL_CR_SBUS_STATS_HISTOGRAM_BINS-1);
+    stats->interval_histogram[bin]++;
+    stats->longest_gap = (interval > stats->longest_gap)?interval:stats->longest_gap;
+    stats->skipped_frames += (rx_sequence - receiver->rx_sequence) - 1;
+
+    if(1 == (rx_sequence - receiver->rx_sequence))
+    {
+      sl_cr_sbus_update_frame_period(receiver, interval);
+    }
+  }
+
+  stats->frames++;
+  stats->lost_frame_flags += frame->lost_frame?1:0;
+  stats->failsafe_flags   += frame->failsafe?1:0;
+  stats->decode_errors     = receiver->decoder.get_error_count();
+  stats->frame_period      = receiver->frame_period;
+}
+
+void sl_cr_sbus_init(TaskHandle_t *sbus_task_handle)
 {
   set_failsafe_mask(combat::FAILSAFE_SBUS_STALE);
-  last_sbus_read_time = millis();
-  sbus_rx.Begin();
+  sbus_frame       = {};
+  sbus_frame.stale = true;
+  sl_cr_sbus_publish_frame();
+  sbus_task_handle_ptr = sbus_task_handle;
+
+  for(unsigned int i = 0; i < SL_CR_SBUS_RECEIVER_COUNT; i++)
+  {
+    sbus_receivers[i].frame       = {};
+    sbus_receivers[i].rx_sequence = 0;
+    sbus_receivers[i].read_time   = millis();
+    sbus_receivers[i].stale       = true;
+    sbus_receivers[i].frame_period            = SL_CR_SBUS_UPDATE_PERIOD*1000;
+    sbus_receivers[i].frame_period_mismatches = 0;
+    sbus_receivers[i].stats       = {};
+  }
+
+  SL_CR_SBUS_UART_0.begin(SL_CR_SBUS_BAUD, SL_CR_SBUS_UART_MODE);
+#if (SL_CR_SBUS_RECEIVER_COUNT > 1)
+  SL_CR_SBUS_UART_1.begin(SL_CR_SBUS_BAUD, SL_CR_SBUS_UART_MODE);
+#endif
+#ifdef SL_CR_SBUS_RX_INTERRUPT
+  /* Take over UART interrupts from the core serial driver (RX only, SBUS is never transmitted) */
+  attachInterruptVector(SL_CR_SBUS_UART_0_IRQ, sl_cr_sbus_uart_0_isr);
+  NVIC_SET_PRIORITY(SL_CR_SBUS_UART_0_IRQ, SL_CR_SBUS_UART_IRQ_PRIORITY);
+#if (SL_CR_SBUS_RECEIVER_COUNT > 1)
+  attachInterruptVector(SL_CR_SBUS_UART_1_IRQ, sl_cr_sbus_uart_1_isr);
+  NVIC_SET_PRIORITY(SL_CR_SBUS_UART_1_IRQ, SL_CR_SBUS_UART_IRQ_PRIORITY);
+#endif
+#endif
 }
 
-void sl_cr_sbus_loop()
+/* Processes new frame or stale timeout for one receiver.  Returns true if receiver has a new frame */
+bool sl_cr_sbus_receiver_loop(sl_cr_sbus_receiver_s *receiver, time_ms_t loop_time)
+{
+  bool new_frame = false;
+  sl_cr_sbus_raw_frame_s frame;
+
+  const uint32_t sequence = receiver->rx_frames.read(&frame);
+  if(sequence != receiver->rx_sequence)
+  {
+    sl_cr_sbus_update_stats(receiver, &frame, sequence);
+    receiver->rx_sequence = sequence;
+    receiver->frame       = frame;
+    receiver->read_time   = loop_time;
+    receiver->stale       = false;
+    new_frame             = true;
+    receiver->stats_published.write(receiver->stats);
+  }
+  else if(!receiver->stale &&
+          (loop_time - receiver->read_time) > ((SL_CR_SBUS_STALE_TIMEOUT_PERIODS*receiver->frame_period)/1000))
+  {
+    receiver->stale = true;
+    receiver->stats.stale_events++;
+    receiver->stats_published.write(receiver->stats);
+  }
+
+  return new_frame;
+}
+
+/* Selects receiver with freshest frame, preferring frames without receiver failsafe.  Returns receiver count if all are stale */
+sl_cr_sbus_receiver_t sl_cr_sbus_select_receiver()
+{
+  sl_cr_sbus_receiver_t selected = SL_CR_SBUS_RECEIVER_COUNT;
+
+  for(sl_cr_sbus_receiver_t i = 0; i < SL_CR_SBUS_RECEIVER_COUNT; i++)
+  {
+    const sl_cr_sbus_receiver_s *candidate = &sbus_receivers[i];
+
+    if(candidate->stale)
+    {
+      continue;
+    }
+
+    if(selected >= SL_CR_SBUS_RECEIVER_COUNT)
+    {
+      selected = i;
+    }
+    else
+    {
+      const sl_cr_sbus_receiver_s *current = &sbus_receivers[selected];
+
+      if((current->frame.failsafe && !candidate->frame.failsafe) ||
+         ((current->frame.failsafe == candidate->frame.failsafe) &&
+          ((sl_cr_time_diff_us_t)(candidate->frame.rx_time - current->frame.rx_time) > 0)))
+      {
+        selected = i;
+      }
+    }
+  }
+
+  return selected;
+}
+
+bool sl_cr_sbus_loop()
 {
   time_ms_t loop_time = millis();
+  bool new_frame = false;
+  bool frame_published = false;
+
+#ifndef SL_CR_SBUS_RX_INTERRUPT
+  sl_cr_sbus_poll_uarts();
+#endif
 
-  if (sbus_rx.Read()) {
-    /* Grab the received data */
-    sbus_data = sbus_rx.ch();
-    /* Set failsafes */
-    set_failsafe_mask_value(combat::FAILSAFE_SBUS, sbus_rx.failsafe());
-    /* Clear stale data failsafe */
-    last_sbus_read_time = loop_time;
-    clear_failsafe_mask(combat::FAILSAFE_SBUS_STALE);
+  for(unsigned int i = 0; i < SL_CR_SBUS_RECEIVER_COUNT; i++)
+  {
+    new_frame |= sl_cr_sbus_receiver_loop(&sbus_receivers[i], loop_time);
   }
-  else
+
+  const sl_cr_sbus_receiver_t selected = sl_cr_sbus_select_receiver();
+  if(selected < SL_CR_SBUS_RECEIVER_COUNT)
   {
-    if((loop_time - last_sbus_read_time) > SL_CR_SBUS_STALE_TIMEOUT)
+    sl_cr_sbus_receiver_s *receiver = &sbus_receivers[selected];
+
+    /* Only publish if selection is a frame not yet published */
+    if(new_frame &&
+       (sbus_frame.stale ||
+        selected != sbus_frame.receiver ||
+        receiver->frame.rx_time != sbus_frame.rx_time))
     {
-      set_failsafe_mask(combat::FAILSAFE_SBUS_STALE);
+      /* Grab the received data */
+      for(unsigned int i = 0; i < SL_CR_SBUS_NUM_CH; i++)
+      {
+        sbus_frame.ch[i] = receiver->frame.ch[i];
+      }
+      sbus_frame.rx_time    = receiver->frame.rx_time;
+      sbus_frame.failsafe   = receiver->frame.failsafe;
+      sbus_frame.lost_frame = receiver->frame.lost_frame;
+      sbus_frame.receiver   = selected;
+      sbus_frame.stale      = false;
+      sl_cr_sbus_publish_frame();
+#ifdef _BLACKBOX_
+      /* Before failsafes below, so a frame causing failsafe is recorded ahead of its trigger */
+      sl_cr_blackbox_record_rc(&sbus_frame);
+#endif
+      sbus_frame_period     = receiver->frame_period;
+      frame_published = true;
+      receiver->stats.used_frames++;
+      receiver->stats_published.write(receiver->stats);
+
+      /* Set failsafes */
+      set_failsafe_mask_value(combat::FAILSAFE_SBUS, sbus_frame.failsafe);
+      /* Clear stale data failsafe */
+      clear_failsafe_mask(combat::FAILSAFE_SBUS_STALE);
     }
   }
+  else if(!sbus_frame.stale)
+  {
+    /* All receivers stale, publish stale state so consumers react without waiting for a new frame */
+    sbus_frame.stale   = true;
+    sbus_frame.rx_time = micros();
+    sl_cr_sbus_publish_frame();
+#ifdef _BLACKBOX_
+    sl_cr_blackbox_record_rc(&sbus_frame);
+#endif
+    frame_published = true;
+    set_failsafe_mask(combat::FAILSAFE_SBUS_STALE);
+  }
 
+  return frame_published;
 }
 
-sl_cr_rc_channel_value_t sl_cr_sbus_get_ch_value(sl_cr_rc_channel_t channel)
+sl_cr_time_us_t sl_cr_sbus_get_frame_period()
+{
+  return sbus_frame_period;
+}
+
+TickType_t sl_cr_sbus_get_frame_period_ticks()
+{
+  /* Round down so a task using this period never falls behind the frame rate */
+  const TickType_t ticks = pdMS_TO_TICKS(sbus_frame_period/1000);
+
+  return (ticks > 0)?ticks:1;
+}
+
+uint32_t sl_cr_sbus_get_frame(sl_cr_sbus_frame_s *frame)
+{
+  sbus_frames.read(frame);
+
+  return frame->sequence;
+}
+
+sl_cr_rc_channel_value_t sl_cr_sbus_get_frame_ch_value(const sl_cr_sbus_frame_s *frame, sl_cr_rc_channel_t channel)
 {
   sl_cr_rc_channel_value_t value = SL_CR_RC_CH_INVALID_VALUE;
 
-  if(!get_failsafe_set(combat::FAILSAFE_SBUS_STALE) &&
-     SL_CR_CH_TO_ARRAY_INDEX(channel) < bfs::SbusRx::NUM_CH())
+  if(!frame->stale &&
+     SL_CR_CH_TO_ARRAY_INDEX(channel) < SL_CR_SBUS_NUM_CH)
   {
-    value = sbus_data[SL_CR_CH_TO_ARRAY_INDEX(channel)];
+    value = frame->ch[SL_CR_CH_TO_ARRAY_INDEX(channel)];
   }
 
   return value;
-}
\ No newline at end of file
+}
+
+sl_cr_rc_channel_value_t sl_cr_sbus_get_ch_value(sl_cr_rc_channel_t channel)
+{
+  sl_cr_sbus_frame_s frame;
+
+  sl_cr_sbus_get_frame(&frame);
+
+  return sl_cr_sbus_get_frame_ch_value(&frame, channel);
+}
+
+void sl_cr_sbus_get_stats(sl_cr_sbus_receiver_t receiver, sl_cr_sbus_stats_s *stats)
+{
+  if(receiver < SL_CR_SBUS_RECEIVER_COUNT)
+  {
+    sbus_receivers[receiver].stats_published.read(stats);
+  }
+  else
+  {
+    *stats = {};
+  }
+}
+
+void sl_cr_sbus_log_stats(log_key_e log_key)
+{
+  static_assert(16 == SL_CR_SBUS_STATS_HISTOGRAM_BINS, "Histogram log format expects 16 bins");
+  sl_cr_sbus_stats_s stats;
+
+  for(sl_cr_sbus_receiver_t i = 0; i < SL_CR_SBUS_RECEIVER_COUNT; i++)
+  {
+    sl_cr_sbus_get_stats(i, &stats);
+
+    log_snprintf(log_key, LOG_LEVEL_INFO,
+      "SBUS%u frames: %u period: %uus used: %u skipped: %u decode errors: %u lost frame flags: %u failsafe flags: %u stale events: %u longest gap: %uus",
+      i, stats.frames, (unsigned int) stats.frame_period, stats.used_frames, stats.skipped_frames, stats.decode_errors, stats.lost_frame_flags,
+      stats.failsafe_flags, stats.stale_events, (unsigned int) stats.longest_gap);
+    log_snprintf(log_key, LOG_LEVEL_INFO,
+      "SBUS%u interval histogram (%ums bins): %u %u %u %u %u %u %u %u %u %u %u %u %u %u %u %u",
+      i, SL_CR_SBUS_STATS_HISTOGRAM_BIN_WIDTH/1000,
+      stats.interval_histogram[0],  stats.interval_histogram[1],  stats.interval_histogram[2],  stats.interval_histogram[3],
+      stats.interval_histogram[4],  stats.interval_histogram[5],  stats.interval_histogram[6],  stats.interval_histogram[7],
+      stats.interval_histogram[8],  stats.interval_histogram[9],  stats.interval_histogram[10], stats.interval_histogram[11],
+      stats.interval_histogram[12], stats.interval_histogram[13], stats.interval_histogram[14], stats.interval_histogram[15]);
+  }
+}
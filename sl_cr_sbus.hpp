@@ -8,14 +8,102 @@
 #ifndef __SL_CR_SBUS_HPP__
 #define __SL_CR_SBUS_HPP__
 
+#include <arduino_freertos.h>
+
+#include "sl_robot_log.hpp"
+
+#include "sl_cr_sbus_decoder.hpp"
 #include "sl_cr_types.hpp"
 
-/* Nominal period between SBUS packets (ms) */
+/* Nominal period between SBUS packets (ms), used until actual period is detected */
 #define SL_CR_SBUS_UPDATE_PERIOD 14
+/* Range of plausible SBUS frame periods (us) */
+#define SL_CR_SBUS_MIN_PERIOD 3000
+#define SL_CR_SBUS_MAX_PERIOD 30000
+
+/* Number of SBUS receivers merged into one RC input */
+#ifdef _DUAL_SBUS_RECEIVER_
+#define SL_CR_SBUS_RECEIVER_COUNT 2
+#else
+#define SL_CR_SBUS_RECEIVER_COUNT 1
+#endif
+/* SBUS receiver index, starts from 0 */
+typedef unsigned int sl_cr_sbus_receiver_t;
+
+/* Sequence number never used by a published frame */
+#define SL_CR_SBUS_SEQUENCE_INVALID 0
+
+/* Consistent snapshot of all RC inputs from one SBUS frame */
+typedef struct
+{
+  /* Increments each time a frame (or a change in stale state) is published */
+  uint32_t                 sequence;
+  /* Time frame was received (us) */
+  sl_cr_time_us_t          rx_time;
+  /* Receiver that supplied frame */
+  sl_cr_sbus_receiver_t    receiver;
+  sl_cr_rc_channel_value_t ch[SL_CR_SBUS_NUM_CH];
+  /* Receiver reported failsafe */
+  bool                     failsafe;
+  /* Receiver reported lost frame */
+  bool                     lost_frame;
+  /* No frame received within stale timeout, channel values are not to be used */
+  bool                     stale;
+} sl_cr_sbus_frame_s;
 
-void sl_cr_sbus_init();
-void sl_cr_sbus_loop();
+/* Inter-frame interval histogram, last bin also counts all longer intervals */
+#define SL_CR_SBUS_STATS_HISTOGRAM_BINS      16
+#define SL_CR_SBUS_STATS_HISTOGRAM_BIN_WIDTH 2000 /* us */
 
+/* SBUS link quality statistics for one receiver since boot */
+typedef struct
+{
+  /* Frames processed */
+  unsigned int    frames;
+  /* Frames selected as RC input */
+  unsigned int    used_frames;
+  /* Frames decoded but superseded before processing */
+  unsigned int    skipped_frames;
+  /* Frames dropped by decoder (bad footer, parity, framing or overrun errors) */
+  unsigned int    decode_errors;
+  /* Frames with receiver lost frame flag set */
+  unsigned int    lost_frame_flags;
+  /* Frames with receiver failsafe flag set */
+  unsigned int    failsafe_flags;
+  /* Transitions into stale state */
+  unsigned int    stale_events;
+  /* Detected frame period (us) */
+  sl_cr_time_us_t frame_period;
+  /* Longest interval between processed frames (us) */
+  sl_cr_time_us_t longest_gap;
+  /* Interval between processed frames */
+  unsigned int    interval_histogram[SL_CR_SBUS_STATS_HISTOGRAM_BINS];
+} sl_cr_sbus_stats_s;
+
+/* Configures SBUS UART.  Task handle is notified when a new frame is received */
+void sl_cr_sbus_init(TaskHandle_t *sbus_task_handle);
+/* Processes newly received frame or checks for stale data.  Returns true if a new frame was published */
+bool sl_cr_sbus_loop();
+
+/* Feeds raw SBUS bytes received at rx_time (us) into a receiver's decoder, as if received by its UART.
+     For replay builds, must not be used while the UART is active */
+void sl_cr_sbus_inject(sl_cr_sbus_receiver_t receiver, const uint8_t *data, size_t length, sl_cr_time_us_t rx_time);
+
+/* Detected frame period of receiver supplying RC input (us) */
+sl_cr_time_us_t sl_cr_sbus_get_frame_period();
+/* Detected frame period in RTOS ticks (rounded down, at least 1), for tasks to run in lockstep with RC input */
+TickType_t sl_cr_sbus_get_frame_period_ticks();
+
+/* Copies latest RC frame (lock-free), returns its sequence number */
+uint32_t sl_cr_sbus_get_frame(sl_cr_sbus_frame_s *frame);
+/* Returns channel value from frame, or invalid value if frame is stale */
+sl_cr_rc_channel_value_t sl_cr_sbus_get_frame_ch_value(const sl_cr_sbus_frame_s *frame, sl_cr_rc_channel_t channel);
+/* Returns channel value from latest frame.  Use sl_cr_sbus_get_frame() when reading multiple channels */
 sl_cr_rc_channel_value_t sl_cr_sbus_get_ch_value(sl_cr_rc_channel_t channel);
 
-#endif /* __SL_CR_SBUS_HPP__ */
\ No newline at end of file
+/* Copies latest link statistics for a receiver (lock-free) */
+void sl_cr_sbus_get_stats(sl_cr_sbus_receiver_t receiver, sl_cr_sbus_stats_s *stats);
+/* Logs latest link statistics for all receivers.  Formatting happens in the caller's context, not the SBUS path */
+void sl_cr_sbus_log_stats(log_key_e log_key);
+
+#endif /* __SL_CR_SBUS_HPP__ */
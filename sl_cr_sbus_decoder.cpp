@@ -0,0 +1,99 @@
+/*
+  sl_cr_sbus_decoder.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#include <string.h>
+
+#include "sl_cr_sbus_decoder.hpp"
+
+/* Index of flags and footer bytes in frame */
+#define SL_CR_SBUS_FLAGS_INDEX  (SL_CR_SBUS_FRAME_SIZE-2)
+#define SL_CR_SBUS_FOOTER_INDEX (SL_CR_SBUS_FRAME_SIZE-1)
+
+sl_cr_sbus_decoder_c::sl_cr_sbus_decoder_c()
+{
+  working_frame = {};
+  frame         = {};
+  memset(raw_frame, 0, sizeof(raw_frame));
+  error_count   = 0;
+
+  reset();
+}
+
+void sl_cr_sbus_decoder_c::reset()
+{
+  byte_index = 0;
+  bit_buffer = 0;
+  bit_count  = 0;
+  ch_index   = 0;
+}
+
+void sl_cr_sbus_decoder_c::error()
+{
+  if(byte_index > 0)
+  {
+    error_count++;
+  }
+  reset();
+}
+
+bool sl_cr_sbus_decoder_c::decode(uint8_t byte, sl_cr_time_us_t rx_time)
+{
+  bool frame_complete = false;
+
+  if(byte_index < SL_CR_SBUS_FRAME_SIZE)
+  {
+    raw_frame[byte_index] = byte;
+  }
+
+  if(0 == byte_index)
+  {
+    /* Searching for header */
+    if(SL_CR_SBUS_HEADER == byte)
+    {
+      byte_index = 1;
+    }
+  }
+  else if(byte_index < SL_CR_SBUS_FLAGS_INDEX)
+  {
+    /* Channel data, unpack 11-bit channels LSB first */
+    bit_buffer |= ((uint32_t) byte) << bit_count;
+    bit_count  += 8;
+    if(bit_count >= SL_CR_SBUS_CH_BITS)
+    {
+      working_frame.ch[ch_index++] = bit_buffer & SL_CR_SBUS_CH_MASK;
+      bit_buffer >>= SL_CR_SBUS_CH_BITS;
+      bit_count   -= SL_CR_SBUS_CH_BITS;
+    }
+    byte_index++;
+  }
+  else if(SL_CR_SBUS_FLAGS_INDEX == byte_index)
+  {
+    working_frame.ch17       = (0 != (byte & SL_CR_SBUS_FLAG_CH17));
+    working_frame.ch18       = (0 != (byte & SL_CR_SBUS_FLAG_CH18));
+    working_frame.lost_frame = (0 != (byte & SL_CR_SBUS_FLAG_LOST_FRAME));
+    working_frame.failsafe   = (0 != (byte & SL_CR_SBUS_FLAG_FAILSAFE));
+    byte_index++;
+  }
+  else
+  {
+    /* Footer */
+    if(SL_CR_SBUS_FOOTER == byte ||
+       SL_CR_SBUS2_FOOTER == (byte & SL_CR_SBUS2_FOOTER_MASK))
+    {
+      working_frame.rx_time = rx_time;
+      frame                 = working_frame;
+      frame_complete        = true;
+      reset();
+    }
+    else
+    {
+      error();
+    }
+  }
+
+  return frame_complete;
+}
@@ -0,0 +1,83 @@
+/*
+  sl_cr_sbus_decoder.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_SBUS_DECODER_HPP__
+#define __SL_CR_SBUS_DECODER_HPP__
+
+#include <stdint.h>
+
+#include "sl_cr_types.hpp"
+
+/* SBUS frame layout */
+#define SL_CR_SBUS_FRAME_SIZE      25
+#define SL_CR_SBUS_HEADER          0x0F
+#define SL_CR_SBUS_FOOTER          0x00
+/* SBUS2 telemetry slot footers end in 0x4 */
+#define SL_CR_SBUS2_FOOTER_MASK    0x0F
+#define SL_CR_SBUS2_FOOTER         0x04
+#define SL_CR_SBUS_NUM_CH          16
+#define SL_CR_SBUS_CH_BITS         11
+#define SL_CR_SBUS_CH_MASK         ((1<<SL_CR_SBUS_CH_BITS)-1)
+/* Flags byte bits */
+#define SL_CR_SBUS_FLAG_CH17       (1<<0)
+#define SL_CR_SBUS_FLAG_CH18       (1<<1)
+#define SL_CR_SBUS_FLAG_LOST_FRAME (1<<2)
+#define SL_CR_SBUS_FLAG_FAILSAFE   (1<<3)
+
+/* One decoded SBUS frame */
+typedef struct
+{
+  uint16_t        ch[SL_CR_SBUS_NUM_CH];
+  bool            ch17;
+  bool            ch18;
+  bool            lost_frame;
+  bool            failsafe;
+  /* Time last byte of the frame was received (us) */
+  sl_cr_time_us_t rx_time;
+} sl_cr_sbus_raw_frame_s;
+
+/* Byte-stream SBUS decoder.  Safe to run from interrupt context (no locks, no allocation).
+     Channels are unpacked as bytes arrive, so completing a frame costs only the footer check. */
+class sl_cr_sbus_decoder_c
+{
+  private:
+    /* Index of next expected byte in frame, 0 while searching for header */
+    unsigned int           byte_index;
+    /* Partially unpacked channel bits */
+    uint32_t               bit_buffer;
+    unsigned int           bit_count;
+    unsigned int           ch_index;
+
+    /* Frame being decoded */
+    sl_cr_sbus_raw_frame_s working_frame;
+    uint8_t                raw_frame[SL_CR_SBUS_FRAME_SIZE];
+    /* Last valid frame */
+    sl_cr_sbus_raw_frame_s frame;
+
+    /* Count of frames dropped due to bad footer or line errors */
+    unsigned int           error_count;
+
+  public:
+    sl_cr_sbus_decoder_c();
+
+    /* Drops any partial frame and searches for the next header (e.g. on line idle or UART error) */
+    void reset();
+    /* Drops any partial frame and counts an error */
+    void error();
+
+    /* Decodes one received byte, returns true if a valid frame was just completed */
+    bool decode(uint8_t byte, sl_cr_time_us_t rx_time);
+
+    /* Last valid frame */
+    inline const sl_cr_sbus_raw_frame_s *get_frame() const {return &frame;}
+    /* Raw bytes of last valid frame, only valid until next call to decode() */
+    inline const uint8_t *get_raw_frame() const {return raw_frame;}
+    /* Count of dropped frames */
+    inline unsigned int get_error_count() const {return error_count;}
+};
+
+#endif /* __SL_CR_SBUS_DECODER_HPP__ */
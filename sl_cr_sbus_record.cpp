@@ -0,0 +1,166 @@
+/*
+  sl_cr_sbus_record.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#include <string.h>
+
+#include "sl_cr_ring_buffer.hpp"
+#include "sl_cr_sbus_record.hpp"
+
+/* Records buffered between flushes (~0.9s at 14ms frames) */
+#define SL_CR_SBUS_RECORD_BUFFER_SIZE 64
+
+sl_cr_ring_buffer_c<sl_cr_sbus_record_s, SL_CR_SBUS_RECORD_BUFFER_SIZE> sbus_record_buffer;
+
+/* Flush state, owned by flushing task */
+bool                sbus_record_header_written = false;
+uint32_t            sbus_record_dropped_reported = 0;
+sl_cr_time_us_t     sbus_record_last_rx_time = 0;
+/* Record partially accepted by sink */
+uint8_t             sbus_record_pending[sizeof(sl_cr_sbus_record_s)];
+size_t              sbus_record_pending_length = 0;
+size_t              sbus_record_pending_offset = 0;
+
+const sl_cr_sbus_record_header_s sbus_record_header =
+{
+  .magic       = SL_CR_SBUS_RECORD_MAGIC,
+  .version     = SL_CR_SBUS_RECORD_VERSION,
+  .record_size = sizeof(sl_cr_sbus_record_s),
+};
+
+void sl_cr_sbus_record_frame(unsigned int receiver, const uint8_t *raw_frame, sl_cr_time_us_t rx_time)
+{
+  sl_cr_sbus_record_s record;
+
+  record.rx_time  = rx_time;
+  record.type     = SL_CR_SBUS_RECORD_FRAME;
+  record.receiver = receiver;
+  memcpy(record.data, raw_frame, SL_CR_SBUS_FRAME_SIZE);
+
+  sbus_record_buffer.push(record);
+}
+
+void sl_cr_sbus_record_error(unsigned int receiver, sl_cr_time_us_t rx_time)
+{
+  sl_cr_sbus_record_s record = {};
+
+  record.rx_time  = rx_time;
+  record.type     = SL_CR_SBUS_RECORD_ERROR;
+  record.receiver = receiver;
+
+  sbus_record_buffer.push(record);
+}
+
+/* Writes pending bytes, returns true once all are accepted */
+bool sl_cr_sbus_record_write_pending(sl_cr_sbus_record_write_f write, void *user_data)
+{
+  while(sbus_record_pending_offset < sbus_record_pending_length)
+  {
+    const size_t written = write(&sbus_record_pending[sbus_record_pending_offset],
+                                 sbus_record_pending_length - sbus_record_pending_offset,
+                                 user_data);
+    if(0 == written)
+    {
+      break;
+    }
+    sbus_record_pending_offset += written;
+  }
+
+  return (sbus_record_pending_offset >= sbus_record_pending_length);
+}
+
+void sl_cr_sbus_record_set_pending(const void *data, size_t length)
+{
+  memcpy(sbus_record_pending, data, length);
+  sbus_record_pending_length = length;
+  sbus_record_pending_offset = 0;
+}
+
+void sl_cr_sbus_record_flush(sl_cr_sbus_record_write_f write, void *user_data)
+{
+  static_assert(sizeof(sl_cr_sbus_record_header_s) <= sizeof(sbus_record_pending), "Header must fit in pending buffer");
+  sl_cr_sbus_record_s record;
+
+  if(!sbus_record_header_written)
+  {
+    sl_cr_sbus_record_set_pending(&sbus_record_header, sizeof(sbus_record_header));
+    sbus_record_header_written = true;
+  }
+
+  while(sl_cr_sbus_record_write_pending(write, user_data))
+  {
+    const uint32_t dropped = sbus_record_buffer.get_dropped();
+
+    if(sbus_record_buffer.pop(&record))
+    {
+      /* Next buffered record */
+    }
+    else if(dropped != sbus_record_dropped_reported)
+    {
+      /* Buffer drained, mark gap in recording where it overflowed */
+      const uint32_t count = dropped - sbus_record_dropped_reported;
+      record         = {};
+      record.rx_time = sbus_record_last_rx_time;
+      record.type    = SL_CR_SBUS_RECORD_OVERFLOW;
+      record.data[0] = (count > UINT8_MAX)?UINT8_MAX:count;
+      sbus_record_dropped_reported = dropped;
+    }
+    else
+    {
+      break;
+    }
+
+    sbus_record_last_rx_time = record.rx_time;
+
+    sl_cr_sbus_record_set_pending(&record, sizeof(record));
+  }
+}
+
+sl_cr_sbus_replay_c::sl_cr_sbus_replay_c(const uint8_t *data, size_t size)
+{
+  sl_cr_sbus_record_header_s header;
+
+  this->data        = data;
+  this->size        = size;
+  this->record_size = 0;
+
+  if(size >= sizeof(header))
+  {
+    memcpy(&header, data, sizeof(header));
+    if(SL_CR_SBUS_RECORD_MAGIC == header.magic &&
+       SL_CR_SBUS_RECORD_VERSION == header.version &&
+       header.record_size >= sizeof(sl_cr_sbus_record_s))
+    {
+      record_size = header.record_size;
+    }
+  }
+
+  rewind();
+}
+
+bool sl_cr_sbus_replay_c::valid() const
+{
+  return (record_size > 0);
+}
+
+bool sl_cr_sbus_replay_c::next(sl_cr_sbus_record_s *record)
+{
+  bool ret_val = false;
+
+  if(valid() && (offset + record_size) <= size)
+  {
+    memcpy(record, &data[offset], sizeof(sl_cr_sbus_record_s));
+    offset += record_size;
+    ret_val = true;
+  }
+
+  return ret_val;
+}
+
+void sl_cr_sbus_replay_c::rewind()
+{
+  offset = sizeof(sl_cr_sbus_record_header_s);
+}
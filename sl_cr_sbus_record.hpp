@@ -0,0 +1,84 @@
+/*
+  sl_cr_sbus_record.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_SBUS_RECORD_HPP__
+#define __SL_CR_SBUS_RECORD_HPP__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sl_cr_sbus_decoder.hpp"
+#include "sl_cr_types.hpp"
+
+/* SBUS recording format (little-endian):
+     sl_cr_sbus_record_header_s, followed by back-to-back sl_cr_sbus_record_s until end of file.
+   Replay feeds each record's raw bytes into sl_cr_sbus_inject() for the recorded receiver at the recorded time, so on a host build
+     with a simulated millis()/micros() the full sl_cr_sbus_loop -> failsafe_armswitch_loop -> drive strategy -> control loop
+     chain can be run faster than real time. */
+#define SL_CR_SBUS_RECORD_MAGIC   0x42534C53 /* "SLSB" */
+#define SL_CR_SBUS_RECORD_VERSION 2
+
+typedef struct __attribute__((packed))
+{
+  uint32_t magic;
+  uint16_t version;
+  /* Size of each record in bytes */
+  uint16_t record_size;
+} sl_cr_sbus_record_header_s;
+
+typedef enum
+{
+  /* Complete raw SBUS frame */
+  SL_CR_SBUS_RECORD_FRAME,
+  /* Decoder dropped a partial frame (line error or bad footer).  No data */
+  SL_CR_SBUS_RECORD_ERROR,
+  /* Recorder ring overflowed, records were lost after the previous record.  data[0] holds count (saturated) */
+  SL_CR_SBUS_RECORD_OVERFLOW,
+} sl_cr_sbus_record_type_e;
+
+typedef struct __attribute__((packed))
+{
+  /* Receive timestamp (us) */
+  uint32_t rx_time;
+  /* sl_cr_sbus_record_type_e */
+  uint8_t  type;
+  /* Receiver index */
+  uint8_t  receiver;
+  uint8_t  data[SL_CR_SBUS_FRAME_SIZE];
+} sl_cr_sbus_record_s;
+
+/* Sink for recorded bytes, returns number of bytes accepted (may be less than length if sink is full) */
+typedef size_t (*sl_cr_sbus_record_write_f)(const uint8_t *data, size_t length, void *user_data);
+
+/* Queues a frame for recording.  Interrupt safe */
+void sl_cr_sbus_record_frame(unsigned int receiver, const uint8_t *raw_frame, sl_cr_time_us_t rx_time);
+/* Queues a decoder error for recording.  Interrupt safe */
+void sl_cr_sbus_record_error(unsigned int receiver, sl_cr_time_us_t rx_time);
+/* Writes queued records to sink (header first).  Call from a low priority task */
+void sl_cr_sbus_record_flush(sl_cr_sbus_record_write_f write, void *user_data);
+
+/* Iterates records of an in-memory recording */
+class sl_cr_sbus_replay_c
+{
+  private:
+    const uint8_t *data;
+    size_t         size;
+    size_t         offset;
+    size_t         record_size;
+
+  public:
+    sl_cr_sbus_replay_c(const uint8_t *data, size_t size);
+
+    /* Header was recognized */
+    bool valid() const;
+    /* Copies next record, returns false at end of recording */
+    bool next(sl_cr_sbus_record_s *record);
+    /* Restarts from first record */
+    void rewind();
+};
+
+#endif /* __SL_CR_SBUS_RECORD_HPP__ */
@@ -0,0 +1,59 @@
+/*
+  sl_cr_seqlock.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_SEQLOCK_HPP__
+#define __SL_CR_SEQLOCK_HPP__
+
+#include <atomic>
+#include <stdint.h>
+
+/* Double-buffered sequence lock.
+     A single writer (may be an ISR) publishes into the inactive buffer and then advances the sequence.
+     Readers never block the writer; they copy the active buffer and retry only if a publish completed mid-copy. */
+template <typename data_t>
+class sl_cr_seqlock_c
+{
+  private:
+    data_t                buffer[2];
+    std::atomic<uint32_t> sequence;
+
+  public:
+    sl_cr_seqlock_c() : buffer(), sequence(0) {}
+
+    /* Publishes new data.  Must only be called from a single writer context */
+    void write(const data_t &data)
+    {
+      const uint32_t next_sequence = sequence.load(std::memory_order_relaxed) + 1;
+      buffer[next_sequence & 1] = data;
+      sequence.store(next_sequence, std::memory_order_release);
+    }
+
+    /* Copies latest published data, returns sequence number of the copy (0 if nothing published yet) */
+    uint32_t read(data_t *data) const
+    {
+      uint32_t start_sequence;
+      uint32_t end_sequence;
+
+      do
+      {
+        start_sequence = sequence.load(std::memory_order_acquire);
+        *data = buffer[start_sequence & 1];
+        std::atomic_thread_fence(std::memory_order_acquire);
+        end_sequence = sequence.load(std::memory_order_relaxed);
+      } while(start_sequence != end_sequence);
+
+      return start_sequence;
+    }
+
+    /* Returns sequence number of latest published data */
+    uint32_t get_sequence() const
+    {
+      return sequence.load(std::memory_order_acquire);
+    }
+};
+
+#endif /* __SL_CR_SEQLOCK_HPP__ */
@@ -0,0 +1,44 @@
+/*
+  sl_cr_static_slot.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_STATIC_SLOT_HPP__
+#define __SL_CR_STATIC_SLOT_HPP__
+
+#include <new>
+#include <stdint.h>
+#include <utility>
+
+/* Statically sized storage for one object, constructed in place at init instead of on the heap.
+     Objects are never destroyed, so the slot may be constructed at most once */
+template <typename T>
+class sl_cr_static_slot_c
+{
+  private:
+    alignas(T) uint8_t storage[sizeof(T)];
+    T                 *object = nullptr;
+
+  public:
+    /* Constructs object in slot, returns nullptr if already constructed */
+    template <typename... args_t>
+    T *construct(args_t&&... args)
+    {
+      T *ret_val = nullptr;
+
+      if(nullptr == object)
+      {
+        object  = new (storage) T(std::forward<args_t>(args)...);
+        ret_val = object;
+      }
+
+      return ret_val;
+    }
+
+    /* Constructed object, nullptr if not yet constructed */
+    inline T *get() const {return object;}
+};
+
+#endif /* __SL_CR_STATIC_SLOT_HPP__ */
@@ -0,0 +1,124 @@
+/*
+  sl_cr_telemetry.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#include <Arduino.h>
+#include <string.h>
+
+#include "sl_cr_config.h"
+#include "sl_cr_failsafe.hpp"
+#include "sl_cr_ring_buffer.hpp"
+#include "sl_cr_sbus.hpp"
+#include "sl_cr_telemetry.hpp"
+
+using namespace sandor_laboratories::robot;
+
+/* Frames buffered between flushes (~32ms at 1kHz) */
+#define SL_CR_TELEMETRY_BUFFER_SIZE 32
+
+sl_cr_ring_buffer_c<sl_cr_telemetry_frame_s, SL_CR_TELEMETRY_BUFFER_SIZE> telemetry_buffer;
+
+/* Sample state, owned by control loop */
+uint32_t     telemetry_sequence = 0;
+unsigned int telemetry_decimation = 0;
+
+/* Frame partially accepted by sink, owned by flushing task */
+sl_cr_telemetry_frame_s telemetry_pending;
+size_t                  telemetry_pending_length = 0;
+size_t                  telemetry_pending_offset = 0;
+
+static inline int16_t sl_cr_telemetry_saturate(int32_t value)
+{
+  return (value > INT16_MAX)?INT16_MAX:((value < INT16_MIN)?INT16_MIN:value);
+}
+
+/* CRC-16/CCITT-FALSE */
+static uint16_t sl_cr_telemetry_crc(const uint8_t *data, size_t length)
+{
+  uint16_t crc = 0xFFFF;
+
+  for(size_t i = 0; i < length; i++)
+  {
+    crc ^= ((uint16_t) data[i]) << 8;
+    for(unsigned int bit = 0; bit < 8; bit++)
+    {
+      crc = (crc & 0x8000)?((crc << 1) ^ 0x1021):(crc << 1);
+    }
+  }
+
+  return crc;
+}
+
+void sl_cr_telemetry_sample(const sl_cr_drive_data_s *drive_data)
+{
+  if(++telemetry_decimation >= SL_CR_TELEMETRY_DECIMATION)
+  {
+    sl_cr_telemetry_frame_s frame;
+    sl_cr_sbus_frame_s      rc_frame;
+
+    telemetry_decimation = 0;
+    sl_cr_sbus_get_frame(&rc_frame);
+
+    frame.header.sync          = SL_CR_TELEMETRY_SYNC;
+    frame.header.version       = SL_CR_TELEMETRY_VERSION;
+    frame.header.motor_count   = SL_CR_DRIVE_MOTOR_COUNT;
+    frame.header.channel_count = SL_CR_SBUS_NUM_CH;
+    frame.header.sequence      = telemetry_sequence++;
+    frame.header.time          = micros();
+    frame.header.failsafe_mask = combat::get_failsafe_mask();
+
+    for(unsigned int c = 0; c < SL_CR_SBUS_NUM_CH; c++)
+    {
+      /* Channels are numbered from 1 */
+      const sl_cr_rc_channel_value_t value = sl_cr_sbus_get_frame_ch_value(&rc_frame, c+1);
+      frame.ch[c] = SL_CR_RC_CH_VALUE_VALID(value)?sl_cr_telemetry_saturate(value):-1;
+    }
+
+    for(unsigned int m = 0; m < SL_CR_DRIVE_MOTOR_COUNT; m++)
+    {
+      const sl_cr_drive_motor_stack_c::control_loop_t * const control_loop = drive_data->motor_stack[m]->get_control_loop();
+
+      frame.motor[m].set_rpm       = sl_cr_telemetry_saturate(drive_data->motor_state.set_rpm[m]);
+      frame.motor[m].commanded_rpm = sl_cr_telemetry_saturate(drive_data->motor_state.commanded_rpm[m]);
+      frame.motor[m].real_rpm      = sl_cr_telemetry_saturate(drive_data->motor_state.real_rpm[m]);
+      frame.motor[m].error         = control_loop?sl_cr_telemetry_saturate(control_loop->get_error()):0;
+    }
+
+    /* CRC is added when flushed, keeping it out of the control loop */
+    telemetry_buffer.push(frame);
+  }
+}
+
+void sl_cr_telemetry_flush(sl_cr_telemetry_write_f write, void *user_data)
+{
+  bool sink_full = false;
+
+  while(!sink_full)
+  {
+    if(telemetry_pending_offset < telemetry_pending_length)
+    {
+      const size_t written = write(((const uint8_t *) &telemetry_pending) + telemetry_pending_offset,
+                                   telemetry_pending_length - telemetry_pending_offset, user_data);
+      telemetry_pending_offset += written;
+      sink_full = (0 == written);
+    }
+    else if(telemetry_buffer.pop(&telemetry_pending))
+    {
+      telemetry_pending.crc    = sl_cr_telemetry_crc((const uint8_t *) &telemetry_pending, offsetof(sl_cr_telemetry_frame_s, crc));
+      telemetry_pending_length = sizeof(telemetry_pending);
+      telemetry_pending_offset = 0;
+    }
+    else
+    {
+      break;
+    }
+  }
+}
+
+uint32_t sl_cr_telemetry_get_dropped()
+{
+  return telemetry_buffer.get_dropped();
+}
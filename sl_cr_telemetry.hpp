@@ -0,0 +1,72 @@
+/*
+  sl_cr_telemetry.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_CR_TELEMETRY_HPP__
+#define __SL_CR_TELEMETRY_HPP__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sl_cr_drive.hpp"
+#include "sl_cr_sbus_decoder.hpp"
+
+/* Telemetry stream format (little-endian), decoded by tools/sl_cr_telemetry_decode.cpp:
+     Back-to-back frames, one per control loop tick (or every SL_CR_TELEMETRY_DECIMATION ticks).  No stream header, so a host may
+     start reading at any point and resynchronizes on the sync word, validating with the CRC.
+   Frame:
+     sl_cr_telemetry_frame_header_s
+     int16_t  ch[channel_count]                      - RC channel values, -1 if stale
+     int16_t  set_rpm, commanded_rpm, real_rpm, error - per motor stack, motor_count times
+     uint16_t crc                                    - CRC-16/CCITT-FALSE of all preceding frame bytes, sync word included
+   Gaps in sequence are frames dropped because the host was not reading fast enough. */
+#define SL_CR_TELEMETRY_SYNC    0x4C54 /* "TL" */
+#define SL_CR_TELEMETRY_VERSION 1
+
+typedef struct __attribute__((packed))
+{
+  uint16_t sync;
+  uint8_t  version;
+  uint8_t  motor_count;
+  uint8_t  channel_count;
+  /* Frame counter, increments every control loop tick sampled (including dropped frames) */
+  uint32_t sequence;
+  /* Control loop tick time (us) */
+  uint32_t time;
+  uint32_t failsafe_mask;
+} sl_cr_telemetry_frame_header_s;
+
+typedef struct __attribute__((packed))
+{
+  int16_t set_rpm;
+  int16_t commanded_rpm;
+  int16_t real_rpm;
+  int16_t error;
+} sl_cr_telemetry_motor_s;
+
+typedef struct __attribute__((packed))
+{
+  sl_cr_telemetry_frame_header_s header;
+  int16_t                        ch[SL_CR_SBUS_NUM_CH];
+  sl_cr_telemetry_motor_s        motor[SL_CR_DRIVE_MOTOR_COUNT];
+  uint16_t                       crc;
+} sl_cr_telemetry_frame_s;
+
+/* Layout is fixed by host decoder */
+static_assert(17 == sizeof(sl_cr_telemetry_frame_header_s), "Telemetry frame header layout changed");
+static_assert(8  == sizeof(sl_cr_telemetry_motor_s),        "Telemetry motor layout changed");
+
+/* Sink for telemetry bytes, returns number of bytes accepted without blocking (may be less than length if sink is full) */
+typedef size_t (*sl_cr_telemetry_write_f)(const uint8_t *data, size_t length, void *user_data);
+
+/* Queues one frame of control loop state.  Call from control loop after motor state is updated, never blocks */
+void sl_cr_telemetry_sample(const sl_cr_drive_data_s *drive_data);
+/* Writes queued frames to sink.  Call from a low priority task */
+void sl_cr_telemetry_flush(sl_cr_telemetry_write_f write, void *user_data);
+/* Frames dropped because sink did not keep up */
+uint32_t sl_cr_telemetry_get_dropped();
+
+#endif /* __SL_CR_TELEMETRY_HPP__ */
@@ -12,6 +12,11 @@
 
 #include "sl_robot_types.hpp"
 
+/* Microsecond timestamp (wraps every ~71 minutes, compare by difference) */
+typedef uint32_t sl_cr_time_us_t;
+/* Signed difference between two microsecond timestamps */
+typedef int32_t  sl_cr_time_diff_us_t;
+
 /* RC Channel Index, starts from 1 */
 typedef unsigned int sl_cr_rc_channel_t;
 /* Invalid RC Channel Index */
@@ -23,6 +28,16 @@ typedef unsigned int sl_cr_rc_channel_t;
 #define SL_CR_ARCADE_DRIVE_THROTTLE_CH 3
 #define SL_CR_ARM_SWITCH_CH       5
 #define SL_CR_PREARM_SWITCH_CH    6
+#define SL_CR_DRIVE_STRATEGY_SWITCH_CH 7
+#define SL_CR_BLACKBOX_TRIGGER_CH 8
+
+/* Drive strategies selectable at runtime */
+typedef enum
+{
+  SL_CR_DRIVE_STRATEGY_ARCADE,
+  SL_CR_DRIVE_STRATEGY_TANK,
+  SL_CR_DRIVE_STRATEGY_COUNT,
+} sl_cr_drive_strategy_e;
 
 /* RC Channel Value */
 typedef unsigned int sl_cr_rc_channel_value_t;
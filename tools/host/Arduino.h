@@ -0,0 +1,163 @@
+/*
+  Arduino.h
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+/* Host stand-in for the parts of the Arduino core used by modules built into host tools (see tools/).
+     Time is simulated, a tool advances sl_cr_host_time_us itself so recordings replay faster than real time */
+
+#ifndef __SL_CR_HOST_ARDUINO_H__
+#define __SL_CR_HOST_ARDUINO_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define F_CPU_ACTUAL 600000000
+
+/* Simulated time (us) and cycle counter, advanced together */
+inline uint32_t          sl_cr_host_time_us = 0;
+inline volatile uint32_t sl_cr_host_cycles  = 0;
+#define ARM_DWT_CYCCNT sl_cr_host_cycles
+
+inline uint32_t micros() {return sl_cr_host_time_us;}
+inline uint32_t millis() {return sl_cr_host_time_us / 1000;}
+
+/* Set while a simulated interrupt (timer or pin) runs, so a tool can check which context calls it */
+inline bool sl_cr_host_in_isr = false;
+
+/* Periodic timer interrupt.  Fires from sl_cr_host_advance_us at each period boundary crossed, with time set to the boundary */
+#define SL_CR_HOST_TIMER_COUNT 4
+class IntervalTimer;
+inline IntervalTimer *sl_cr_host_timers[SL_CR_HOST_TIMER_COUNT] = {nullptr};
+
+class IntervalTimer
+{
+  public:
+    void     (*callback)() = nullptr;
+    uint32_t period_us     = 0;
+    /* Time of next tick (us) */
+    uint32_t next_us       = 0;
+
+    bool begin(void (*function)(), uint32_t us)
+    {
+      bool ret_val = false;
+
+      end();
+      for(unsigned int t = 0; (t < SL_CR_HOST_TIMER_COUNT) && !ret_val; t++)
+      {
+        if(nullptr == sl_cr_host_timers[t])
+        {
+          callback  = function;
+          period_us = us;
+          next_us   = sl_cr_host_time_us + us;
+          sl_cr_host_timers[t] = this;
+          ret_val   = true;
+        }
+      }
+
+      return ret_val;
+    }
+    void priority(uint8_t) {}
+    void end()
+    {
+      for(unsigned int t = 0; t < SL_CR_HOST_TIMER_COUNT; t++)
+      {
+        sl_cr_host_timers[t] = (this == sl_cr_host_timers[t])?nullptr:sl_cr_host_timers[t];
+      }
+    }
+};
+
+/* Advances simulated time, cycle counter wraps as on target.  Runs each timer tick due on the way, earliest first */
+inline void sl_cr_host_advance_us(uint32_t us)
+{
+  const uint32_t target = sl_cr_host_time_us + us;
+
+  for(;;)
+  {
+    IntervalTimer *due = nullptr;
+    for(unsigned int t = 0; t < SL_CR_HOST_TIMER_COUNT; t++)
+    {
+      IntervalTimer * const timer = sl_cr_host_timers[t];
+      if(timer && ((int32_t) (timer->next_us - target) <= 0) && (!due || ((int32_t) (timer->next_us - due->next_us) < 0)))
+      {
+        due = timer;
+      }
+    }
+    if(nullptr == due)
+    {
+      break;
+    }
+
+    sl_cr_host_cycles  += (due->next_us - sl_cr_host_time_us) * (F_CPU_ACTUAL / 1000000);
+    sl_cr_host_time_us  = due->next_us;
+    due->next_us       += due->period_us;
+    sl_cr_host_in_isr   = true;
+    due->callback();
+    sl_cr_host_in_isr   = false;
+  }
+
+  sl_cr_host_cycles  += (target - sl_cr_host_time_us) * (F_CPU_ACTUAL / 1000000);
+  sl_cr_host_time_us  = target;
+}
+/* Advances simulated time to t (us), never backwards */
+inline void sl_cr_host_advance_to_us(uint32_t t)
+{
+  if((int32_t) (t - sl_cr_host_time_us) > 0)
+  {
+    sl_cr_host_advance_us(t - sl_cr_host_time_us);
+  }
+}
+
+namespace arduino
+{
+  enum {INPUT = 0, OUTPUT = 1};
+  enum {CHANGE = 4};
+}
+
+/* Digital inputs, one 32 pin register.  A tool drives pins by writing sl_cr_host_gpio, or through sl_cr_host_set_pin to also run
+     the pin's interrupt */
+inline volatile uint32_t sl_cr_host_gpio = 0;
+inline void pinMode(uint8_t, uint8_t) {}
+#define portInputRegister(pin)   (&sl_cr_host_gpio)
+#define digitalPinToBitMask(pin) ((uint32_t) 1 << ((pin) & 31))
+
+/* Pin change interrupts, by pin */
+inline void (*sl_cr_host_pin_isr[32])() = {nullptr};
+inline void attachInterrupt(uint8_t pin, void (*function)(), int) {sl_cr_host_pin_isr[pin & 31] = function;}
+
+/* Sets a pin and runs its interrupt if the level changed */
+inline void sl_cr_host_set_pin(uint8_t pin, bool level)
+{
+  const uint32_t mask = digitalPinToBitMask(pin);
+  const uint32_t gpio = level?(sl_cr_host_gpio | mask):(sl_cr_host_gpio & ~mask);
+
+  if(gpio != sl_cr_host_gpio)
+  {
+    sl_cr_host_gpio = gpio;
+    if(sl_cr_host_pin_isr[pin & 31])
+    {
+      const bool in_isr = sl_cr_host_in_isr;
+      sl_cr_host_in_isr = true;
+      sl_cr_host_pin_isr[pin & 31]();
+      sl_cr_host_in_isr = in_isr;
+    }
+  }
+}
+
+/* UART that never receives, tools inject bytes directly */
+class HardwareSerial
+{
+  public:
+    void begin(uint32_t, uint16_t = 0) {}
+    int  available() {return 0;}
+    int  read() {return -1;}
+};
+inline HardwareSerial Serial1;
+inline HardwareSerial Serial3;
+
+#define SERIAL_8E2_RXINV_TXINV 0
+
+#endif /* __SL_CR_HOST_ARDUINO_H__ */
@@ -0,0 +1,25 @@
+/*
+  arduino_freertos.h
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+/* Host stand-in for the FreeRTOS types used by modules built into host tools.  There is no scheduler, a tool calls task loops itself */
+
+#ifndef __SL_CR_HOST_ARDUINO_FREERTOS_H__
+#define __SL_CR_HOST_ARDUINO_FREERTOS_H__
+
+#include <stdint.h>
+
+#include "Arduino.h"
+
+typedef uint32_t TickType_t;
+typedef long     BaseType_t;
+typedef void    *TaskHandle_t;
+
+#define pdFALSE 0
+#define pdTRUE  1
+#define pdMS_TO_TICKS(ms) ((TickType_t) (ms))
+
+#endif /* __SL_CR_HOST_ARDUINO_FREERTOS_H__ */
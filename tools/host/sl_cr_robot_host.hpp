@@ -0,0 +1,138 @@
+/*
+  sl_cr_robot_host.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+/* Host robot descriptors, for host tools that build the drive subsystem (sl_cr_drive.cpp) without the motor driver library sources.
+     sl_cr_robot_host_s:            the DRV8256P robot's encoders and PID over a host motor driver that records what the firmware drives
+                                    into it.
+     sl_cr_robot_host_open_loop_s:  the same host motor drivers without encoders or PID, for tools with no motor model.
+     Build the drive subsystem and the tool with:  -DSL_CR_ROBOT=<descriptor> -include tools/host/sl_cr_robot_host.hpp */
+
+#ifndef __SL_CR_ROBOT_HOST_HPP__
+#define __SL_CR_ROBOT_HOST_HPP__
+
+#include <Arduino.h>
+
+/* Declared ahead of sl_cr_robot.hpp, which names SL_CR_ROBOT */
+struct sl_cr_robot_host_s;
+struct sl_cr_robot_host_open_loop_s;
+
+#include "sl_cr_robot.hpp"
+
+/* Open loop motor driver.  Maps the set point from [min_rpm, max_rpm] to [min_commanded_rpm, max_commanded_rpm] on each loop(), 0 while
+     disabled, braking or in failsafe, as the library drivers do.  Counts the calls it gets from outside a simulated interrupt, so a tool
+     can check which context owns it */
+class sl_cr_host_motor_driver_c
+{
+  private:
+    const sandor_laboratories::robot::motor_driver_config_s config;
+
+    sandor_laboratories::robot::rpm_t set_rpm;
+    sandor_laboratories::robot::rpm_t commanded_rpm;
+    bool                              enabled;
+    bool                              braking;
+
+    /* Driver calls made outside a simulated interrupt, loop() calls and time of the last one (us) */
+    unsigned int task_calls;
+    unsigned int loops;
+    uint32_t     last_loop_us;
+
+    inline void call() {task_calls += sl_cr_host_in_isr?0:1;}
+
+  public:
+    sl_cr_host_motor_driver_c(const sandor_laboratories::robot::motor_driver_config_s &config)
+      : config(config), set_rpm(0), commanded_rpm(0), enabled(false), braking(false), task_calls(0), loops(0), last_loop_us(0)
+    {
+    }
+
+    static void init_config(sandor_laboratories::robot::motor_driver_config_s *config)
+    {
+      *config = {};
+    }
+
+    void loop()
+    {
+      call();
+      const bool off = !enabled || braking || (config.failsafe && config.failsafe(nullptr));
+      commanded_rpm  = off?0:(set_rpm * config.max_commanded_rpm) / config.max_rpm;
+      loops++;
+      last_loop_us   = micros();
+    }
+
+    void change_set_rpm(sandor_laboratories::robot::rpm_t rpm)
+    {
+      call();
+      set_rpm = (rpm > config.max_rpm)?config.max_rpm:((rpm < config.min_rpm)?config.min_rpm:rpm);
+      braking = false;
+    }
+    void brake_motor()                         {call(); set_rpm = 0; braking = true;}
+    template <typename reason_t> void enable(reason_t)  {call(); enabled = true;}
+    template <typename reason_t> void disable(reason_t) {call(); enabled = false;}
+    void set_limp_mode(bool)                   {}
+
+    inline sandor_laboratories::robot::rpm_t get_min_rpm()       const {return config.min_rpm;}
+    inline sandor_laboratories::robot::rpm_t get_max_rpm()       const {return config.max_rpm;}
+    inline sandor_laboratories::robot::rpm_t get_commanded_rpm() const {return commanded_rpm;}
+    inline sandor_laboratories::robot::rpm_t get_real_rpm()      const {return commanded_rpm;}
+
+    inline unsigned int get_task_calls()   const {return task_calls;}
+    inline unsigned int get_loops()        const {return loops;}
+    inline uint32_t     get_last_loop_us() const {return last_loop_us;}
+};
+
+/* DRV8256P robot's motors, encoders and PID gains, host motor drivers.  Encoder pins are remapped into the host's 32 pin register */
+struct sl_cr_robot_host_s
+{
+  typedef sl_cr_host_motor_driver_c                                                           motor_driver_t;
+  typedef sl_cr_encoder_c                                                                     encoder_t;
+  typedef sl_cr_fixed_pid_c                                                                   control_loop_t;
+
+  static constexpr sl_cr_drive_strategy_e            default_drive_strategy = SL_CR_DRIVE_STRATEGY_ARCADE;
+  static constexpr sandor_laboratories::robot::rpm_t min_commanded_rpm      = sl_cr_robot_drv8256p_s::min_commanded_rpm;
+  static constexpr sandor_laboratories::robot::rpm_t max_commanded_rpm      = sl_cr_robot_drv8256p_s::max_commanded_rpm;
+
+  static constexpr unsigned int        motor_count = 2;
+  static constexpr sl_cr_robot_motor_s motors[motor_count] =
+  {
+    {"Left Motor",  SL_CR_ROBOT_SIDE_LEFT,  SL_CR_PIN_INVALID, SL_CR_PIN_INVALID, SL_CR_PIN_INVALID, 2, 3, false,
+      LOG_KEY_MOTOR_DRIVER_LEFT,  LOG_KEY_MOTOR_CONTROL_LOOP_LEFT},
+    {"Right Motor", SL_CR_ROBOT_SIDE_RIGHT, SL_CR_PIN_INVALID, SL_CR_PIN_INVALID, SL_CR_PIN_INVALID, 4, 5, true,
+      LOG_KEY_MOTOR_DRIVER_RIGHT, LOG_KEY_MOTOR_CONTROL_LOOP_RIGHT},
+  };
+
+  static encoder_t *create_encoder(sl_cr_static_slot_c<encoder_t> *slot, const sl_cr_robot_motor_s &motor)
+  {
+    return slot->construct(motor.encoder_a_pin, motor.encoder_b_pin, motor.encoder_reverse, sl_cr_robot_drv8256p_s::encoder_cpr,
+                           sl_cr_robot_drv8256p_s::encoder_gear_num, sl_cr_robot_drv8256p_s::encoder_gear_den,
+                           sl_cr_robot_drv8256p_s::encoder_velocity_mode);
+  }
+  static control_loop_t *create_control_loop(sl_cr_static_slot_c<control_loop_t> *slot, const sl_cr_robot_motor_s &motor,
+                                             const sandor_laboratories::robot::motor_driver_config_s &config, uint32_t period_us)
+  {
+    return sl_cr_robot_drv8256p_s::create_control_loop(slot, motor, config, period_us);
+  }
+  static motor_driver_t *create_motor_driver(sl_cr_static_slot_c<motor_driver_t> *slot, const sl_cr_robot_motor_s &,
+                                             const sandor_laboratories::robot::motor_driver_config_s &config)
+  {
+    return slot->construct(config);
+  }
+};
+
+/* Host robot's motors and host motor drivers, open loop */
+struct sl_cr_robot_host_open_loop_s : sl_cr_robot_host_s
+{
+  static encoder_t *create_encoder(sl_cr_static_slot_c<encoder_t> *, const sl_cr_robot_motor_s &)
+  {
+    return nullptr;
+  }
+  static control_loop_t *create_control_loop(sl_cr_static_slot_c<control_loop_t> *, const sl_cr_robot_motor_s &,
+                                             const sandor_laboratories::robot::motor_driver_config_s &, uint32_t)
+  {
+    return nullptr;
+  }
+};
+
+#endif /* __SL_CR_ROBOT_HOST_HPP__ */
@@ -0,0 +1,67 @@
+/*
+  sl_cr_binlog_decode.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+/* Host decoder for binary logs (see sl_cr_binlog.hpp).  Reads a captured stream and prints one line per message.
+     Stream layout, format table and format hash all come from sl_cr_binlog.hpp, so the decoder cannot drift from the device.
+     Build from repository root:  g++ -std=c++17 -I. -Itools/host -I<sl-robot>/src -o sl_cr_binlog_decode tools/sl_cr_binlog_decode.cpp
+     Usage:                       sl_cr_binlog_decode < capture.bin */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sl_cr_binlog.hpp"
+
+static const char * const level_names[] = {"ALL", "DEBUG", "INFO", "WARNING", "ERROR"};
+#define LEVEL_COUNT (sizeof(level_names) / sizeof(level_names[0]))
+
+int main()
+{
+  int                   ret_val = 0;
+  sl_cr_binlog_header_s header;
+  uint8_t               buffer[256];
+
+  if(1 != fread(&header, sizeof(header), 1, stdin) || SL_CR_BINLOG_MAGIC != header.magic)
+  {
+    fprintf(stderr, "Not a binary log stream\n");
+    ret_val = 1;
+  }
+  else if(SL_CR_BINLOG_VERSION != header.version || header.record_size < sizeof(sl_cr_binlog_record_s) || header.record_size > sizeof(buffer))
+  {
+    fprintf(stderr, "Unsupported binary log version %u (record size %u)\n", header.version, header.record_size);
+    ret_val = 1;
+  }
+  else
+  {
+    if(sl_cr_binlog_format_hash() != header.format_hash)
+    {
+      fprintf(stderr, "Warning: format table does not match device (0x%08x vs 0x%08x), messages may be wrong\n",
+        (unsigned int) sl_cr_binlog_format_hash(), (unsigned int) header.format_hash);
+    }
+
+    while(1 == fread(buffer, header.record_size, 1, stdin))
+    {
+      sl_cr_binlog_record_s record;
+      memcpy(&record, buffer, sizeof(record));
+
+      printf("%10u.%06u [%s] key %u: ", record.time / 1000000, record.time % 1000000,
+        (record.level < LEVEL_COUNT)?level_names[record.level]:"?", record.key);
+      if(record.format < SL_CR_BINLOG_FMT_COUNT)
+      {
+        printf(sl_cr_binlog_format_strings[record.format],
+          record.args[0], record.args[1], record.args[2], record.args[3], record.args[4], record.args[5]);
+      }
+      else
+      {
+        printf("Unknown format %u", record.format);
+      }
+      printf("\n");
+    }
+  }
+
+  return ret_val;
+}
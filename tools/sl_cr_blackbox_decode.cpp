@@ -0,0 +1,130 @@
+/*
+  sl_cr_blackbox_decode.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+/* Host decoder for blackbox dumps (see sl_cr_blackbox.hpp).  Writes drive, RC and failsafe tables, oldest first, separated by a
+     blank line.  Each row has its device time and its time relative to the trigger (negative before).
+     Build:  g++ -std=c++17 -o sl_cr_blackbox_decode tools/sl_cr_blackbox_decode.cpp
+     Usage:  sl_cr_blackbox_decode [-t] < BB000.BIN > BB000.csv
+               -t  tab separated columns instead of CSV */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+/* Dump layout, must match sl_cr_blackbox.hpp */
+#define SL_CR_BLACKBOX_MAGIC       0x42424C53
+#define SL_CR_BLACKBOX_VERSION     1
+#define SL_CR_BLACKBOX_HEADER_SIZE 35
+#define SL_CR_BLACKBOX_MOTOR_SIZE  6
+
+#define SL_CR_BLACKBOX_RC_FAILSAFE       0x01
+#define SL_CR_BLACKBOX_RC_LOST_FRAME     0x02
+#define SL_CR_BLACKBOX_RC_STALE          0x04
+#define SL_CR_BLACKBOX_RC_RECEIVER_SHIFT 4
+
+static const char *trigger_names[] = {"failsafe", "watchdog", "operator"};
+
+static uint16_t read_u16(const uint8_t *data) {return data[0] | (data[1] << 8);}
+static uint32_t read_u32(const uint8_t *data) {return read_u16(data) | ((uint32_t) read_u16(data+2) << 16);}
+
+int main(int argc, char **argv)
+{
+  const char           separator = ((argc > 1) && (0 == strcmp(argv[1], "-t")))?'\t':',';
+  std::vector<uint8_t> dump;
+  uint8_t              chunk[4096];
+  size_t               length;
+
+  while((length = fread(chunk, 1, sizeof(chunk), stdin)) > 0)
+  {
+    dump.insert(dump.end(), chunk, chunk + length);
+  }
+
+  if((dump.size() < SL_CR_BLACKBOX_HEADER_SIZE) || (SL_CR_BLACKBOX_MAGIC != read_u32(&dump[0])) ||
+     (SL_CR_BLACKBOX_VERSION != read_u16(&dump[4])))
+  {
+    fprintf(stderr, "Not a blackbox dump (version %u)\n", SL_CR_BLACKBOX_VERSION);
+    return 1;
+  }
+
+  const uint8_t * const header               = &dump[0];
+  const unsigned int    trigger              = header[6];
+  const unsigned int    motor_count          = header[7];
+  const unsigned int    channel_count        = header[8];
+  const uint32_t        trigger_time         = read_u32(header + 9);
+  const uint32_t        failsafe_mask        = read_u32(header + 13);
+  const size_t          drive_record_size    = read_u16(header + 17);
+  const size_t          rc_record_size       = read_u16(header + 19);
+  const size_t          failsafe_record_size = read_u16(header + 21);
+  const uint32_t        drive_count          = read_u32(header + 23);
+  const uint32_t        rc_count             = read_u32(header + 27);
+  const uint32_t        failsafe_count       = read_u32(header + 31);
+
+  if((drive_record_size != (4 + SL_CR_BLACKBOX_MOTOR_SIZE*motor_count)) || (rc_record_size != (5 + 2*channel_count)) ||
+     (failsafe_record_size != 8) ||
+     (dump.size() < (SL_CR_BLACKBOX_HEADER_SIZE + drive_count*drive_record_size + rc_count*rc_record_size +
+                     failsafe_count*failsafe_record_size)))
+  {
+    fprintf(stderr, "Blackbox dump record layout does not match, or dump is truncated\n");
+    return 1;
+  }
+
+  fprintf(stderr, "Trigger: %s at %uus, failsafe mask 0x%x.  %u drive, %u RC, %u failsafe records\n",
+    (trigger < (sizeof(trigger_names) / sizeof(trigger_names[0])))?trigger_names[trigger]:"unknown",
+    trigger_time, failsafe_mask, drive_count, rc_count, failsafe_count);
+
+  const uint8_t *record = header + SL_CR_BLACKBOX_HEADER_SIZE;
+
+  printf("time_us%ctrigger_us", separator);
+  for(unsigned int m = 0; m < motor_count; m++)
+  {
+    printf("%cm%u_set_rpm%cm%u_commanded_rpm%cm%u_real_rpm", separator, m, separator, m, separator, m);
+  }
+  printf("\n");
+  for(uint32_t r = 0; r < drive_count; r++, record += drive_record_size)
+  {
+    const uint32_t time = read_u32(record);
+    printf("%u%c%d", time, separator, (int32_t) (time - trigger_time));
+    for(unsigned int v = 0; v < 3*motor_count; v++)
+    {
+      printf("%c%d", separator, (int16_t) read_u16(record + 4 + 2*v));
+    }
+    printf("\n");
+  }
+
+  printf("\nrx_time_us%ctrigger_us%creceiver%cfailsafe%clost_frame%cstale", separator, separator, separator, separator, separator);
+  for(unsigned int c = 0; c < channel_count; c++)
+  {
+    printf("%cch%u", separator, c+1);
+  }
+  printf("\n");
+  for(uint32_t r = 0; r < rc_count; r++, record += rc_record_size)
+  {
+    const uint32_t time  = read_u32(record);
+    const uint8_t  flags = record[4];
+    printf("%u%c%d%c%u%c%u%c%u%c%u", time, separator, (int32_t) (time - trigger_time),
+      separator, flags >> SL_CR_BLACKBOX_RC_RECEIVER_SHIFT,
+      separator, (flags & SL_CR_BLACKBOX_RC_FAILSAFE)?1:0,
+      separator, (flags & SL_CR_BLACKBOX_RC_LOST_FRAME)?1:0,
+      separator, (flags & SL_CR_BLACKBOX_RC_STALE)?1:0);
+    for(unsigned int c = 0; c < channel_count; c++)
+    {
+      printf("%c%u", separator, read_u16(record + 5 + 2*c));
+    }
+    printf("\n");
+  }
+
+  printf("\ntime_us%ctrigger_us%cold_mask%cnew_mask\n", separator, separator, separator);
+  for(uint32_t r = 0; r < failsafe_count; r++, record += failsafe_record_size)
+  {
+    const uint32_t time = read_u32(record);
+    printf("%u%c%d%c0x%x%c0x%x\n", time, separator, (int32_t) (time - trigger_time),
+      separator, read_u16(record + 4), separator, read_u16(record + 6));
+  }
+
+  return 0;
+}
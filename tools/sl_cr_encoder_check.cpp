@@ -0,0 +1,488 @@
+/*
+  sl_cr_encoder_check.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+/* Host simulation check of sl_cr_encoder_c.  A simulated motor drives the quadrature pins, each edge calls the edge interrupt with the
+     cycle counter at the exact edge time, and the control loop calls loop() at its period.  Run with the DRV8256P robot's encoder at
+     the 10ms control loop, 1ms cyclic executive and 250us fast control loop periods, in both velocity modes.
+     Checks speed at constant speeds both ways, position count, missed edge detection, decay to zero on stopping, and that a stop longer
+     than the cycle counter period (~7.16s) neither reports speed while stopped nor fakes one on restarting.
+     Then times the edge interrupt on a 200kHz edge stream against the path it replaced (critical section around a virtual per channel
+     sample) and against latching pin state into a ring decoded by the control loop, and reports each as a share of one core.
+     Build:  g++ -std=c++17 -O2 -I. -Itools/host -I<sl-robot>/src -o sl_cr_encoder_check tools/sl_cr_encoder_check.cpp sl_cr_encoder.cpp
+     Usage:  sl_cr_encoder_check
+   Exits non-zero if any check fails. */
+
+#include <Arduino.h>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+
+#include "sl_cr_encoder.hpp"
+
+using namespace sandor_laboratories::robot;
+
+/* Encoder of sl_cr_robot_drv8256p_s: 12 counts per motor revolution, 30:1 gearbox */
+#define CHECK_CPR      12
+#define CHECK_GEAR_NUM 1
+#define CHECK_GEAR_DEN 30
+#define CHECK_COUNTS_PER_REV (CHECK_CPR * CHECK_GEAR_DEN / CHECK_GEAR_NUM)
+#define CHECK_A_PIN    0
+#define CHECK_B_PIN    1
+
+/* Constant speed runs: time to settle and to measure over (s) */
+#define CHECK_SETTLE  0.2
+#define CHECK_MEASURE 0.5
+/* Edge timing error allowed, in percent of speed plus rpm (estimates are truncated to whole rpm) */
+#define CHECK_EDGE_TOLERANCE_PERCENT 1
+#define CHECK_EDGE_TOLERANCE_RPM     2
+/* Long stops: a plain one, and one lasting the cycle counter period less the time to the first edge on restarting, so the interval
+     between the last edge before and the first edge after wraps to CHECK_WRAP_RESIDUE_US */
+#define CHECK_LONG_STOP       7.2
+#define CHECK_WRAP_RESIDUE_US 10
+/* Slow restart after the long stop (rpm) */
+#define CHECK_RESTART_RPM     20
+
+/* Timed edge stream: edge rate (Hz), edges, and control loop period (us) batching them */
+#define BENCH_EDGE_RATE   200000
+#define BENCH_EDGES       4000000
+#define BENCH_ROUNDS      5
+#define BENCH_LOOP_US     10000
+#define BENCH_LOOP_EDGES  (BENCH_EDGE_RATE / (1000000 / BENCH_LOOP_US))
+/* Latch ring entries, power of 2 holding one control loop period of edges */
+#define BENCH_RING_SIZE   2048
+static_assert(BENCH_RING_SIZE >= BENCH_LOOP_EDGES, "Latch ring must hold a control loop period of edges");
+
+static unsigned int checks_failed = 0;
+
+static void check(bool condition, const char *run, const char *description)
+{
+  if(!condition)
+  {
+    printf("FAIL: %s: %s\n", run, description);
+    checks_failed++;
+  }
+}
+
+/* Motor turning the encoder and the control loop sampling it, on one simulated timeline */
+class motor_sim_c
+{
+  private:
+    sl_cr_encoder_c &encoder;
+    const uint32_t   loop_cycles;
+    /* Cycles since start, not wrapping */
+    uint64_t         time;
+    uint64_t         next_loop;
+    uint64_t         last_edge;
+    /* Position (counts) and speed (counts per cycle) */
+    double           position;
+    double           speed;
+    int64_t          count;
+
+    /* Quadrature state of a count, forward is A leading B */
+    static uint32_t pins(int64_t count)
+    {
+      static const uint32_t states[4] = {0, 1 << CHECK_A_PIN, (1 << CHECK_A_PIN) | (1 << CHECK_B_PIN), 1 << CHECK_B_PIN};
+      return states[((count % 4) + 4) % 4];
+    }
+
+    inline void set_time(uint64_t cycles)
+    {
+      time = cycles;
+      sl_cr_host_cycles = (uint32_t) cycles;
+    }
+
+  public:
+    motor_sim_c(sl_cr_encoder_c &encoder, uint32_t loop_period_us)
+      : encoder(encoder), loop_cycles(loop_period_us * (F_CPU_ACTUAL / 1000000)), time(sl_cr_host_cycles), next_loop(time + loop_cycles),
+        last_edge(time), position(0), speed(0), count(0)
+    {
+    }
+
+    /* Pins at count 0, before constructing the encoder so it starts from the same state */
+    static void reset_pins() {sl_cr_host_gpio = pins(0);}
+
+    static double rpm_to_speed(double rpm) {return rpm * CHECK_COUNTS_PER_REV / 60.0 / F_CPU_ACTUAL;}
+
+    void set_rpm(double rpm) {speed = rpm_to_speed(rpm);}
+    int64_t get_count() const {return count;}
+    uint64_t get_time() const {return time;}
+    uint64_t get_last_edge() const {return last_edge;}
+    /* Cycles until the next forward edge if moving at rpm from here */
+    uint64_t get_cycles_to_edge(double rpm) const {return (uint64_t) ceil((count + 1 - position) / rpm_to_speed(rpm));}
+
+    /* Runs for cycles, calling loop_done() after every control loop */
+    template <typename loop_f>
+    void run_cycles(uint64_t cycles, loop_f loop_done)
+    {
+      const uint64_t end = time + cycles;
+
+      while(time < end)
+      {
+        /* Next edge, when position crosses the next whole count */
+        uint64_t next_edge = UINT64_MAX;
+        if(speed != 0)
+        {
+          const double target = (speed > 0)?(count + 1):(count - 1);
+          next_edge = time + (uint64_t) ceil((target - position) / speed);
+        }
+
+        const uint64_t next = (next_edge < next_loop)?next_edge:next_loop;
+        if(next > end)
+        {
+          position += speed * (end - time);
+          set_time(end);
+          break;
+        }
+
+        position += speed * (next - time);
+        set_time(next);
+        if(next == next_edge)
+        {
+          count          += (speed > 0)?1:-1;
+          position        = count;
+          last_edge       = time;
+          sl_cr_host_gpio = pins(count);
+          encoder.sample();
+        }
+        if(next == next_loop)
+        {
+          encoder.loop();
+          next_loop += loop_cycles;
+          loop_done();
+        }
+      }
+    }
+
+    template <typename loop_f>
+    void run(double seconds, loop_f loop_done) {run_cycles((uint64_t) (seconds * F_CPU_ACTUAL), loop_done);}
+};
+
+/* Speed resolution of count based estimation, one count per loop (rpm) */
+static double count_resolution(uint32_t loop_period_us)
+{
+  return 60.0 * 1e6 / (CHECK_COUNTS_PER_REV * (double) loop_period_us);
+}
+
+static void check_constant_speed(uint32_t loop_period_us, sl_cr_encoder_velocity_mode_e mode, bool reverse, double rpm, const char *run)
+{
+  motor_sim_c::reset_pins();
+  sl_cr_encoder_c encoder(CHECK_A_PIN, CHECK_B_PIN, reverse, CHECK_CPR, CHECK_GEAR_NUM, CHECK_GEAR_DEN, mode);
+  motor_sim_c     motor(encoder, loop_period_us);
+  const double    expected  = reverse?-rpm:rpm;
+  const double    tolerance = (SL_CR_ENCODER_VELOCITY_EDGE_TIMING == mode)?
+                              (fabs(rpm) * CHECK_EDGE_TOLERANCE_PERCENT / 100 + CHECK_EDGE_TOLERANCE_RPM):
+                              (count_resolution(loop_period_us) + 1);
+  double          max_error = 0;
+  double          sum       = 0;
+  unsigned int    loops     = 0;
+  char            name[96];
+
+  motor.set_rpm(rpm);
+  motor.run(CHECK_SETTLE, []() {});
+  motor.run(CHECK_MEASURE, [&]() {
+    max_error = fmax(max_error, fabs(encoder.get_rpm() - expected));
+    sum      += encoder.get_rpm();
+    loops++;
+  });
+
+  snprintf(name, sizeof(name), "%s %+6.0frpm%s", run, rpm, reverse?" reversed":"");
+  printf("  %-44s mean %+8.2f max error %7.2f (allowed %6.2f)\n", name, sum / loops, max_error, tolerance);
+  check(max_error <= tolerance, name, "speed within tolerance");
+  check(motor.get_count() == encoder.get_count(), name, "count follows edges");
+}
+
+static void check_stop(uint32_t loop_period_us, sl_cr_encoder_velocity_mode_e mode, const char *run)
+{
+  motor_sim_c::reset_pins();
+  sl_cr_encoder_c encoder(CHECK_A_PIN, CHECK_B_PIN, false, CHECK_CPR, CHECK_GEAR_NUM, CHECK_GEAR_DEN, mode);
+  motor_sim_c     motor(encoder, loop_period_us);
+  const double    settle = (SL_CR_ENCODER_STOPPED_TIMEOUT / 1000.0) + 2 * (loop_period_us / 1e6);
+  char            name[96];
+
+  for(unsigned int s = 0; s < 2; s++)
+  {
+    double       previous  = 0;
+    bool         increased = false;
+    unsigned int moving    = 0;
+    double       fastest   = 0;
+
+    motor.set_rpm(400);
+    motor.run(CHECK_SETTLE, []() {});
+
+    /* Decays towards zero, never increasing, and reaches it by the stopped timeout */
+    motor.set_rpm(0);
+    previous = encoder.get_rpm();
+    motor.run(settle, [&]() {
+      increased = increased || (encoder.get_rpm() > previous);
+      previous  = encoder.get_rpm();
+    });
+    check(!increased, name, "speed only decays after stopping");
+    check(0 == encoder.get_rpm(), name, "zero by stopped timeout");
+
+    /* Stays zero through the whole stop, including after time since last edge wraps below the timeout */
+    const uint64_t stop_end = (0 == s)?(motor.get_time() + (uint64_t) ((CHECK_LONG_STOP - settle) * F_CPU_ACTUAL)):
+                              (motor.get_last_edge() + (UINT64_C(1) << 32) + CHECK_WRAP_RESIDUE_US * (F_CPU_ACTUAL / 1000000) -
+                               motor.get_cycles_to_edge(CHECK_RESTART_RPM));
+    snprintf(name, sizeof(name), "%s stop %.6fs", run, (stop_end - motor.get_last_edge()) / (double) F_CPU_ACTUAL);
+    motor.run_cycles(stop_end - motor.get_time(), [&]() {moving += (0 != encoder.get_rpm())?1:0;});
+    check(0 == moving, name, "zero while stopped");
+
+    /* Restarting slowly must not report a speed from an interval across the wrap */
+    motor.set_rpm(CHECK_RESTART_RPM);
+    motor.run(CHECK_SETTLE, [&]() {fastest = fmax(fastest, fabs(encoder.get_rpm()));});
+
+    printf("  %-44s loops moving while stopped %u, fastest on restart %7.2f (restart %d)\n", name, moving, fastest, CHECK_RESTART_RPM);
+    check(fastest <= (CHECK_RESTART_RPM + count_resolution(loop_period_us) + 1), name, "no fake speed on restart");
+  }
+}
+
+static void check_invalid_transition(const char *run)
+{
+  sl_cr_encoder_c encoder(CHECK_A_PIN, CHECK_B_PIN, false, CHECK_CPR, CHECK_GEAR_NUM, CHECK_GEAR_DEN);
+
+  /* Both channels change between interrupts */
+  sl_cr_host_gpio ^= (1 << CHECK_A_PIN) | (1 << CHECK_B_PIN);
+  encoder.sample();
+  check((1 == encoder.get_invalid_transitions()) && (0 == encoder.get_count()), run, "missed edge counted, not stepped");
+}
+
+/* Interrupt mask, as the target's PRIMASK save, disable and restore */
+static volatile uint32_t bench_primask = 0;
+static uint32_t          bench_primask_saved;
+
+void critical_section_enter_interrupt()
+{
+  bench_primask_saved = bench_primask;
+  bench_primask       = 1;
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+void critical_section_exit_interrupt()
+{
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  bench_primask = bench_primask_saved;
+}
+
+/* Step for each {previous, current} state pair, as sl_cr_encoder_c */
+static const int8_t bench_step[16] = { 0, -1,  1,  0,
+                                       1,  0,  0, -1,
+                                      -1,  0,  0,  1,
+                                       0,  1, -1,  0 };
+
+/* Path replaced by user-014: library encoder sampled per channel through its base class, pins looked up on every edge */
+class bench_encoder_base_c
+{
+  public:
+    virtual ~bench_encoder_base_c() {}
+    virtual void sample_channel_a() = 0;
+    virtual void sample_channel_b() = 0;
+    virtual int32_t get_count() const = 0;
+};
+
+class bench_encoder_baseline_c : public bench_encoder_base_c
+{
+  private:
+    const pin_t      a_pin;
+    const pin_t      b_pin;
+    uint8_t          state;
+    volatile int32_t count;
+
+    void sample()
+    {
+      const uint8_t current = (((*portInputRegister(a_pin)) & digitalPinToBitMask(a_pin))?2:0) |
+                              (((*portInputRegister(b_pin)) & digitalPinToBitMask(b_pin))?1:0);
+      count = count + bench_step[(state << 2) | current];
+      state = current;
+    }
+
+  public:
+    bench_encoder_baseline_c(pin_t a_pin, pin_t b_pin) : a_pin(a_pin), b_pin(b_pin), state(0), count(0) {}
+
+    void sample_channel_a() override {sample();}
+    void sample_channel_b() override {sample();}
+    int32_t get_count() const override {return count;}
+};
+
+/* Interrupt only latches cycle counter and pin state into a ring, control loop decodes the batch */
+class bench_encoder_latch_c
+{
+  private:
+    volatile uint32_t *a_register;
+    uint32_t           a_mask;
+    volatile uint32_t *b_register;
+    uint32_t           b_mask;
+
+    uint32_t              ring[BENCH_RING_SIZE];
+    std::atomic<uint32_t> head;
+    uint32_t              tail;
+    uint32_t              overflows;
+
+    uint8_t state;
+    int32_t count;
+    uint32_t edge_cycles;
+
+  public:
+    bench_encoder_latch_c(pin_t a_pin, pin_t b_pin)
+      : a_register(portInputRegister(a_pin)), a_mask(digitalPinToBitMask(a_pin)),
+        b_register(portInputRegister(b_pin)), b_mask(digitalPinToBitMask(b_pin)),
+        ring{}, head(0), tail(0), overflows(0), state(0), count(0), edge_cycles(0)
+    {
+    }
+
+    inline void sample()
+    {
+      const uint32_t h = head.load(std::memory_order_relaxed);
+      ring[h & (BENCH_RING_SIZE - 1)] = (ARM_DWT_CYCCNT & ~3UL) | (((*a_register) & a_mask)?2:0) | (((*b_register) & b_mask)?1:0);
+      head.store(h + 1, std::memory_order_release);
+    }
+
+    void loop()
+    {
+      const uint32_t h = head.load(std::memory_order_acquire);
+
+      if((h - tail) > BENCH_RING_SIZE)
+      {
+        /* Oldest states overwritten, position is lost */
+        overflows++;
+        tail = h - BENCH_RING_SIZE;
+      }
+      for(; tail != h; tail++)
+      {
+        const uint32_t latched = ring[tail & (BENCH_RING_SIZE - 1)];
+        const uint8_t  current = latched & 3;
+        const int8_t   step    = bench_step[(state << 2) | current];
+        count      += step;
+        edge_cycles = (0 != step)?(latched & ~3UL):edge_cycles;
+        state       = current;
+      }
+    }
+
+    int32_t get_count() const {return count;}
+    uint32_t get_overflows() const {return overflows;}
+};
+
+/* Interrupt dispatch, as attachInterrupt() calls through a function pointer */
+static bench_encoder_base_c  *bench_baseline;
+static sl_cr_encoder_c       *bench_encoder;
+static bench_encoder_latch_c *bench_latch;
+
+static void bench_isr_none() {}
+static void bench_isr_baseline_a()
+{
+  critical_section_enter_interrupt();
+  bench_baseline->sample_channel_a();
+  critical_section_exit_interrupt();
+}
+static void bench_isr_baseline_b()
+{
+  critical_section_enter_interrupt();
+  bench_baseline->sample_channel_b();
+  critical_section_exit_interrupt();
+}
+static void bench_isr_encoder() {bench_encoder->sample();}
+static void bench_isr_latch()   {bench_latch->sample();}
+
+/* ns per edge for edges at BENCH_EDGE_RATE, A and B edges alternating, with the control loop run every BENCH_LOOP_US */
+template <typename loop_f>
+static double bench_edges(void (*isr_a)(), void (*isr_b)(), loop_f loop)
+{
+  static const uint32_t states[4] = {0, 1 << CHECK_A_PIN, (1 << CHECK_A_PIN) | (1 << CHECK_B_PIN), 1 << CHECK_B_PIN};
+  void (* volatile isr[2])() = {isr_b, isr_a};
+
+  sl_cr_host_gpio = states[0];
+  const auto start = std::chrono::steady_clock::now();
+
+  for(uint32_t e = 1; e <= BENCH_EDGES; e++)
+  {
+    sl_cr_host_gpio    = states[e & 3];
+    sl_cr_host_cycles += F_CPU_ACTUAL / BENCH_EDGE_RATE;
+    /* Odd edges change A */
+    isr[e & 1]();
+    if(0 == (e % BENCH_LOOP_EDGES))
+    {
+      loop();
+    }
+  }
+
+  const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / BENCH_EDGES;
+}
+
+static void bench_isr_paths()
+{
+  const char * const run = "200kHz edges";
+
+  motor_sim_c::reset_pins();
+  bench_encoder_baseline_c baseline(CHECK_A_PIN, CHECK_B_PIN);
+  sl_cr_encoder_c          encoder(CHECK_A_PIN, CHECK_B_PIN, false, CHECK_CPR, CHECK_GEAR_NUM, CHECK_GEAR_DEN);
+  static bench_encoder_latch_c latch(CHECK_A_PIN, CHECK_B_PIN);
+  bench_baseline = &baseline;
+  bench_encoder  = &encoder;
+  bench_latch    = &latch;
+
+  /* Fastest of interleaved rounds, least disturbed by the host */
+  double none_ns = INFINITY, baseline_ns = INFINITY, encoder_ns = INFINITY, latch_ns = INFINITY;
+  for(unsigned int r = 0; r < BENCH_ROUNDS; r++)
+  {
+    none_ns     = fmin(none_ns,     bench_edges(bench_isr_none, bench_isr_none, []() {}));
+    baseline_ns = fmin(baseline_ns, bench_edges(bench_isr_baseline_a, bench_isr_baseline_b, []() {
+      critical_section_enter_interrupt();
+      (void) bench_baseline->get_count();
+      critical_section_exit_interrupt();
+    }));
+    encoder_ns  = fmin(encoder_ns,  bench_edges(bench_isr_encoder, bench_isr_encoder, []() {bench_encoder->loop();}));
+    latch_ns    = fmin(latch_ns,    bench_edges(bench_isr_latch, bench_isr_latch, []() {bench_latch->loop();}));
+  }
+  /* Less the stream itself */
+  baseline_ns -= none_ns;
+  encoder_ns  -= none_ns;
+  latch_ns    -= none_ns;
+
+  /* Share of one core spent on edges, at the host's speed */
+  printf("%s (host ns per edge including control loop share, share of one core at %ukHz)\n", run, BENCH_EDGE_RATE / 1000);
+  printf("  %-44s %6.2f ns %5.2f%%\n", "critical section + virtual (replaced)", baseline_ns, baseline_ns * BENCH_EDGE_RATE / 1e7);
+  printf("  %-44s %6.2f ns %5.2f%%\n", "decode in interrupt (sl_cr_encoder_c)", encoder_ns, encoder_ns * BENCH_EDGE_RATE / 1e7);
+  printf("  %-44s %6.2f ns %5.2f%%, %u byte ring\n", "latch in interrupt, decode in control loop", latch_ns,
+    latch_ns * BENCH_EDGE_RATE / 1e7, (unsigned int) sizeof(uint32_t) * BENCH_RING_SIZE);
+
+  check(((BENCH_EDGES * BENCH_ROUNDS) == baseline.get_count()) && ((BENCH_EDGES * BENCH_ROUNDS) == encoder.get_count()) &&
+        ((BENCH_EDGES * BENCH_ROUNDS) == latch.get_count()) &&
+        (0 == latch.get_overflows()), run, "every path counts every edge");
+  check(encoder_ns < baseline_ns, run, "decode in interrupt cheaper than the path it replaced");
+}
+
+int main()
+{
+  const uint32_t                      periods[] = {10000, 1000, 250};
+  const sl_cr_encoder_velocity_mode_e modes[]   = {SL_CR_ENCODER_VELOCITY_COUNT, SL_CR_ENCODER_VELOCITY_EDGE_TIMING};
+  const char * const                  mode_names[] = {"count", "edge timing"};
+  const double                        speeds[]  = {5, 20, 100, 400, 1000, -400};
+
+  check_invalid_transition("invalid transition");
+
+  for(unsigned int p = 0; p < (sizeof(periods) / sizeof(periods[0])); p++)
+  {
+    for(unsigned int m = 0; m < (sizeof(modes) / sizeof(modes[0])); m++)
+    {
+      char run[48];
+      snprintf(run, sizeof(run), "%uus %s", periods[p], mode_names[m]);
+      printf("%s\n", run);
+
+      for(unsigned int s = 0; s < (sizeof(speeds) / sizeof(speeds[0])); s++)
+      {
+        check_constant_speed(periods[p], modes[m], false, speeds[s], run);
+      }
+      check_constant_speed(periods[p], modes[m], true, 400, run);
+      check_stop(periods[p], modes[m], run);
+    }
+  }
+
+  bench_isr_paths();
+
+  printf("%s\n", (0 == checks_failed)?"ok":"FAIL");
+
+  return (0 == checks_failed)?0:1;
+}
@@ -0,0 +1,414 @@
+/*
+  sl_cr_failsafe_check.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+/* Host check of the lock-free failsafe mask and its transition log.  Runs the firmware failsafe module with RC frames supplied by the
+     check: boots, arms with the pre-arm then arm switch sequence and disarms, checking the mask and the logged transitions.  Then sets
+     and clears one reason per thread from several threads while the log task drains transitions, and checks that the mask ends
+     consistent and that the logged masks form one chain of single bit changes, with no more breaks than transitions reported dropped.
+     Then arms and repeats the run, checking every failsafe entry runs the hooks once and is counted once by the rearm logic.
+     Then moves entries through the MPSC ring buffer from several producers and checks none are lost or reordered per producer.
+     Finally times mask reads and updates.
+     Build:  g++ -std=c++17 -O2 -pthread -I. -Itools/host -I<sl-robot>/src -o sl_cr_failsafe_check tools/sl_cr_failsafe_check.cpp
+               sl_cr_failsafe.cpp sl_cr_latency.cpp
+     Usage:  sl_cr_failsafe_check
+   Exits non-zero if any check fails. */
+
+#include <Arduino.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sl_cr_failsafe.hpp"
+#include "sl_cr_ring_buffer.hpp"
+#include "sl_cr_sbus.hpp"
+
+using namespace sandor_laboratories::robot;
+
+/* Updates per thread in the concurrent mask run, threads yield every CHECK_YIELD updates (with their reason cleared) so a single core
+     host interleaves them */
+#define CHECK_MASK_UPDATES   200000
+#define CHECK_YIELD          4
+/* Entries per producer through the MPSC ring buffer */
+#define CHECK_RING_ENTRIES   300000
+#define CHECK_RING_PRODUCERS 4
+/* Timed calls */
+#define BENCH_CALLS          10000000
+
+/* Switch positions */
+#define CHECK_SWITCH_LOW  SL_CR_RC_CH_MIN_VALUE
+#define CHECK_SWITCH_HIGH SL_CR_RC_CH_MAX_VALUE
+
+#define CHECK_BIT(reason) (1u << (reason))
+
+static unsigned int checks_failed = 0;
+
+static void check(bool condition, const char *run, const char *description)
+{
+  if(!condition)
+  {
+    printf("FAIL: %s: %s\n", run, description);
+    checks_failed++;
+  }
+}
+
+/* Failsafe critical section, a recursive mutex on the host */
+static std::recursive_mutex critical_section_mutex;
+
+void critical_section_enter()
+{
+  critical_section_mutex.lock();
+}
+
+void critical_section_exit()
+{
+  critical_section_mutex.unlock();
+}
+
+/* Rearm state of the failsafe module under test */
+extern unsigned int repeat_failsafe_rearm_counter;
+
+/* Failsafe entries seen by the hook */
+static std::atomic<unsigned int> hook_entries(0);
+
+static void count_entry_hook()
+{
+  hook_entries++;
+}
+
+/* RC frame the arm switch logic reads */
+static sl_cr_sbus_frame_s check_frame = {};
+
+uint32_t sl_cr_sbus_get_frame(sl_cr_sbus_frame_s *frame)
+{
+  *frame = check_frame;
+  return check_frame.sequence;
+}
+
+sl_cr_rc_channel_value_t sl_cr_sbus_get_frame_ch_value(const sl_cr_sbus_frame_s *frame, sl_cr_rc_channel_t channel)
+{
+  return (!frame->stale && (channel >= 1) && (channel <= SL_CR_SBUS_NUM_CH))?frame->ch[channel-1]:SL_CR_RC_CH_INVALID_VALUE;
+}
+
+static void set_switches(sl_cr_rc_channel_value_t prearm, sl_cr_rc_channel_value_t arm)
+{
+  check_frame.sequence++;
+  check_frame.rx_time = micros();
+  check_frame.ch[SL_CR_PREARM_SWITCH_CH-1] = prearm;
+  check_frame.ch[SL_CR_ARM_SWITCH_CH-1]    = arm;
+  sl_cr_host_advance_us(14000);
+  combat::failsafe_armswitch_loop();
+}
+
+/* Log lines written by the failsafe module, not kept while timing */
+static std::mutex               log_mutex;
+static std::vector<std::string> log_lines;
+static bool                     log_capture = true;
+
+void log_snprintf(log_key_e, log_level_e, const char *format, ...)
+{
+  char    line[128];
+  va_list args;
+
+  if(!log_capture)
+  {
+    return;
+  }
+
+  va_start(args, format);
+  vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+
+  std::lock_guard<std::mutex> lock(log_mutex);
+  log_lines.push_back(line);
+}
+
+/* Drains logged transitions into new masks (in log order), counting entries, "FAILSAFE SET!", "ARMED!" and dropped reports.
+     Keeps the last reported dropped total */
+typedef struct
+{
+  std::vector<combat::failsafe_mask_t> masks;
+  unsigned int                         set;
+  unsigned int                         armed;
+  unsigned int                         dropped_reports;
+  unsigned int                         dropped;
+} logged_s;
+
+static void parse_log(logged_s *logged)
+{
+  std::lock_guard<std::mutex> lock(log_mutex);
+
+  for(const std::string &line : log_lines)
+  {
+    unsigned int mask;
+    unsigned int time;
+
+    if(2 == sscanf(line.c_str(), "New failsafe mask: 0x%x at %uus", &mask, &time))
+    {
+      logged->masks.push_back(mask);
+    }
+    else if(line == "FAILSAFE SET!")
+    {
+      logged->set++;
+    }
+    else if(line == "ARMED!")
+    {
+      logged->armed++;
+    }
+    else if(1 == sscanf(line.c_str(), "Failsafe transitions dropped: %u", &logged->dropped))
+    {
+      logged->dropped_reports++;
+    }
+  }
+  log_lines.clear();
+}
+
+/* Arming sequence on one thread */
+static void check_arming()
+{
+  const char * const run = "arm sequence";
+  logged_s           logged = {};
+
+  check(combat::get_failsafe_mask() == (CHECK_BIT(combat::FAILSAFE_BOOT) | CHECK_BIT(combat::FAILSAFE_ARM_SWITCH_DISARM)), run,
+        "boots in BOOT and ARM_SWITCH_DISARM failsafe");
+
+  /* Boot completes with arm switch high, must not arm */
+  combat::clear_failsafe_mask(combat::FAILSAFE_BOOT);
+  set_switches(CHECK_SWITCH_HIGH, CHECK_SWITCH_HIGH);
+  check(combat::get_failsafe_set(combat::FAILSAFE_ARM_SWITCH_DISARM), run, "switches high at boot do not arm");
+
+  /* Release both, pre-arm, then arm */
+  set_switches(CHECK_SWITCH_LOW, CHECK_SWITCH_LOW);
+  check(combat::get_failsafe_mask() == CHECK_BIT(combat::FAILSAFE_ARM_SWITCH), run, "released switches leave only ARM_SWITCH");
+  set_switches(CHECK_SWITCH_HIGH, CHECK_SWITCH_LOW);
+  set_switches(CHECK_SWITCH_HIGH, CHECK_SWITCH_HIGH);
+  check(!combat::get_failsafe_set(), run, "pre-arm then arm clears failsafe");
+
+  /* Disarm */
+  set_switches(CHECK_SWITCH_HIGH, CHECK_SWITCH_LOW);
+  check(combat::get_failsafe_mask() == CHECK_BIT(combat::FAILSAFE_ARM_SWITCH), run, "disarm sets ARM_SWITCH");
+
+  combat::failsafe_log_transitions();
+  parse_log(&logged);
+
+  const combat::failsafe_mask_t expected[] =
+  {
+    CHECK_BIT(combat::FAILSAFE_ARM_SWITCH_DISARM),
+    CHECK_BIT(combat::FAILSAFE_ARM_SWITCH_DISARM) | CHECK_BIT(combat::FAILSAFE_ARM_SWITCH),
+    CHECK_BIT(combat::FAILSAFE_ARM_SWITCH),
+    0,
+    CHECK_BIT(combat::FAILSAFE_ARM_SWITCH),
+  };
+  bool equal = (logged.masks.size() == (sizeof(expected) / sizeof(expected[0])));
+  for(size_t t = 0; equal && (t < logged.masks.size()); t++)
+  {
+    equal = (logged.masks[t] == expected[t]);
+  }
+
+  printf("%-28s %u transitions logged, %u armed, %u failsafe set\n", run, (unsigned int) logged.masks.size(), logged.armed, logged.set);
+  check(equal, run, "logged masks follow the arming sequence");
+  check((1 == logged.armed) && (1 == logged.set), run, "ARMED! and FAILSAFE SET! logged once each");
+}
+
+/* Sets and clears one reason per thread while the log task drains, checks the logged transitions */
+static void run_concurrent_mask(const char *run, logged_s *logged)
+{
+  const combat::failsafe_reason_e reasons[] = {combat::FAILSAFE_BOOT, combat::FAILSAFE_SBUS, combat::FAILSAFE_SBUS_STALE};
+  const unsigned int              threads   = sizeof(reasons) / sizeof(reasons[0]);
+  std::atomic<unsigned int>       running(threads);
+  std::vector<std::thread>        writers;
+
+  /* Start from a drained log, dropped total is cumulative */
+  combat::failsafe_log_transitions();
+  parse_log(logged);
+  const unsigned int            dropped_before = logged->dropped;
+  const combat::failsafe_mask_t held = combat::get_failsafe_mask();
+  *logged = {};
+
+  for(unsigned int w = 0; w < threads; w++)
+  {
+    writers.emplace_back([&, w]() {
+      for(unsigned int u = 0; u < CHECK_MASK_UPDATES; u++)
+      {
+        combat::set_failsafe_mask_value(reasons[w], 0 == (u & 1));
+        if(1 == (u % CHECK_YIELD))
+        {
+          std::this_thread::yield();
+        }
+      }
+      running--;
+    });
+  }
+  std::thread log_task([&]() {
+    while(running > 0)
+    {
+      combat::failsafe_log_transitions();
+      std::this_thread::yield();
+    }
+    combat::failsafe_log_transitions();
+  });
+
+  for(std::thread &writer : writers)
+  {
+    writer.join();
+  }
+  log_task.join();
+  parse_log(logged);
+  logged->dropped = (logged->dropped_reports > 0)?(logged->dropped - dropped_before):0;
+
+  /* Each logged mask differs from the one before in exactly one bit, a dropped transition breaks the chain at most once */
+  unsigned int            broken = 0;
+  combat::failsafe_mask_t last = held;
+  for(combat::failsafe_mask_t mask : logged->masks)
+  {
+    broken += (1 != __builtin_popcount(mask ^ last))?1:0;
+    last    = mask;
+  }
+
+  printf("%-28s %u threads x %u updates, %u transitions logged, %u dropped, %u chain breaks\n", run, threads,
+    CHECK_MASK_UPDATES, (unsigned int) logged->masks.size(), logged->dropped, broken);
+  check(combat::get_failsafe_mask() == held, run, "every thread ends cleared, mask back to held reasons");
+  check((last == held) || (logged->dropped > 0), run, "last logged mask is the final mask");
+  check(broken <= logged->dropped, run, "logged transitions form one chain, in mask order");
+}
+
+/* Reasons set and cleared from their own threads while ARM_SWITCH holds failsafe */
+static void check_concurrent_mask()
+{
+  const char * const run = "concurrent mask";
+  logged_s           logged = {};
+
+  run_concurrent_mask(run, &logged);
+  check(0 == logged.armed, run, "never armed while ARM_SWITCH is held");
+}
+
+/* Same run from armed, every entry into failsafe must run the hooks once and count once toward forced rearm */
+static void check_concurrent_entries()
+{
+  const char * const run = "concurrent failsafe entries";
+  logged_s           logged = {};
+
+  set_switches(CHECK_SWITCH_LOW, CHECK_SWITCH_LOW);
+  set_switches(CHECK_SWITCH_HIGH, CHECK_SWITCH_LOW);
+  set_switches(CHECK_SWITCH_HIGH, CHECK_SWITCH_HIGH);
+  check(!combat::get_failsafe_set(), run, "armed before run");
+
+  const unsigned int counter_before = repeat_failsafe_rearm_counter;
+  const unsigned int hooks_before   = hook_entries;
+  run_concurrent_mask(run, &logged);
+  const unsigned int entries = hook_entries - hooks_before;
+
+  printf("%-28s %u failsafe entries, rearm counter +%u\n", run, entries, repeat_failsafe_rearm_counter - counter_before);
+  check(entries > 0, run, "failsafe entered during run");
+  check(entries == (repeat_failsafe_rearm_counter - counter_before), run, "each failsafe entry counted once for rearm");
+
+  /* Disarm */
+  set_switches(CHECK_SWITCH_HIGH, CHECK_SWITCH_LOW);
+}
+
+/* MPSC ring buffer with several producers and one consumer */
+static void check_ring()
+{
+  const char * const run = "MPSC ring buffer";
+  typedef struct
+  {
+    uint32_t producer;
+    uint32_t sequence;
+  } entry_s;
+  static sl_cr_mpsc_ring_buffer_c<entry_s, 32> ring;
+  std::vector<std::thread>  producers;
+  uint32_t                  next[CHECK_RING_PRODUCERS] = {0};
+  unsigned int              received = 0;
+  unsigned int              reordered = 0;
+
+  for(uint32_t p = 0; p < CHECK_RING_PRODUCERS; p++)
+  {
+    producers.emplace_back([p]() {
+      for(uint32_t s = 0; s < CHECK_RING_ENTRIES; s++)
+      {
+        /* Retry when full, so every entry must arrive */
+        while(!ring.push({p, s}))
+        {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  while(received < (CHECK_RING_ENTRIES * CHECK_RING_PRODUCERS))
+  {
+    entry_s entry;
+    if(ring.pop(&entry))
+    {
+      reordered += (entry.sequence != next[entry.producer])?1:0;
+      next[entry.producer] = entry.sequence + 1;
+      received++;
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  for(std::thread &producer : producers)
+  {
+    producer.join();
+  }
+
+  entry_s extra;
+  printf("%-28s %u producers x %u entries, %u received, %u out of order, %u pushes found it full\n", run, CHECK_RING_PRODUCERS,
+    CHECK_RING_ENTRIES, received, reordered, ring.get_dropped());
+  check(0 == reordered, run, "per-producer order kept, nothing lost");
+  check(!ring.pop(&extra), run, "nothing extra received");
+}
+
+/* ns per call of f */
+template <typename call_f>
+static double time_calls(call_f call)
+{
+  const auto start = std::chrono::steady_clock::now();
+
+  for(unsigned int i = 0; i < BENCH_CALLS; i++)
+  {
+    call(i);
+  }
+
+  const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / BENCH_CALLS;
+}
+
+int main()
+{
+  combat::register_failsafe_hook(count_entry_hook);
+
+  check_arming();
+  check_concurrent_mask();
+  check_concurrent_entries();
+  check_ring();
+
+  volatile unsigned int sink = 0;
+  log_capture = false;
+  const double read_ns   = time_calls([&](unsigned int) {sink = sink + combat::get_failsafe_mask();});
+  const double nop_ns    = time_calls([](unsigned int) {combat::set_failsafe_mask(combat::FAILSAFE_ARM_SWITCH);});
+  const double update_ns = time_calls([](unsigned int i) {
+    combat::set_failsafe_mask_value(combat::FAILSAFE_SBUS, 0 == (i & 1));
+    if(0 == (i & 31))
+    {
+      combat::failsafe_log_transitions();
+    }
+  });
+  printf("mask read %5.2f ns, set already set %5.2f ns, set or clear with transition %5.2f ns (host)\n", read_ns, nop_ns, update_ns);
+
+  printf("%s\n", (0 == checks_failed)?"ok":"FAIL");
+
+  return (0 == checks_failed)?0:1;
+}
@@ -0,0 +1,272 @@
+/*
+  sl_cr_fast_loop_check.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+/* Host check of the fast control loop (_FAST_CONTROL_LOOP_).  Builds the drive subsystem with the host robot and runs the fast control
+     loop from the host IntervalTimer stand-in, with a first order motor model on each motor turning its encoder through the pin
+     interrupts.  The drive strategy and control loop tasks run every 10ms as on target.  On a throttle step, checks that only the timer
+     calls the motor drivers, that driver outputs change at the timer rate rather than the control loop task's, that the speed settles on
+     the set point, and that stick-to-output and failsafe-to-off complete within one timer period.
+     Build:  g++ -std=c++17 -O2 -I. -Itools/host -I<sl-robot>/src -D_FAST_CONTROL_LOOP_ -DSL_CR_ROBOT=sl_cr_robot_host_s
+               -include tools/host/sl_cr_robot_host.hpp -o sl_cr_fast_loop_check tools/sl_cr_fast_loop_check.cpp sl_cr_drive.cpp
+               sl_cr_encoder.cpp sl_cr_failsafe.cpp sl_cr_fixed_pid.cpp sl_cr_latency.cpp sl_cr_rc_map.cpp
+     Usage:  sl_cr_fast_loop_check
+   Exits non-zero if any check fails. */
+
+#include <Arduino.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "sl_cr_drive.hpp"
+#include "sl_cr_failsafe.hpp"
+#include "sl_cr_latency.hpp"
+
+#ifndef _FAST_CONTROL_LOOP_
+#error "Build with -D_FAST_CONTROL_LOOP_"
+#endif
+
+using namespace sandor_laboratories::robot;
+
+/* Motor model step (us), task period (us), and first order motor: steady state rpm per commanded unit and time constant (s) */
+#define CHECK_STEP_US          5
+#define CHECK_TASK_PERIOD_US   10000
+#define CHECK_MOTOR_GAIN       (1000.0 / 1023.0)
+#define CHECK_MOTOR_TAU        0.05
+/* Run: neutral, then throttle step held, then failsafe entered off the timer grid (us) */
+#define CHECK_NEUTRAL_US       50000
+#define CHECK_STEP_HOLD_US     1000000
+#define CHECK_FAILSAFE_SKEW_US 37
+/* Throttle step as a share of the positive half range, and settled speed tolerance in percent of set point */
+#define CHECK_THROTTLE_SHARE   0.5
+#define CHECK_SETTLE_PERCENT   5
+/* Driver output changes expected within one control loop task period right after the step */
+#define CHECK_MIN_STEP_UPDATES 4
+
+static unsigned int checks_failed = 0;
+
+static void check(bool condition, const char *run, const char *description)
+{
+  if(!condition)
+  {
+    printf("FAIL: %s: %s\n", run, description);
+    checks_failed++;
+  }
+}
+
+void log_snprintf(log_key_e, log_level_e, const char *format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  fprintf(stderr, "\n");
+  va_end(args);
+}
+
+/* Single threaded, the simulated interrupts never preempt a critical section */
+void critical_section_enter() {}
+void critical_section_exit() {}
+
+/* RC frame the drive strategy reads */
+static sl_cr_sbus_frame_s check_frame = {};
+
+uint32_t sl_cr_sbus_get_frame(sl_cr_sbus_frame_s *frame)
+{
+  *frame = check_frame;
+  return check_frame.sequence;
+}
+
+sl_cr_rc_channel_value_t sl_cr_sbus_get_frame_ch_value(const sl_cr_sbus_frame_s *frame, sl_cr_rc_channel_t channel)
+{
+  return (!frame->stale && (channel >= 1) && (channel <= SL_CR_SBUS_NUM_CH))?frame->ch[channel-1]:SL_CR_RC_CH_INVALID_VALUE;
+}
+
+static void set_throttle(sl_cr_rc_channel_value_t throttle)
+{
+  for(unsigned int c = 0; c < SL_CR_SBUS_NUM_CH; c++)
+  {
+    check_frame.ch[c] = SL_CR_RC_CH_CENTER_VALUE;
+  }
+  check_frame.ch[SL_CR_ARCADE_DRIVE_THROTTLE_CH-1] = throttle;
+  check_frame.sequence++;
+  check_frame.rx_time = micros();
+}
+
+/* First order motor turning a quadrature encoder through its pins */
+class motor_sim_c
+{
+  private:
+    const sl_cr_robot_motor_s &motor;
+    double                     rpm;
+    /* Position in counts, as the encoder sees it */
+    double                     position;
+    int64_t                    count;
+
+    void set_pins()
+    {
+      static const bool a[4] = {false, true, true, false};
+      static const bool b[4] = {false, false, true, true};
+      const unsigned int state = (unsigned int) (((count % 4) + 4) % 4);
+      sl_cr_host_set_pin(motor.encoder_a_pin, a[state]);
+      sl_cr_host_set_pin(motor.encoder_b_pin, b[state]);
+    }
+
+  public:
+    motor_sim_c(const sl_cr_robot_motor_s &motor) : motor(motor), rpm(0), position(0), count(0) {}
+
+    /* Advances model by dt (s) with driver output applied */
+    void step(rpm_t commanded, double dt)
+    {
+      static const double counts_per_rev = (double) sl_cr_robot_drv8256p_s::encoder_cpr * sl_cr_robot_drv8256p_s::encoder_gear_den /
+                                           sl_cr_robot_drv8256p_s::encoder_gear_num;
+
+      rpm      += ((commanded * CHECK_MOTOR_GAIN) - rpm) * (dt / CHECK_MOTOR_TAU);
+      position += (motor.encoder_reverse?-rpm:rpm) * counts_per_rev * dt / 60.0;
+
+      /* One edge per count, each changes one pin */
+      while(count < (int64_t) floor(position))
+      {
+        count++;
+        set_pins();
+      }
+      while(count > (int64_t) floor(position))
+      {
+        count--;
+        set_pins();
+      }
+    }
+
+    inline double get_rpm() const {return rpm;}
+};
+
+/* Motor stack layers of the drive subsystem under test */
+extern sl_cr_drive_motor_stack_storage_s drive_motor_stack_storage[SL_CR_DRIVE_MOTOR_COUNT];
+
+static inline sl_cr_host_motor_driver_c *get_driver(unsigned int m)
+{
+  return drive_motor_stack_storage[m].driver.get();
+}
+
+static const sl_cr_drive_data_s *drive;
+static motor_sim_c              *motor_sims[SL_CR_DRIVE_MOTOR_COUNT];
+static uint32_t                  next_task_us;
+/* Driver output changes since the last control loop task run, and the most seen in one task period since the counter was cleared */
+static rpm_t                     last_commanded[SL_CR_DRIVE_MOTOR_COUNT];
+static unsigned int              output_changes;
+static unsigned int              max_output_changes;
+
+/* Runs tasks, timer and motors for us */
+static void run(uint32_t us)
+{
+  for(uint32_t t = 0; t < us; t += CHECK_STEP_US)
+  {
+    if((int32_t) (micros() - next_task_us) >= 0)
+    {
+      /* Drive strategy task, then control loop task */
+      sl_cr_drive_strategy_loop();
+      sl_cr_drive_control_loop();
+      next_task_us += CHECK_TASK_PERIOD_US;
+      max_output_changes = (output_changes > max_output_changes)?output_changes:max_output_changes;
+      output_changes     = 0;
+    }
+
+    /* Timer ticks run here */
+    sl_cr_host_advance_us(CHECK_STEP_US);
+
+    for(unsigned int m = 0; m < SL_CR_DRIVE_MOTOR_COUNT; m++)
+    {
+      const rpm_t commanded = get_driver(m)->get_commanded_rpm();
+      output_changes   += (commanded != last_commanded[m])?1:0;
+      last_commanded[m] = commanded;
+      motor_sims[m]->step(commanded, CHECK_STEP_US / 1e6);
+    }
+  }
+}
+
+int main()
+{
+  drive = sl_cr_drive_init();
+  for(unsigned int m = 0; m < SL_CR_DRIVE_MOTOR_COUNT; m++)
+  {
+    static motor_sim_c sims[SL_CR_DRIVE_MOTOR_COUNT] = {sl_cr_robot_t::motors[0], sl_cr_robot_t::motors[1]};
+    motor_sims[m] = &sims[m];
+  }
+  sl_cr_drive_register_interrupts();
+
+  /* Armed, sticks neutral */
+  combat::clear_failsafe_mask(combat::FAILSAFE_BOOT);
+  combat::clear_failsafe_mask(combat::FAILSAFE_ARM_SWITCH_DISARM);
+  set_throttle(SL_CR_RC_CH_CENTER_VALUE);
+  next_task_us = micros();
+  run(CHECK_NEUTRAL_US);
+
+  /* Throttle step, received just before the next task period */
+  const char * const step_run = "throttle step";
+  run(CHECK_TASK_PERIOD_US - CHECK_STEP_US - (micros() - next_task_us + CHECK_TASK_PERIOD_US) % CHECK_TASK_PERIOD_US);
+  set_throttle(SL_CR_RC_CH_CENTER_VALUE + (sl_cr_rc_channel_value_t) ((SL_CR_RC_CH_MAX_VALUE - SL_CR_RC_CH_CENTER_VALUE) * CHECK_THROTTLE_SHARE));
+  max_output_changes = 0;
+  run(2 * CHECK_TASK_PERIOD_US);
+  const unsigned int step_updates = max_output_changes;
+  run(CHECK_STEP_HOLD_US - 2 * CHECK_TASK_PERIOD_US);
+
+  sl_cr_latency_stats_s stick_to_output;
+  sl_cr_latency_get_stats(SL_CR_LATENCY_STICK_TO_OUTPUT, &stick_to_output);
+  sl_cr_drive_fast_loop_stats_s fast_loop_stats;
+  sl_cr_drive_get_fast_loop_stats(&fast_loop_stats);
+
+  bool         settled    = true;
+  unsigned int task_calls = 0;
+  for(unsigned int m = 0; m < SL_CR_DRIVE_MOTOR_COUNT; m++)
+  {
+    const rpm_t  set_rpm = drive->motor_stack[m]->get_set_rpm();
+    const double error   = fabs(motor_sims[m]->get_rpm() - set_rpm);
+    printf("%-14s set %4d rpm, motor %7.1f rpm, encoder %4d rpm, %u driver loops\n", sl_cr_robot_t::motors[m].name, (int) set_rpm,
+      motor_sims[m]->get_rpm(), (int) drive->motor_stack[m]->get_real_rpm(), get_driver(m)->get_loops());
+    settled     = settled && (set_rpm > 0) && (error <= (set_rpm * CHECK_SETTLE_PERCENT / 100.0));
+    task_calls += get_driver(m)->get_task_calls();
+  }
+  printf("%-14s %u timer ticks at %uHz, up to %u driver output changes in one %ums task period after the step\n", step_run,
+    fast_loop_stats.count, (unsigned int) SL_CR_FAST_CONTROL_LOOP_RATE, step_updates, CHECK_TASK_PERIOD_US / 1000);
+  printf("%-14s stick-to-output last %uus max %uus over %u frames\n", step_run, (unsigned int) stick_to_output.last,
+    (unsigned int) stick_to_output.max, stick_to_output.count);
+
+  check(0 == task_calls, step_run, "only the timer calls the motor drivers");
+  check(get_driver(0)->get_loops() == fast_loop_stats.count, step_run, "motor drivers run on every timer tick");
+  check(step_updates >= CHECK_MIN_STEP_UPDATES, step_run, "driver outputs follow the PID at the timer rate");
+  check(settled, step_run, "speed settles on the set point");
+  /* Frames arrive one model step ahead of the drive strategy task */
+  check((stick_to_output.count > 0) && (stick_to_output.max <= (CHECK_STEP_US + SL_CR_FAST_CONTROL_LOOP_PERIOD_US)), step_run,
+        "stick-to-output within one timer period of the drive strategy");
+
+  /* Failsafe entered between timer ticks */
+  const char * const failsafe_run = "failsafe";
+  run(CHECK_FAILSAFE_SKEW_US);
+  const uint32_t failsafe_us = micros();
+  combat::set_failsafe_mask(combat::FAILSAFE_SBUS);
+  bool off = false;
+  while(!off && ((micros() - failsafe_us) <= (10 * SL_CR_FAST_CONTROL_LOOP_PERIOD_US)))
+  {
+    run(CHECK_STEP_US);
+    off = true;
+    for(unsigned int m = 0; m < SL_CR_DRIVE_MOTOR_COUNT; m++)
+    {
+      off = off && (0 == get_driver(m)->get_commanded_rpm());
+    }
+  }
+  const uint32_t off_us = micros() - failsafe_us;
+
+  sl_cr_latency_stats_s failsafe_to_off;
+  sl_cr_latency_get_stats(SL_CR_LATENCY_FAILSAFE_TO_OFF, &failsafe_to_off);
+  printf("%-14s outputs off after %uus, failsafe-to-off measured %uus\n", failsafe_run, (unsigned int) off_us,
+    (unsigned int) failsafe_to_off.last);
+  check(off && (off_us <= SL_CR_FAST_CONTROL_LOOP_PERIOD_US), failsafe_run, "outputs off within one timer period");
+  check((1 == failsafe_to_off.count) && (failsafe_to_off.last <= SL_CR_FAST_CONTROL_LOOP_PERIOD_US), failsafe_run,
+        "failsafe-to-off measured within one timer period");
+
+  printf("%s\n", (0 == checks_failed)?"ok":"FAIL");
+
+  return (0 == checks_failed)?0:1;
+}
@@ -0,0 +1,185 @@
+/*
+  sl_cr_fixed_pid_check.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+/* Host check of sl_cr_fixed_pid_c against a double precision PID with the same control law, closing the loop around a first order
+     motor model on a set point step.  Run at the 10ms tuning period and at the 1ms cyclic executive and 250us fast control loop
+     periods, so both fixed point error and the period scaling of the gains are checked.
+     Build:  g++ -std=c++17 -I. -I<sl-robot>/src -o sl_cr_fixed_pid_check tools/sl_cr_fixed_pid_check.cpp sl_cr_fixed_pid.cpp
+     Usage:  sl_cr_fixed_pid_check
+   Exits non-zero if the fixed point loop differs from the reference beyond tolerance at any period, or if the step response at a
+     fast period differs from the step response at the tuning period beyond tolerance. */
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "sl_cr_fixed_pid.hpp"
+
+using namespace sandor_laboratories::robot;
+
+/* Gains, limits and motor output range of sl_cr_robot_drv8256p_s */
+static const pid_loop_params_s pid_params = {50, 100, 25, 100, 12, 100};
+#define CHECK_MAX_RPM    1000
+#define CHECK_MAX_OUTPUT 1023
+
+/* First order motor: steady state rpm per output unit and time constant (s) */
+#define CHECK_MOTOR_GAIN (1000.0 / 1023.0)
+#define CHECK_MOTOR_TAU  0.05
+
+/* Simulated time (s) and set point step (rpm) */
+#define CHECK_DURATION 1.0
+#define CHECK_STEP_RPM 500
+
+/* Largest allowed difference to the reference, in output units and rpm */
+#define CHECK_OUTPUT_TOLERANCE 8
+#define CHECK_RPM_TOLERANCE    4
+/* Largest allowed rpm difference of a fast period step response to the tuning period response */
+#define CHECK_RATE_TOLERANCE   (CHECK_STEP_RPM / 10)
+
+/* Log output of the PID under test */
+void log_snprintf(log_key_e, log_level_e, const char *format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  fprintf(stderr, "\n");
+  va_end(args);
+}
+
+/* Reference, same control law as sl_cr_fixed_pid_c in double precision with gains in per second units */
+class reference_pid_c
+{
+  private:
+    const double dt;
+    const double kp;
+    const double ki;
+    const double kd;
+    const double d_alpha;
+    double       integral;
+    double       derivative;
+    double       last_measured;
+    bool         primed;
+
+  public:
+    reference_pid_c(const pid_loop_params_s &params, double dt)
+      : dt(dt),
+        kp((double) params.p_num / params.p_den),
+        ki(((double) params.i_num / params.i_den) / (SL_CR_FIXED_PID_TUNING_PERIOD / 1e6)),
+        kd(((double) params.d_num / params.d_den) * (SL_CR_FIXED_PID_TUNING_PERIOD / 1e6)),
+        d_alpha(dt / (dt + (SL_CR_FIXED_PID_TUNING_PERIOD / 1e6) * ((1 << SL_CR_FIXED_PID_D_FILTER_SHIFT) - 1))),
+        integral(0), derivative(0), last_measured(0), primed(false)
+    {
+    }
+
+    double loop(double set_point, double measured)
+    {
+      const double error = set_point - measured;
+
+      if(primed)
+      {
+        derivative += (-kd * (measured - last_measured) / dt - derivative) * d_alpha;
+      }
+      last_measured = measured;
+      primed        = true;
+
+      const double next_integral = fmax(-CHECK_MAX_OUTPUT, fmin(CHECK_MAX_OUTPUT, integral + ki * dt * error));
+      double       output        = kp * error + next_integral + derivative;
+      if(output > CHECK_MAX_OUTPUT)
+      {
+        output = CHECK_MAX_OUTPUT;
+        integral = (error < 0)?next_integral:integral;
+      }
+      else if(output < -CHECK_MAX_OUTPUT)
+      {
+        output = -CHECK_MAX_OUTPUT;
+        integral = (error > 0)?next_integral:integral;
+      }
+      else
+      {
+        integral = next_integral;
+      }
+
+      return output;
+    }
+};
+
+/* Motor speed after holding output for dt */
+static double motor_step(double rpm, double output, double dt)
+{
+  const double target = output * CHECK_MOTOR_GAIN;
+  return target + (rpm - target) * exp(-dt / CHECK_MOTOR_TAU);
+}
+
+/* Runs both loops at one period, stores fixed point loop rpm every tuning period.  Returns false if out of tolerance */
+static bool check_period(uint32_t period_us, double *rpm_trace, unsigned int trace_length)
+{
+  const double       dt    = period_us / 1e6;
+  const unsigned int steps = (unsigned int) (CHECK_DURATION / dt);
+  const unsigned int trace_every = SL_CR_FIXED_PID_TUNING_PERIOD / period_us;
+
+  sl_cr_fixed_pid_c fixed(-CHECK_MAX_RPM, CHECK_MAX_RPM, -CHECK_MAX_OUTPUT, CHECK_MAX_OUTPUT, pid_params, LOG_KEY_BOOT, period_us);
+  reference_pid_c   reference(pid_params, dt);
+
+  double fixed_rpm = 0;
+  double reference_rpm = 0;
+  double max_output_error = 0;
+  double max_rpm_error = 0;
+
+  for(unsigned int s = 0; s < steps; s++)
+  {
+    /* Encoder measures whole rpm */
+    const rpm_t  measured         = (rpm_t) lround(fixed_rpm);
+    const rpm_t  fixed_output     = fixed.loop(CHECK_STEP_RPM, measured);
+    const double reference_output = reference.loop(CHECK_STEP_RPM, lround(reference_rpm));
+
+    max_output_error = fmax(max_output_error, fabs(fixed_output - reference_output));
+    max_rpm_error    = fmax(max_rpm_error, fabs(fixed_rpm - reference_rpm));
+
+    if((0 == (s % trace_every)) && ((s / trace_every) < trace_length))
+    {
+      rpm_trace[s / trace_every] = fixed_rpm;
+    }
+
+    fixed_rpm     = motor_step(fixed_rpm, fixed_output, dt);
+    reference_rpm = motor_step(reference_rpm, reference_output, dt);
+  }
+
+  const bool ret_val = (max_output_error <= CHECK_OUTPUT_TOLERANCE) && (max_rpm_error <= CHECK_RPM_TOLERANCE);
+  printf("%6uus: fixed vs reference max output error %6.2f, max rpm error %6.2f, final rpm %7.2f  %s\n",
+    period_us, max_output_error, max_rpm_error, fixed_rpm, ret_val?"ok":"FAIL");
+
+  return ret_val;
+}
+
+int main()
+{
+  const uint32_t     periods[] = {SL_CR_FIXED_PID_TUNING_PERIOD, 1000, 250};
+  const unsigned int trace_length = (unsigned int) (CHECK_DURATION * 1e6 / SL_CR_FIXED_PID_TUNING_PERIOD);
+  static double      traces[sizeof(periods) / sizeof(periods[0])][(unsigned int) (CHECK_DURATION * 1e6 / SL_CR_FIXED_PID_TUNING_PERIOD)];
+  bool               ret_val = true;
+
+  for(unsigned int p = 0; p < (sizeof(periods) / sizeof(periods[0])); p++)
+  {
+    ret_val = check_period(periods[p], traces[p], trace_length) && ret_val;
+  }
+
+  /* Faster loops should track the tuned response, not a de-tuned one */
+  for(unsigned int p = 1; p < (sizeof(periods) / sizeof(periods[0])); p++)
+  {
+    double max_difference = 0;
+    for(unsigned int t = 0; t < trace_length; t++)
+    {
+      max_difference = fmax(max_difference, fabs(traces[p][t] - traces[0][t]));
+    }
+    const bool within = (max_difference <= CHECK_RATE_TOLERANCE);
+    printf("%6uus: step response vs %uus max rpm difference %6.2f  %s\n",
+      periods[p], SL_CR_FIXED_PID_TUNING_PERIOD, max_difference, within?"ok":"FAIL");
+    ret_val = within && ret_val;
+  }
+
+  return ret_val?0:1;
+}
@@ -0,0 +1,467 @@
+/*
+  sl_cr_latency_check.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+/* Host check of sl_cr_latency.  Runs the stick-to-output path on simulated time, with RC frames at the SBUS period, the drive strategy
+     applying each frame after a random scheduling delay and the control loop completing at its period, and compares the recorded
+     statistics to an independent model of the same timeline.  Then checks tag replacement, completing without a tag, the tag sentinel,
+     the over-budget count and histogram overflow, and a tag spanning the microsecond counter wrap.  Then starts, completes and reads
+     one path from three threads at once.  Then enters failsafe inside a cyclic executive slot, running the real failsafe and drive
+     subsystem on the host robot with a failsafe hook that requests the control loop slot as sl-combat-robot.ino does, and checks that
+     outputs are off and failsafe-to-off measured as soon as that slot returns, without re-entering the control loop.  Finally times
+     start and complete.
+     Build:  g++ -std=c++17 -O2 -pthread -I. -Itools/host -I<sl-robot>/src -D_CYCLIC_EXECUTIVE_ -DSL_CR_ROBOT=sl_cr_robot_host_s
+               -include tools/host/sl_cr_robot_host.hpp -o sl_cr_latency_check tools/sl_cr_latency_check.cpp sl_cr_latency.cpp
+               sl_cr_drive.cpp sl_cr_encoder.cpp sl_cr_failsafe.cpp sl_cr_fixed_pid.cpp sl_cr_rc_map.cpp
+     Usage:  sl_cr_latency_check
+   Exits non-zero if any check fails. */
+
+#include <Arduino.h>
+#include <atomic>
+#include <chrono>
+#include <stdarg.h>
+#include <stdio.h>
+#include <thread>
+
+#include "sl_cr_drive.hpp"
+#include "sl_cr_failsafe.hpp"
+#include "sl_cr_latency.hpp"
+
+#ifndef _CYCLIC_EXECUTIVE_
+#error "Build with -D_CYCLIC_EXECUTIVE_"
+#endif
+
+using namespace sandor_laboratories::robot;
+
+/* Simulated run: SBUS frame period and jitter, longest drive strategy scheduling delay, all in us */
+#define CHECK_DURATION        10000000
+#define CHECK_STEP            10
+#define CHECK_FRAME_PERIOD    14000
+#define CHECK_FRAME_JITTER    500
+#define CHECK_STRATEGY_DELAY  2000
+#define CHECK_SEED            0x1A7E
+/* Starts in the concurrent run, starting thread yields every CHECK_THREAD_YIELD starts so a single core host interleaves threads too */
+#define CHECK_THREAD_STARTS   2000000
+#define CHECK_THREAD_YIELD    8
+/* Failsafe entry: minor frames run before it, time spent in the entering slot before and after failsafe is set (us) */
+#define CHECK_FAILSAFE_FRAMES 40
+#define CHECK_SLOT_BEFORE_US  80
+#define CHECK_SLOT_AFTER_US   120
+/* Timed calls */
+#define BENCH_CALLS           10000000
+
+static unsigned int checks_failed = 0;
+
+static void check(bool condition, const char *run, const char *description)
+{
+  if(!condition)
+  {
+    printf("FAIL: %s: %s\n", run, description);
+    checks_failed++;
+  }
+}
+
+/* Small deterministic generator, so failures reproduce */
+static uint32_t random_state = CHECK_SEED;
+static uint32_t random_next()
+{
+  random_state = random_state * 1103515245 + 12345;
+  return random_state >> 8;
+}
+
+void log_snprintf(log_key_e, log_level_e, const char *format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  vprintf(format, args);
+  printf("\n");
+  va_end(args);
+}
+
+/* Only the failsafe run takes critical sections, from one thread */
+void critical_section_enter() {}
+void critical_section_exit() {}
+
+/* RC frame the drive strategy reads */
+static sl_cr_sbus_frame_s check_frame = {};
+
+uint32_t sl_cr_sbus_get_frame(sl_cr_sbus_frame_s *frame)
+{
+  *frame = check_frame;
+  return check_frame.sequence;
+}
+
+sl_cr_rc_channel_value_t sl_cr_sbus_get_frame_ch_value(const sl_cr_sbus_frame_s *frame, sl_cr_rc_channel_t channel)
+{
+  return (!frame->stale && (channel >= 1) && (channel <= SL_CR_SBUS_NUM_CH))?frame->ch[channel-1]:SL_CR_RC_CH_INVALID_VALUE;
+}
+
+/* Measurements recorded since a snapshot */
+static sl_cr_latency_stats_s stats_since(sl_cr_latency_e path, const sl_cr_latency_stats_s &before)
+{
+  sl_cr_latency_stats_s ret_val;
+
+  sl_cr_latency_get_stats(path, &ret_val);
+  ret_val.count       -= before.count;
+  ret_val.over_budget -= before.over_budget;
+  for(unsigned int b = 0; b < SL_CR_LATENCY_HISTOGRAM_BINS; b++)
+  {
+    ret_val.histogram[b] -= before.histogram[b];
+  }
+
+  return ret_val;
+}
+
+static unsigned int histogram_bin(sl_cr_time_us_t latency)
+{
+  const unsigned int bin = latency / SL_CR_LATENCY_HISTOGRAM_BIN_WIDTH;
+  return (bin < SL_CR_LATENCY_HISTOGRAM_BINS)?bin:(SL_CR_LATENCY_HISTOGRAM_BINS-1);
+}
+
+/* Stick-to-output on simulated time against a model of the same timeline */
+static void check_stick_to_output()
+{
+  const char * const    run = "stick-to-output";
+  const sl_cr_time_us_t control_period = SL_CR_CONTROL_LOOP_PERIOD * 1000;
+  sl_cr_latency_stats_s before;
+  sl_cr_latency_stats_s expected = {};
+  sl_cr_time_us_t       next_frame    = micros() + CHECK_FRAME_PERIOD;
+  sl_cr_time_us_t       next_strategy = UINT32_MAX;
+  sl_cr_time_us_t       next_control  = micros() + control_period;
+  sl_cr_time_us_t       frame_rx_time = 0;
+  sl_cr_time_us_t       model_tag     = 0;
+  bool                  model_pending = false;
+  const sl_cr_time_us_t end = micros() + CHECK_DURATION;
+
+  sl_cr_latency_get_stats(SL_CR_LATENCY_STICK_TO_OUTPUT, &before);
+
+  while((int32_t) (end - micros()) > 0)
+  {
+    sl_cr_host_advance_us(CHECK_STEP);
+    const sl_cr_time_us_t now = micros();
+
+    if(now == next_frame)
+    {
+      /* Frame received, drive strategy applies it after its scheduling delay */
+      frame_rx_time = now;
+      next_strategy = now + (random_next() % (CHECK_STRATEGY_DELAY / CHECK_STEP)) * CHECK_STEP;
+      next_frame    = now + CHECK_FRAME_PERIOD + (random_next() % (CHECK_FRAME_JITTER / CHECK_STEP)) * CHECK_STEP;
+    }
+    if(now == next_strategy)
+    {
+      sl_cr_latency_start(SL_CR_LATENCY_STICK_TO_OUTPUT, frame_rx_time);
+      model_tag     = frame_rx_time;
+      model_pending = true;
+    }
+    if(now == next_control)
+    {
+      sl_cr_latency_complete(SL_CR_LATENCY_STICK_TO_OUTPUT);
+      if(model_pending)
+      {
+        const sl_cr_time_us_t latency = now - model_tag;
+        expected.count++;
+        expected.last = latency;
+        expected.max  = (latency > expected.max)?latency:expected.max;
+        expected.over_budget += (latency > SL_CR_LATENCY_STICK_TO_OUTPUT_BUDGET)?1:0;
+        expected.histogram[histogram_bin(latency)]++;
+        model_pending = false;
+      }
+      next_control += control_period;
+    }
+  }
+
+  const sl_cr_latency_stats_s recorded = stats_since(SL_CR_LATENCY_STICK_TO_OUTPUT, before);
+  bool                        histogram_equal = true;
+  for(unsigned int b = 0; b < SL_CR_LATENCY_HISTOGRAM_BINS; b++)
+  {
+    histogram_equal = histogram_equal && (recorded.histogram[b] == expected.histogram[b]);
+  }
+
+  printf("%-28s %u frames output, last %uus, max %uus (budget %uus), over budget %u\n", run, recorded.count, recorded.last,
+    recorded.max, sl_cr_latency_get_budget(SL_CR_LATENCY_STICK_TO_OUTPUT), recorded.over_budget);
+  check(expected.count > 0, run, "frames were output");
+  check((recorded.count == expected.count) && (recorded.last == expected.last) && (recorded.max == expected.max), run,
+        "count, last and max match model");
+  check(histogram_equal, run, "histogram matches model");
+  check(0 == recorded.over_budget, run, "strategy delay plus control period is within budget");
+  check(recorded.max <= (CHECK_STRATEGY_DELAY + control_period), run, "worst case bounded by strategy delay plus control period");
+}
+
+/* Single measurements on the disarm path */
+static void check_cases()
+{
+  const char * const    run = "disarm-to-off";
+  const sl_cr_latency_e path = SL_CR_LATENCY_DISARM_TO_OFF;
+  sl_cr_latency_stats_s before;
+  sl_cr_latency_stats_s after;
+
+  /* Completing without a tag records nothing */
+  sl_cr_latency_get_stats(path, &before);
+  sl_cr_latency_complete(path);
+  after = stats_since(path, before);
+  check(0 == after.count, run, "no tag, no measurement");
+
+  /* Newer frame replaces an incomplete tag, one measurement of the newer frame */
+  sl_cr_latency_get_stats(path, &before);
+  sl_cr_latency_start(path, micros());
+  sl_cr_host_advance_us(3000);
+  sl_cr_latency_start(path, micros());
+  sl_cr_host_advance_us(1000);
+  sl_cr_latency_complete(path);
+  sl_cr_latency_complete(path);
+  after = stats_since(path, before);
+  check((1 == after.count) && (1000 == after.last) && (1 == after.histogram[0]), run, "newer tag replaces older, taken once");
+
+  /* Over budget, and beyond the histogram range into the last bin */
+  sl_cr_latency_get_stats(path, &before);
+  sl_cr_latency_start(path, micros());
+  sl_cr_host_advance_us(SL_CR_LATENCY_DISARM_TO_OFF_BUDGET + 1);
+  sl_cr_latency_complete(path);
+  sl_cr_latency_start(path, micros());
+  sl_cr_host_advance_us(SL_CR_LATENCY_HISTOGRAM_BINS * SL_CR_LATENCY_HISTOGRAM_BIN_WIDTH * 4);
+  sl_cr_latency_complete(path);
+  after = stats_since(path, before);
+  check((2 == after.count) && (2 == after.over_budget) && (1 == after.histogram[SL_CR_LATENCY_HISTOGRAM_BINS-1]), run,
+        "over budget counted, long latency in last bin");
+
+  /* Frame received at the sentinel time is still measured */
+  sl_cr_host_advance_us(UINT32_MAX - micros());
+  sl_cr_latency_get_stats(path, &before);
+  sl_cr_latency_start(path, micros());
+  sl_cr_host_advance_us(1500);
+  sl_cr_latency_complete(path);
+  after = stats_since(path, before);
+  check((1 == after.count) && (1501 == after.last), run, "frame at sentinel time measured 1us long, across the wrap");
+
+  /* Tag before, completion after the microsecond counter wraps */
+  sl_cr_host_advance_us((UINT32_MAX - 700) - micros());
+  sl_cr_latency_get_stats(path, &before);
+  sl_cr_latency_start(path, micros());
+  sl_cr_host_advance_us(1200);
+  sl_cr_latency_complete(path);
+  after = stats_since(path, before);
+  check((1 == after.count) && (1200 == after.last), run, "latency across microsecond wrap");
+
+  printf("%-28s replacement, budget, histogram overflow, sentinel and wrap cases checked\n", run);
+}
+
+/* One thread starting, one completing and one reading a path at once */
+static void check_concurrent()
+{
+  const char * const    run = "failsafe-to-off, 3 threads";
+  const sl_cr_latency_e path = SL_CR_LATENCY_FAILSAFE_TO_OFF;
+  const sl_cr_time_us_t now = micros();
+  sl_cr_latency_stats_s before;
+  std::atomic<unsigned int> ready(0);
+  std::atomic<bool>     starting(true);
+  std::atomic<bool>     completing(true);
+  unsigned int          inconsistent = 0;
+  unsigned int          reads = 0;
+
+  sl_cr_latency_get_stats(path, &before);
+
+  /* Every tag is within budget of the fixed completion time */
+  std::thread starter([&]() {
+    ready++;
+    while(ready < 3) {}
+    for(unsigned int i = 0; i < CHECK_THREAD_STARTS; i++)
+    {
+      sl_cr_latency_start(path, now - (i % SL_CR_LATENCY_FAILSAFE_TO_OFF_BUDGET));
+      if(0 == (i % CHECK_THREAD_YIELD))
+      {
+        std::this_thread::yield();
+      }
+    }
+    starting = false;
+  });
+  std::thread completer([&]() {
+    ready++;
+    while(starting)
+    {
+      sl_cr_latency_complete(path);
+      std::this_thread::yield();
+    }
+    sl_cr_latency_complete(path);
+    completing = false;
+  });
+  std::thread reader([&]() {
+    unsigned int last_count = before.count;
+    ready++;
+    while(completing)
+    {
+      sl_cr_latency_stats_s stats;
+      unsigned int          histogram_count = 0;
+
+      sl_cr_latency_get_stats(path, &stats);
+      for(unsigned int b = 0; b < SL_CR_LATENCY_HISTOGRAM_BINS; b++)
+      {
+        histogram_count += stats.histogram[b];
+      }
+      inconsistent += ((histogram_count != stats.count) || (stats.last > stats.max) || (stats.count < last_count))?1:0;
+      last_count    = stats.count;
+      reads++;
+      std::this_thread::yield();
+    }
+  });
+
+  starter.join();
+  completer.join();
+  reader.join();
+
+  const sl_cr_latency_stats_s after = stats_since(path, before);
+
+  printf("%-28s %u starts, %u measured, %u reads, %u inconsistent, max %uus\n", run, CHECK_THREAD_STARTS, after.count, reads,
+    inconsistent, after.max);
+  check((after.count > 0) && (after.count <= CHECK_THREAD_STARTS), run, "each tag measured at most once");
+  check(0 == inconsistent, run, "readers only see whole updates");
+  check((0 == after.over_budget) && (after.max < SL_CR_LATENCY_FAILSAFE_TO_OFF_BUDGET), run, "no torn or invented tags");
+}
+
+/* Motor stack layers of the drive subsystem under test */
+extern sl_cr_drive_motor_stack_storage_s drive_motor_stack_storage[SL_CR_DRIVE_MOTOR_COUNT];
+
+/* Failsafe entry slot (0 none, else schedule index + 1), control loop nesting, and deepest nesting seen */
+static unsigned int failsafe_entry_slot = 0;
+static unsigned int control_loop_depth  = 0;
+static unsigned int control_loop_depth_max = 0;
+
+/* Spends slot time around failsafe entry when this slot is the one entering it */
+static void check_slot_failsafe_entry(unsigned int slot)
+{
+  if((slot + 1) == failsafe_entry_slot)
+  {
+    failsafe_entry_slot = 0;
+    sl_cr_host_advance_us(CHECK_SLOT_BEFORE_US);
+    combat::set_failsafe_mask(combat::FAILSAFE_SBUS);
+    sl_cr_host_advance_us(CHECK_SLOT_AFTER_US);
+  }
+}
+
+static void check_control_loop_slot()
+{
+  control_loop_depth++;
+  control_loop_depth_max = (control_loop_depth > control_loop_depth_max)?control_loop_depth:control_loop_depth_max;
+  sl_cr_drive_control_loop();
+  check_slot_failsafe_entry(0);
+  control_loop_depth--;
+}
+
+static void check_strategy_slot()
+{
+  sl_cr_drive_strategy_loop();
+}
+
+static void check_rc_slot()
+{
+  check_slot_failsafe_entry(2);
+}
+
+/* Same layout as sl-combat-robot.ino, control loop first and every minor frame */
+static const sl_cr_cyclic_executive_slot_s check_schedule[] =
+{
+  {"Control Loop",   check_control_loop_slot, 1, 0},
+  {"Drive Strategy", check_strategy_slot,     5, 1},
+  {"RC & Failsafe",  check_rc_slot,          10, 2},
+};
+static sl_cr_cyclic_executive_c<3> check_executive(check_schedule);
+
+static void check_failsafe_hook()
+{
+  check_executive.request_run(0);
+}
+
+/* Failsafe entered inside an executive slot, outputs off once that slot returns */
+static void check_failsafe_to_off()
+{
+  static const char * const entry_names[] = {"failsafe in control loop", "failsafe in RC slot"};
+  static const unsigned int entry_slots[] = {1, 3};
+
+  sl_cr_drive_init();
+  combat::register_failsafe_hook(check_failsafe_hook);
+  for(unsigned int c = 0; c < SL_CR_SBUS_NUM_CH; c++)
+  {
+    check_frame.ch[c] = SL_CR_RC_CH_CENTER_VALUE;
+  }
+  combat::clear_failsafe_mask(combat::FAILSAFE_BOOT);
+  combat::clear_failsafe_mask(combat::FAILSAFE_ARM_SWITCH_DISARM);
+
+  for(unsigned int e = 0; e < (sizeof(entry_slots) / sizeof(entry_slots[0])); e++)
+  {
+    const char * const    run = entry_names[e];
+    sl_cr_latency_stats_s before;
+    bool                  driving = true;
+    bool                  off     = true;
+
+    combat::clear_failsafe_mask(combat::FAILSAFE_SBUS);
+    sl_cr_latency_get_stats(SL_CR_LATENCY_FAILSAFE_TO_OFF, &before);
+
+    /* Failsafe in the last major frame, on the entering slot's frame */
+    const unsigned int entry_frame = CHECK_FAILSAFE_FRAMES - check_executive.get_major_frame() + check_schedule[entry_slots[e] - 1].offset;
+    for(unsigned int f = 0; f < CHECK_FAILSAFE_FRAMES; f++)
+    {
+      /* Sticks neutral for a major frame, so the drive strategy engages, then full throttle */
+      check_frame.ch[SL_CR_ARCADE_DRIVE_THROTTLE_CH-1] = (f < check_executive.get_major_frame())?SL_CR_RC_CH_CENTER_VALUE:SL_CR_RC_CH_MAX_VALUE;
+      check_frame.rx_time = micros();
+      check_frame.sequence++;
+      failsafe_entry_slot = (entry_frame == f)?entry_slots[e]:0;
+      check_executive.minor_frame();
+
+      for(unsigned int m = 0; m < SL_CR_DRIVE_MOTOR_COUNT; m++)
+      {
+        const rpm_t commanded = drive_motor_stack_storage[m].driver.get()->get_commanded_rpm();
+        driving = driving && (((entry_frame - 1) != f) || (0 != commanded));
+        off     = off && ((f < entry_frame) || (0 == commanded));
+      }
+      sl_cr_host_advance_us((SL_CR_CYCLIC_EXECUTIVE_MINOR_FRAME * 1000) - (micros() % (SL_CR_CYCLIC_EXECUTIVE_MINOR_FRAME * 1000)));
+    }
+
+    const sl_cr_latency_stats_s after = stats_since(SL_CR_LATENCY_FAILSAFE_TO_OFF, before);
+    printf("%-28s measured %uus, %uus left in the entering slot, control loop nesting %u\n", run, (unsigned int) after.last,
+      CHECK_SLOT_AFTER_US, control_loop_depth_max);
+    check(driving, run, "motors driven before failsafe");
+    check(combat::get_failsafe_set(), run, "failsafe entered");
+    check(off, run, "outputs off when the entering slot returns");
+    check((1 == after.count) && (CHECK_SLOT_AFTER_US == after.last), run, "failsafe-to-off measured when the entering slot returns");
+    check(after.last < (SL_CR_CYCLIC_EXECUTIVE_MINOR_FRAME * 1000), run, "failsafe-to-off within one minor frame");
+    check(1 == control_loop_depth_max, run, "control loop never re-entered");
+  }
+}
+
+/* ns per call of f */
+template <typename call_f>
+static double time_calls(call_f call)
+{
+  const auto start = std::chrono::steady_clock::now();
+
+  for(unsigned int i = 0; i < BENCH_CALLS; i++)
+  {
+    call(i);
+  }
+
+  const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / BENCH_CALLS;
+}
+
+int main()
+{
+  check_stick_to_output();
+  check_cases();
+  check_concurrent();
+  check_failsafe_to_off();
+
+  const double idle_ns     = time_calls([](unsigned int) {sl_cr_latency_complete(SL_CR_LATENCY_DISARM_TO_OFF);});
+  const double start_ns    = time_calls([](unsigned int i) {sl_cr_latency_start(SL_CR_LATENCY_DISARM_TO_OFF, micros() - (i & 0xFF));});
+  const double measured_ns = time_calls([](unsigned int i) {
+    sl_cr_latency_start(SL_CR_LATENCY_DISARM_TO_OFF, micros() - (i & 0xFF));
+    sl_cr_latency_complete(SL_CR_LATENCY_DISARM_TO_OFF);
+  });
+  printf("complete without tag %5.2f ns, start %5.2f ns, start and complete %5.2f ns (host)\n", idle_ns, start_ns, measured_ns);
+
+  sl_cr_latency_log_stats(LOG_KEY_BOOT);
+  printf("%s\n", (0 == checks_failed)?"ok":"FAIL");
+
+  return (0 == checks_failed)?0:1;
+}
@@ -0,0 +1,286 @@
+/*
+  sl_cr_mixer_check.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+/* Host check and microbenchmark of sl_cr_mixer_c.  Checks each preset matrix on known stick positions, then every preset over a
+     pseudo random input sweep: unsaturated outputs are the exact matrix product, saturated outputs stay in range and keep the ratios
+     between outputs.  Then times the arcade mix and rpm scaling against the per-motor add and clip arcade drive used before the mixer,
+     and against arcade compiled for its unit coefficients (sum and difference, same saturation), which splits the mixer's cost between
+     the runtime matrix and saturating with the ratios kept.
+     Host timings only rank the paths, cycle counts on target come from the drive task profiler statistics.
+     Build:  g++ -std=c++17 -O2 -I. -Itools/host -I<sl-robot>/src -o sl_cr_mixer_check tools/sl_cr_mixer_check.cpp
+     Usage:  sl_cr_mixer_check
+   Exits non-zero if any check fails. */
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sl_cr_mixer.hpp"
+
+/* Random inputs per preset */
+#define CHECK_SWEEP      100000
+/* Largest allowed error of a saturated output against the exact ratio preserving value (Q12) */
+#define CHECK_RATIO_TOLERANCE 2
+/* Timed frames and motor rpm range */
+#define BENCH_SAMPLES    4096
+#define BENCH_ITERATIONS 500
+#define BENCH_ROUNDS     8
+#define BENCH_MAX_RPM    1000
+#define CHECK_SEED       0x313C
+
+static unsigned int checks_failed = 0;
+
+static void check(bool condition, const char *run, const char *description)
+{
+  if(!condition)
+  {
+    printf("FAIL: %s: %s\n", run, description);
+    checks_failed++;
+  }
+}
+
+/* Small deterministic generator, so failures reproduce */
+static uint32_t random_state = CHECK_SEED;
+static uint32_t random_next()
+{
+  random_state = random_state * 1103515245 + 12345;
+  return random_state >> 8;
+}
+
+static sl_cr_rc_norm_t random_norm()
+{
+  return (sl_cr_rc_norm_t) ((int32_t) (random_next() % (2*SL_CR_RC_NORM_MAX + 1)) - SL_CR_RC_NORM_MAX);
+}
+
+template <unsigned int inputs, unsigned int outputs>
+static void check_mix(const sl_cr_mixer_c<inputs,outputs> &mixer, const sl_cr_rc_norm_t (&in)[inputs],
+                      const sl_cr_rc_norm_t (&expected)[outputs], const char *run)
+{
+  sl_cr_rc_norm_t out[outputs];
+  bool            equal = true;
+
+  mixer.mix(in, out);
+  for(unsigned int o = 0; o < outputs; o++)
+  {
+    equal = equal && (out[o] == expected[o]);
+  }
+  check(equal, run, "known stick position");
+}
+
+/* Random sweep of one preset */
+template <unsigned int inputs, unsigned int outputs>
+static void check_sweep(const sl_cr_mixer_matrix_t<inputs,outputs> &matrix, const char *run)
+{
+  const sl_cr_mixer_c<inputs,outputs> mixer(matrix);
+  unsigned int                        saturated = 0;
+  unsigned int                        out_of_range = 0;
+  unsigned int                        inexact = 0;
+  unsigned int                        short_of_full = 0;
+  int32_t                             max_ratio_error = 0;
+
+  for(unsigned int s = 0; s < CHECK_SWEEP; s++)
+  {
+    sl_cr_rc_norm_t in[inputs];
+    sl_cr_rc_norm_t out[outputs];
+    int32_t         exact[outputs];
+    int32_t         peak = SL_CR_RC_NORM_MAX;
+
+    for(unsigned int i = 0; i < inputs; i++)
+    {
+      in[i] = random_norm();
+    }
+    for(unsigned int o = 0; o < outputs; o++)
+    {
+      int32_t accumulator = 0;
+      for(unsigned int i = 0; i < inputs; i++)
+      {
+        accumulator += ((int32_t) in[i]) * matrix[o][i];
+      }
+      exact[o] = accumulator >> SL_CR_RC_NORM_SHIFT;
+      peak     = (abs(exact[o]) > peak)?abs(exact[o]):peak;
+    }
+
+    mixer.mix(in, out);
+
+    int32_t out_peak = 0;
+    for(unsigned int o = 0; o < outputs; o++)
+    {
+      out_peak      = (abs(out[o]) > out_peak)?abs(out[o]):out_peak;
+      out_of_range += (abs(out[o]) > SL_CR_RC_NORM_MAX)?1:0;
+      if(peak > SL_CR_RC_NORM_MAX)
+      {
+        /* Every output scaled by the same factor as the largest */
+        const int32_t scaled = (int32_t) (((int64_t) exact[o] * SL_CR_RC_NORM_MAX) / peak);
+        const int32_t error  = abs(out[o] - scaled);
+        max_ratio_error = (error > max_ratio_error)?error:max_ratio_error;
+      }
+      else
+      {
+        inexact += (out[o] != exact[o])?1:0;
+      }
+    }
+    saturated     += (peak > SL_CR_RC_NORM_MAX)?1:0;
+    short_of_full += ((peak > SL_CR_RC_NORM_MAX) && (out_peak != SL_CR_RC_NORM_MAX))?1:0;
+  }
+
+  printf("%-20s %6u mixes, %6u saturated, max ratio error %d (Q12)\n", run, CHECK_SWEEP, saturated, max_ratio_error);
+  check(0 == out_of_range, run, "outputs in range");
+  check(0 == inexact, run, "unsaturated outputs are the matrix product");
+  check(max_ratio_error <= CHECK_RATIO_TOLERANCE, run, "saturated outputs keep their ratios");
+  check(0 == short_of_full, run, "largest saturated output is full scale");
+}
+
+/* Arcade drive before the mixer: each motor adds scaled throttle and steering, then clips on its own */
+static void arcade_clip(sl_cr_rc_norm_t throttle, sl_cr_rc_norm_t steering, int32_t min_rpm, int32_t max_rpm, int32_t (&rpm)[2])
+{
+  int32_t left  = sl_cr_rc_map_scale(throttle, min_rpm, max_rpm) + sl_cr_rc_map_scale(steering, min_rpm, max_rpm);
+  int32_t right = sl_cr_rc_map_scale(throttle, min_rpm, max_rpm) - sl_cr_rc_map_scale(steering, min_rpm, max_rpm);
+
+  left  = (left > max_rpm)?max_rpm:left;
+  left  = (left < min_rpm)?min_rpm:left;
+  right = (right > max_rpm)?max_rpm:right;
+  right = (right < min_rpm)?min_rpm:right;
+
+  rpm[0] = left;
+  rpm[1] = right;
+}
+
+/* Arcade mix special cased for its unit coefficients, saturating as the mixer does */
+static void arcade_unit(sl_cr_rc_norm_t throttle, sl_cr_rc_norm_t steering, int32_t min_rpm, int32_t max_rpm, int32_t (&rpm)[2])
+{
+  int32_t       left  = throttle + steering;
+  int32_t       right = throttle - steering;
+  const int32_t peak  = (abs(left) > abs(right))?abs(left):abs(right);
+
+  if(peak > SL_CR_RC_NORM_MAX)
+  {
+    const int32_t scale = ((SL_CR_RC_NORM_MAX << SL_CR_MIXER_SCALE_SHIFT) + peak - 1) / peak;
+    left  = (left < 0)?-((-left * scale) >> SL_CR_MIXER_SCALE_SHIFT):((left * scale) >> SL_CR_MIXER_SCALE_SHIFT);
+    right = (right < 0)?-((-right * scale) >> SL_CR_MIXER_SCALE_SHIFT):((right * scale) >> SL_CR_MIXER_SCALE_SHIFT);
+  }
+
+  rpm[0] = sl_cr_rc_map_scale(left, min_rpm, max_rpm);
+  rpm[1] = sl_cr_rc_map_scale(right, min_rpm, max_rpm);
+}
+
+static void arcade_mixer(const sl_cr_mixer_c<2,2> &mixer, sl_cr_rc_norm_t throttle, sl_cr_rc_norm_t steering, int32_t min_rpm,
+                         int32_t max_rpm, int32_t (&rpm)[2])
+{
+  const sl_cr_rc_norm_t in[2] = {throttle, steering};
+  sl_cr_rc_norm_t       out[2];
+
+  mixer.mix(in, out);
+  rpm[0] = sl_cr_rc_map_scale(out[0], min_rpm, max_rpm);
+  rpm[1] = sl_cr_rc_map_scale(out[1], min_rpm, max_rpm);
+}
+
+/* Times one arcade implementation over the sample sequence, returns ns per frame */
+template <typename arcade_f>
+static double time_arcade(const sl_cr_rc_norm_t (*samples)[2], arcade_f arcade)
+{
+  volatile int32_t sink = 0;
+  const auto       start = std::chrono::steady_clock::now();
+
+  for(unsigned int i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    int32_t sum = 0;
+    for(unsigned int s = 0; s < BENCH_SAMPLES; s++)
+    {
+      int32_t rpm[2];
+      arcade(samples[s][0], samples[s][1], rpm);
+      sum += rpm[0] - rpm[1];
+    }
+    sink = sink + sum;
+  }
+
+  const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / ((double) BENCH_ITERATIONS * BENCH_SAMPLES);
+}
+
+int main()
+{
+  const sl_cr_rc_norm_t half = SL_CR_RC_NORM_MAX / 2;
+  const sl_cr_rc_norm_t full = SL_CR_RC_NORM_MAX;
+
+  /* Known stick positions */
+  {
+    const sl_cr_mixer_c<2,2> tank(sl_cr_mixer_tank);
+    const sl_cr_mixer_c<2,2> arcade(sl_cr_mixer_arcade);
+    const sl_cr_mixer_c<2,4> arcade_4wd(sl_cr_mixer_arcade_4wd);
+    const sl_cr_mixer_c<3,3> arcade_weapon(sl_cr_mixer_arcade_weapon);
+
+    check_mix(tank,   {full, (sl_cr_rc_norm_t) -half}, {full, (sl_cr_rc_norm_t) -half}, "tank passes sticks through");
+    check_mix(arcade, {half, 0},                       {half, half},                    "arcade throttle drives straight");
+    check_mix(arcade, {0, half},                       {half, (sl_cr_rc_norm_t) -half}, "arcade steering spins in place");
+    check_mix(arcade, {half, half},                    {full, 0},                       "arcade half throttle half steering");
+    /* Full throttle and full steering sum to 2.0 and 0, scaled to 1.0 and 0 */
+    check_mix(arcade, {full, full},                    {full, 0},                       "arcade full throttle full steering");
+    /* 1.0 + 0.5 and 1.0 - 0.5, scaled by 1/1.5 keeps the 3:1 turn */
+    check_mix(arcade, {full, half},                    {full, (sl_cr_rc_norm_t) (full/3)}, "arcade saturated turn keeps ratio");
+    check_mix(arcade_4wd, {half, (sl_cr_rc_norm_t) -half}, {0, 0, full, full},          "4wd arcade sides");
+    check_mix(arcade_weapon, {0, 0, half},             {0, 0, half},                    "weapon passthrough");
+  }
+
+  check_sweep(sl_cr_mixer_tank,          "tank");
+  check_sweep(sl_cr_mixer_arcade,        "arcade");
+  check_sweep(sl_cr_mixer_arcade_4wd,    "4wd arcade");
+  check_sweep(sl_cr_mixer_arcade_weapon, "arcade with weapon");
+
+  /* Turn ratio the per-motor clip loses on a saturated turn, full throttle with half steering should turn 3:1 */
+  {
+    int32_t clip[2];
+    int32_t mixed[2];
+    const sl_cr_mixer_c<2,2> arcade(sl_cr_mixer_arcade);
+
+    arcade_clip(full, half, -BENCH_MAX_RPM, BENCH_MAX_RPM, clip);
+    arcade_mixer(arcade, full, half, -BENCH_MAX_RPM, BENCH_MAX_RPM, mixed);
+    printf("full throttle, half steering: clipped %d/%d rpm, mixed %d/%d rpm\n", clip[0], clip[1], mixed[0], mixed[1]);
+    check((mixed[0] == BENCH_MAX_RPM) && (abs((3 * mixed[1]) - mixed[0]) <= 3), "saturated turn", "mixer keeps 3:1 turn in rpm");
+  }
+
+  /* Timing, reading the rpm range at runtime as both paths read the motor's range on target */
+  {
+    static sl_cr_rc_norm_t   samples[BENCH_SAMPLES][2];
+    volatile int32_t         max_rpm = BENCH_MAX_RPM;
+    const int32_t            max = max_rpm;
+    const int32_t            min = -max;
+    const sl_cr_mixer_c<2,2> arcade(sl_cr_mixer_arcade);
+    unsigned int             saturated = 0;
+
+    for(unsigned int s = 0; s < BENCH_SAMPLES; s++)
+    {
+      samples[s][0] = random_norm();
+      samples[s][1] = random_norm();
+      saturated    += ((abs(samples[s][0]) + abs(samples[s][1])) > SL_CR_RC_NORM_MAX)?1:0;
+    }
+
+    /* Fastest of interleaved rounds, least disturbed by the host */
+    double clip_ns  = INFINITY;
+    double unit_ns  = INFINITY;
+    double mixer_ns = INFINITY;
+    for(unsigned int r = 0; r < BENCH_ROUNDS; r++)
+    {
+      clip_ns  = fmin(clip_ns,  time_arcade(samples, [=](sl_cr_rc_norm_t t, sl_cr_rc_norm_t s, int32_t (&rpm)[2]) {
+        arcade_clip(t, s, min, max, rpm);
+      }));
+      unit_ns  = fmin(unit_ns,  time_arcade(samples, [=](sl_cr_rc_norm_t t, sl_cr_rc_norm_t s, int32_t (&rpm)[2]) {
+        arcade_unit(t, s, min, max, rpm);
+      }));
+      mixer_ns = fmin(mixer_ns, time_arcade(samples, [&](sl_cr_rc_norm_t t, sl_cr_rc_norm_t s, int32_t (&rpm)[2]) {
+        arcade_mixer(arcade, t, s, min, max, rpm);
+      }));
+    }
+
+    printf("arcade per-motor clip %6.2f ns/frame, unit special case %6.2f ns/frame, mixer %6.2f ns/frame (host, %u of %u frames "
+      "saturated)\n", clip_ns, unit_ns, mixer_ns, saturated, BENCH_SAMPLES);
+  }
+
+  printf("%s\n", (0 == checks_failed)?"ok":"FAIL");
+
+  return (0 == checks_failed)?0:1;
+}
@@ -0,0 +1,249 @@
+/*
+  sl_cr_motor_stack_bench.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+/* Host microbenchmark of the drive control loop over sl_cr_motor_stack_c.  A bench robot descriptor uses the firmware encoder and fixed
+     point PID with a minimal open loop driver, and the control loop runs every motor stack once per tick as sl_cr_drive_control_loop()
+     does.  Times the statically bound motor stack against the same loop body calling the control loop and driver through their virtual
+     base classes, as the drive subsystem did before robot descriptors.  Runs with 2 to 8 motors, reporting the cost per motor so the
+     control loop's scaling with the robot's motor count can be checked.
+     Host timings only rank the two paths, cycle counts on target come from the control loop task profiler statistics.
+     Build:  g++ -std=c++17 -O2 -I. -Itools/host -I<sl-robot>/src -o sl_cr_motor_stack_bench tools/sl_cr_motor_stack_bench.cpp
+               sl_cr_encoder.cpp sl_cr_fixed_pid.cpp
+     Usage:  sl_cr_motor_stack_bench */
+
+#include <Arduino.h>
+#include <chrono>
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "sl_cr_encoder.hpp"
+#include "sl_cr_fixed_pid.hpp"
+#include "sl_cr_motor_stack.hpp"
+
+using namespace sandor_laboratories::robot;
+
+/* Control loop ticks timed per run, runs per path (fastest is reported), and simulated time between ticks (us) */
+#define BENCH_TICKS     200000
+#define BENCH_RUNS      15
+#define BENCH_PERIOD_US 1000
+/* Most motors benched */
+#define BENCH_MAX_MOTORS 8
+#define BENCH_MAX_RPM   1000
+#define BENCH_MAX_PWM   1023
+
+/* Gains of sl_cr_robot_drv8256p_s */
+static const pid_loop_params_s pid_params = {50, 100, 25, 100, 12, 100};
+
+/* Log output of the PID under test */
+void log_snprintf(log_key_e, log_level_e, const char *format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  fprintf(stderr, "\n");
+  va_end(args);
+}
+
+/* PWM compare register the bench driver writes */
+static volatile int32_t bench_pwm;
+
+/* Driver interface as the library's motor driver base class, loop() is virtual */
+class bench_driver_base_c
+{
+  protected:
+    rpm_t set_rpm;
+    rpm_t commanded_rpm;
+    bool  enabled;
+
+  public:
+    bench_driver_base_c() : set_rpm(0), commanded_rpm(0), enabled(false) {}
+    virtual ~bench_driver_base_c() {}
+
+    virtual void loop() = 0;
+
+    void  change_set_rpm(rpm_t rpm)                   {set_rpm = rpm;}
+    void  brake_motor()                               {set_rpm = 0;}
+    void  enable(sl_cr_motor_disable_reason_t)        {enabled = true;}
+    void  disable(sl_cr_motor_disable_reason_t)       {enabled = false;}
+    rpm_t get_min_rpm() const                         {return -BENCH_MAX_RPM;}
+    rpm_t get_max_rpm() const                         {return BENCH_MAX_RPM;}
+    rpm_t get_commanded_rpm() const                   {return commanded_rpm;}
+    rpm_t get_real_rpm() const                        {return commanded_rpm;}
+};
+
+/* Open loop driver: clamps set point and writes PWM */
+class bench_driver_c : public bench_driver_base_c
+{
+  public:
+    void loop() override
+    {
+      const rpm_t clamped = (set_rpm > BENCH_MAX_PWM)?BENCH_MAX_PWM:((set_rpm < -BENCH_MAX_PWM)?-BENCH_MAX_PWM:set_rpm);
+      commanded_rpm = enabled?clamped:0;
+      bench_pwm     = commanded_rpm;
+    }
+};
+
+/* Bench robot descriptor, only the types the motor stack uses */
+struct bench_robot_s
+{
+  typedef bench_driver_c    motor_driver_t;
+  typedef sl_cr_encoder_c   encoder_t;
+  typedef sl_cr_fixed_pid_c control_loop_t;
+};
+
+/* Same state and loop body as sl_cr_motor_stack_c::loop(), calling the control loop and driver through their base classes */
+class bench_virtual_stack_c
+{
+  private:
+    bench_driver_base_c          *driver;
+    sl_cr_encoder_c              *encoder;
+    control_loop_c<rpm_t, rpm_t> *control_loop;
+    failsafe_f                    failsafe;
+
+    volatile rpm_t                set_rpm;
+    volatile bool                 braking;
+    volatile bool                 enabled;
+
+    inline bool closed_loop() const {return (nullptr != encoder && nullptr != control_loop);}
+
+  public:
+    bench_virtual_stack_c(bench_driver_base_c *driver, sl_cr_encoder_c *encoder, control_loop_c<rpm_t, rpm_t> *control_loop,
+                          failsafe_f failsafe)
+      : driver(driver), encoder(encoder), control_loop(control_loop), failsafe(failsafe), set_rpm(0), braking(false), enabled(false)
+    {
+    }
+
+    void change_set_rpm(rpm_t rpm) {set_rpm = rpm; braking = false;}
+    void enable(sl_cr_motor_disable_reason_t reason) {enabled = true; driver->enable(reason);}
+
+    void loop()
+    {
+      if(encoder)
+      {
+        encoder->loop();
+      }
+
+      if(closed_loop())
+      {
+        if(braking || !enabled || (failsafe && failsafe(nullptr)))
+        {
+          control_loop->reset();
+        }
+        else
+        {
+          driver->change_set_rpm(control_loop->loop(set_rpm, encoder->get_rpm()));
+        }
+      }
+
+      driver->loop();
+    }
+
+    rpm_t get_set_rpm()       const {return set_rpm;}
+    rpm_t get_commanded_rpm() const {return driver->get_commanded_rpm();}
+    rpm_t get_real_rpm()      const {return encoder?encoder->get_rpm():driver->get_real_rpm();}
+};
+
+/* Motor state recorded each tick, as sl_cr_drive_motor_state_s */
+typedef struct
+{
+  rpm_t set_rpm[BENCH_MAX_MOTORS];
+  rpm_t commanded_rpm[BENCH_MAX_MOTORS];
+  rpm_t real_rpm[BENCH_MAX_MOTORS];
+} bench_motor_state_s;
+
+static bench_motor_state_s bench_state;
+
+/* Runs the control loop over every stack for BENCH_TICKS ticks, returns ns per tick */
+template <typename stack_t, unsigned int motors>
+static double __attribute__((noinline)) time_control_loop(stack_t * const (&stacks)[motors])
+{
+  const auto start = std::chrono::steady_clock::now();
+
+  for(unsigned int t = 0; t < BENCH_TICKS; t++)
+  {
+    sl_cr_host_cycles += BENCH_PERIOD_US * (F_CPU_ACTUAL / 1000000);
+    for(unsigned int m = 0; m < motors; m++)
+    {
+      stack_t * const motor_stack = stacks[m];
+
+      motor_stack->loop();
+
+      bench_state.set_rpm[m]       = motor_stack->get_set_rpm();
+      bench_state.commanded_rpm[m] = motor_stack->get_commanded_rpm();
+      bench_state.real_rpm[m]      = motor_stack->get_real_rpm();
+    }
+  }
+
+  const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / BENCH_TICKS;
+}
+
+/* Statically bound and virtual control loop over the given number of motors, returns static ns per tick */
+template <unsigned int motors>
+static double bench_motors()
+{
+  static_assert(motors <= BENCH_MAX_MOTORS, "Too many motors for bench state");
+
+  static sl_cr_encoder_c   *encoders[motors];
+  static sl_cr_fixed_pid_c *pids[motors];
+  static bench_driver_c     drivers[motors];
+  static sl_cr_motor_stack_c<bench_robot_s> *static_stacks[motors];
+  static bench_virtual_stack_c              *virtual_stacks[motors];
+  /* Base class pointers are read back through volatile, so the compiler cannot see the concrete types of the virtual path */
+  static bench_driver_base_c * volatile          driver_bases[motors];
+  static control_loop_c<rpm_t, rpm_t> * volatile pid_bases[motors];
+
+  for(unsigned int m = 0; m < motors; m++)
+  {
+    encoders[m] = new sl_cr_encoder_c(2*m, 2*m + 1, false, 12, 1, 30);
+    pids[m]     = new sl_cr_fixed_pid_c(-BENCH_MAX_RPM, BENCH_MAX_RPM, -BENCH_MAX_PWM, BENCH_MAX_PWM, pid_params, LOG_KEY_BOOT,
+                                        BENCH_PERIOD_US);
+
+    static_stacks[m] = new sl_cr_motor_stack_c<bench_robot_s>(&drivers[m], encoders[m], pids[m], nullptr);
+    static_stacks[m]->change_set_rpm(100 * (m + 1));
+    static_stacks[m]->enable(MOTOR_DISABLE_DRIVE_STRATEGY);
+
+    driver_bases[m]   = &drivers[m];
+    pid_bases[m]      = pids[m];
+    virtual_stacks[m] = new bench_virtual_stack_c(driver_bases[m], encoders[m], pid_bases[m], nullptr);
+    virtual_stacks[m]->change_set_rpm(100 * (m + 1));
+    virtual_stacks[m]->enable(MOTOR_DISABLE_DRIVE_STRATEGY);
+  }
+
+  /* Warm up, then alternate runs so both see the same machine state, and keep the fastest of each */
+  double static_ns  = time_control_loop(static_stacks);
+  double virtual_ns = time_control_loop(virtual_stacks);
+  for(unsigned int r = 0; r < BENCH_RUNS; r++)
+  {
+    const double static_run  = time_control_loop(static_stacks);
+    const double virtual_run = time_control_loop(virtual_stacks);
+    static_ns  = (static_run  < static_ns)?static_run:static_ns;
+    virtual_ns = (virtual_run < virtual_ns)?virtual_run:virtual_ns;
+  }
+
+  printf("%u motors: static %7.2f ns/tick (%6.2f per motor), virtual %7.2f ns/tick (%6.2f per motor)\n", motors,
+    static_ns, static_ns / motors, virtual_ns, virtual_ns / motors);
+
+  return static_ns;
+}
+
+int main()
+{
+  printf("motor stack %u bytes, encoder %u bytes, PID %u bytes, bench driver %u bytes\n",
+    (unsigned int) sizeof(sl_cr_motor_stack_c<bench_robot_s>), (unsigned int) sizeof(sl_cr_encoder_c),
+    (unsigned int) sizeof(sl_cr_fixed_pid_c), (unsigned int) sizeof(bench_driver_c));
+
+  /* 2WD and 4WD drive, 6WD drive, 6WD drive with two weapon motors */
+  const double two   = bench_motors<2>();
+  bench_motors<4>();
+  bench_motors<6>();
+  const double eight = bench_motors<BENCH_MAX_MOTORS>();
+
+  printf("8 motors take %.2fx the time of 2 motors\n", eight / two);
+
+  return 0;
+}
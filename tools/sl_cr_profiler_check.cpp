@@ -0,0 +1,98 @@
+/*
+  sl_cr_profiler_check.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+/* Host check of sl_cr_profiler deadline miss counting.  Runs one task per case on simulated cycles: on time, an overrun restarting
+     right away, an overrun followed by a late start, a late start alone, and an aperiodic task, and checks each missed iteration is
+     counted exactly once.
+     Build:  g++ -std=c++17 -O2 -I. -Itools/host -I<sl-robot>/src -o sl_cr_profiler_check tools/sl_cr_profiler_check.cpp
+               sl_cr_profiler.cpp
+     Usage:  sl_cr_profiler_check
+   Exits non-zero if any check fails. */
+
+#include <Arduino.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "sl_cr_profiler.hpp"
+
+/* Task period and on time execution (us) */
+#define CHECK_PERIOD     1000
+#define CHECK_EXECUTION  200
+/* On time iterations around each case */
+#define CHECK_ITERATIONS 10
+
+static unsigned int checks_failed = 0;
+
+static void check(bool condition, const char *run, const char *description)
+{
+  if(!condition)
+  {
+    printf("FAIL: %s: %s\n", run, description);
+    checks_failed++;
+  }
+}
+
+/* Stats logging of the profiler under test */
+void log_snprintf(log_key_e, log_level_e, const char *format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  vprintf(format, args);
+  printf("\n");
+  va_end(args);
+}
+
+/* One iteration: begins, executes for execution us, then idles until start + interval us */
+static void iteration(sl_cr_profiler_task_e task, sl_cr_time_us_t period, uint32_t execution, uint32_t interval)
+{
+  sl_cr_profiler_begin(task, period);
+  sl_cr_host_advance_us(execution);
+  sl_cr_profiler_end(task);
+  sl_cr_host_advance_us((interval > execution)?(interval - execution):0);
+}
+
+static void on_time(sl_cr_profiler_task_e task, sl_cr_time_us_t period)
+{
+  for(unsigned int i = 0; i < CHECK_ITERATIONS; i++)
+  {
+    iteration(task, period, CHECK_EXECUTION, CHECK_PERIOD);
+  }
+}
+
+/* Runs a case between on time iterations and checks its deadline misses */
+static void check_case(sl_cr_profiler_task_e task, sl_cr_time_us_t period, uint32_t execution, uint32_t interval,
+                       unsigned int expected_misses, const char *run)
+{
+  sl_cr_profiler_stats_s stats;
+
+  on_time(task, period);
+  iteration(task, period, execution, interval);
+  on_time(task, period);
+
+  sl_cr_profiler_get_stats(task, &stats);
+  printf("%-32s %2u runs, %u deadline misses\n", run, stats.runs, stats.deadline_misses);
+  check((2 * CHECK_ITERATIONS + 1) == stats.runs, run, "every iteration profiled");
+  check(expected_misses == stats.deadline_misses, run, "each missed iteration counted once");
+}
+
+int main()
+{
+  check_case(SL_CR_PROFILER_TASK_SBUS,         CHECK_PERIOD, CHECK_EXECUTION,  CHECK_PERIOD,     0, "on time");
+  /* Next iteration starts as soon as the overrun ends, less than two periods after the last start */
+  check_case(SL_CR_PROFILER_TASK_DRIVE,        CHECK_PERIOD, 3*CHECK_PERIOD/2, 3*CHECK_PERIOD/2, 1, "overrun");
+  /* Overrun then a start more than two periods late, both from the same iteration */
+  check_case(SL_CR_PROFILER_TASK_CONTROL_LOOP, CHECK_PERIOD, 3*CHECK_PERIOD/2, 5*CHECK_PERIOD/2, 1, "overrun and late start");
+  /* Short iteration, but the next start is more than two periods late */
+  check_case(SL_CR_PROFILER_TASK_WATCHDOG,     CHECK_PERIOD, CHECK_EXECUTION,  5*CHECK_PERIOD/2, 1, "late start");
+  check_case(SL_CR_PROFILER_TASK_LOG,          SL_CR_PROFILER_APERIODIC, 3*CHECK_PERIOD/2, 5*CHECK_PERIOD/2, 0, "aperiodic");
+
+  sl_cr_profiler_log_stats(LOG_KEY_BOOT);
+
+  printf("%s\n", (0 == checks_failed)?"ok":"FAIL");
+
+  return (0 == checks_failed)?0:1;
+}
@@ -0,0 +1,152 @@
+/*
+  sl_cr_rc_map_bench.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+/* Host check and microbenchmark of the calibrated RC map against the global min/center/max arithmetic it replaced in arcade and tank
+     drive.  Every raw value in the calibrated range is converted both ways into the real and commanded rpm ranges, then both
+     conversions are timed over a pseudo random stick sequence, with and without expo.
+     Host timings only rank the two paths, cycle counts on target come from the drive task profiler statistics.
+     Build:  g++ -std=c++17 -O2 -I. -Itools/host -I<sl-robot>/src -o sl_cr_rc_map_bench tools/sl_cr_rc_map_bench.cpp sl_cr_rc_map.cpp
+     Usage:  sl_cr_rc_map_bench
+   Exits non-zero if any check fails. */
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sl_cr_config.h"
+#include "sl_cr_drive.hpp"
+#include "sl_cr_rc_map.hpp"
+
+/* Deadzone of the arithmetic, as the default calibration */
+#define BENCH_DEADZONE 50
+/* Largest allowed rpm difference to the arithmetic.  The arithmetic rounds towards full reverse and the map towards neutral, so
+     reverse commands can differ by 2 */
+#define BENCH_TOLERANCE_RPM 2
+/* Timed conversions */
+#define BENCH_SAMPLES    4096
+#define BENCH_ITERATIONS 2000
+#define BENCH_SEED       0x8A3C
+
+static unsigned int checks_failed = 0;
+
+static void check(bool condition, const char *run, const char *description)
+{
+  if(!condition)
+  {
+    printf("FAIL: %s: %s\n", run, description);
+    checks_failed++;
+  }
+}
+
+/* Small deterministic generator, so runs compare */
+static uint32_t random_state = BENCH_SEED;
+static uint32_t random_next()
+{
+  random_state = random_state * 1103515245 + 12345;
+  return random_state >> 8;
+}
+
+/* Conversion arcade and tank drive used before the calibrated map */
+static int32_t arithmetic_rpm(sl_cr_rc_channel_value_t rc_value, int32_t min_rpm, int32_t max_rpm)
+{
+  int32_t new_speed = 0;
+
+  if((rc_value > (SL_CR_RC_CH_CENTER_VALUE+BENCH_DEADZONE)) ||
+     (rc_value < (SL_CR_RC_CH_CENTER_VALUE-BENCH_DEADZONE)))
+  {
+    const int32_t input_range = SL_CR_RC_CH_MAX_VALUE-SL_CR_RC_CH_MIN_VALUE;
+    const int32_t motor_range = max_rpm-min_rpm;
+
+    new_speed = (((rc_value-SL_CR_RC_CH_MIN_VALUE)*motor_range)/input_range)+min_rpm;
+  }
+
+  return new_speed;
+}
+
+static int32_t map_rpm(const sl_cr_rc_map_s *map, sl_cr_rc_channel_value_t rc_value, int32_t min_rpm, int32_t max_rpm)
+{
+  const sl_cr_rc_norm_t norm = sl_cr_rc_map(map, rc_value);
+
+  return (SL_CR_RC_NORM_INVALID == norm)?0:sl_cr_rc_map_scale(norm, min_rpm, max_rpm);
+}
+
+static void check_range(const sl_cr_rc_map_s *map, int32_t min_rpm, int32_t max_rpm, const char *run)
+{
+  int32_t      max_difference = 0;
+  unsigned int differing      = 0;
+
+  for(sl_cr_rc_channel_value_t raw = SL_CR_RC_CH_MIN_VALUE; raw <= SL_CR_RC_CH_MAX_VALUE; raw++)
+  {
+    const int32_t difference = abs(map_rpm(map, raw, min_rpm, max_rpm) - arithmetic_rpm(raw, min_rpm, max_rpm));
+
+    max_difference = (difference > max_difference)?difference:max_difference;
+    differing     += (0 != difference)?1:0;
+  }
+
+  printf("%-28s max difference %3d rpm, %4u of %4u raw values differ\n", run, max_difference, differing,
+    SL_CR_RC_CH_MAX_VALUE - SL_CR_RC_CH_MIN_VALUE + 1);
+  check(max_difference <= BENCH_TOLERANCE_RPM, run, "map matches arithmetic");
+  check(SL_CR_RC_NORM_INVALID == sl_cr_rc_map(map, SL_CR_RC_CH_MIN_VALUE - 1), run, "below calibrated range is invalid");
+  check(SL_CR_RC_NORM_INVALID == sl_cr_rc_map(map, SL_CR_RC_CH_MAX_VALUE + 1), run, "above calibrated range is invalid");
+  check((SL_CR_RC_NORM_MAX == sl_cr_rc_map(map, SL_CR_RC_CH_MAX_VALUE)) && (-SL_CR_RC_NORM_MAX == sl_cr_rc_map(map, SL_CR_RC_CH_MIN_VALUE)),
+        run, "full deflection reaches full command");
+}
+
+/* Times one conversion over the sample sequence, returns ns per conversion */
+template <typename convert_f>
+static double time_conversion(const sl_cr_rc_channel_value_t *samples, convert_f convert)
+{
+  volatile int32_t sink = 0;
+  const auto       start = std::chrono::steady_clock::now();
+
+  for(unsigned int i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    int32_t sum = 0;
+    for(unsigned int s = 0; s < BENCH_SAMPLES; s++)
+    {
+      sum += convert(samples[s]);
+    }
+    sink = sink + sum;
+  }
+
+  const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / ((double) BENCH_ITERATIONS * BENCH_SAMPLES);
+}
+
+int main()
+{
+  static sl_cr_rc_channel_value_t samples[BENCH_SAMPLES];
+  const sl_cr_rc_map_s           *map   = sl_cr_rc_map_get(1);
+  /* Same calibration with expo, costs the cubic blend */
+  static constexpr sl_cr_rc_map_s expo_map = sl_cr_rc_map_build({SL_CR_RC_CH_MIN_VALUE, SL_CR_RC_CH_CENTER_VALUE, SL_CR_RC_CH_MAX_VALUE,
+                                                                  BENCH_DEADZONE, 30, false});
+  /* Read at runtime, as both paths read the motor's range on target */
+  volatile int32_t                min_rpm = SL_CR_MOTOR_DRIVER_REAL_MIN_RPM;
+  volatile int32_t                max_rpm = SL_CR_MOTOR_DRIVER_REAL_MAX_RPM;
+
+  check_range(map, SL_CR_MOTOR_DRIVER_REAL_MIN_RPM, SL_CR_MOTOR_DRIVER_REAL_MAX_RPM, "real rpm range");
+  check_range(map, -100, 100, "virtual motor range");
+
+  for(unsigned int s = 0; s < BENCH_SAMPLES; s++)
+  {
+    samples[s] = SL_CR_RC_CH_MIN_VALUE + (random_next() % (SL_CR_RC_CH_MAX_VALUE - SL_CR_RC_CH_MIN_VALUE + 1));
+  }
+
+  const int32_t min = min_rpm;
+  const int32_t max = max_rpm;
+  const double  arithmetic_ns = time_conversion(samples, [=](sl_cr_rc_channel_value_t raw) {return arithmetic_rpm(raw, min, max);});
+  const double  map_ns        = time_conversion(samples, [=](sl_cr_rc_channel_value_t raw) {return map_rpm(map, raw, min, max);});
+  const double  expo_ns       = time_conversion(samples, [=](sl_cr_rc_channel_value_t raw) {return map_rpm(&expo_map, raw, min, max);});
+
+  printf("arithmetic %6.2f ns/conversion, map %6.2f ns/conversion, map with expo %6.2f ns/conversion (host)\n", arithmetic_ns, map_ns,
+    expo_ns);
+  printf("channel maps: %u distinct x %u bytes = %u bytes\n", 5, (unsigned int) sizeof(sl_cr_rc_map_s), 5 * (unsigned int) sizeof(sl_cr_rc_map_s));
+
+  printf("%s\n", (0 == checks_failed)?"ok":"FAIL");
+
+  return (0 == checks_failed)?0:1;
+}
@@ -0,0 +1,281 @@
+/*
+  sl_cr_sbus_decoder_check.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+/* Host check of sl_cr_sbus_decoder_c against recorded and corrupted byte streams.
+     A recording is made with the SBUS recorder from generated frames (or read from a file), replayed through a fresh decoder as the
+     UART interrupt would feed it, and every decoded frame is compared to the recorded bytes.  The same recording is then replayed with
+     bytes dropped, flipped and inserted, with and without the line idle resynchronization the interrupt performs between frames.
+     Build:  g++ -std=c++17 -I. -I<sl-robot>/src -o sl_cr_sbus_decoder_check tools/sl_cr_sbus_decoder_check.cpp sl_cr_sbus_decoder.cpp
+               sl_cr_sbus_record.cpp
+     Usage:  sl_cr_sbus_decoder_check [SBUS000.BIN]
+   Exits non-zero if any check fails. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "sl_cr_sbus_decoder.hpp"
+#include "sl_cr_sbus_record.hpp"
+
+/* Generated recording length and frame period (us) */
+#define CHECK_FRAMES        2000
+#define CHECK_FRAME_PERIOD  14000
+/* Corrupted replays, one in CHECK_CORRUPT_ONE_IN frames is damaged */
+#define CHECK_CORRUPT_ONE_IN 4
+#define CHECK_SEED           0x5B05
+
+static unsigned int checks_failed = 0;
+
+static void check(bool condition, const char *description)
+{
+  if(!condition)
+  {
+    printf("FAIL: %s\n", description);
+    checks_failed++;
+  }
+}
+
+/* Small deterministic generator, so failures reproduce */
+static uint32_t random_state = CHECK_SEED;
+static uint32_t random_next()
+{
+  random_state = random_state * 1103515245 + 12345;
+  return random_state >> 8;
+}
+
+/* Packs a frame the way a receiver transmits it */
+static void encode_frame(const uint16_t *ch, uint8_t flags, uint8_t footer, uint8_t *raw)
+{
+  uint32_t     bit_buffer = 0;
+  unsigned int bit_count  = 0;
+  unsigned int index      = 1;
+
+  memset(raw, 0, SL_CR_SBUS_FRAME_SIZE);
+  raw[0] = SL_CR_SBUS_HEADER;
+  for(unsigned int c = 0; c < SL_CR_SBUS_NUM_CH; c++)
+  {
+    bit_buffer |= ((uint32_t) (ch[c] & SL_CR_SBUS_CH_MASK)) << bit_count;
+    bit_count  += SL_CR_SBUS_CH_BITS;
+    while(bit_count >= 8)
+    {
+      raw[index++] = bit_buffer & 0xFF;
+      bit_buffer >>= 8;
+      bit_count   -= 8;
+    }
+  }
+  raw[SL_CR_SBUS_FRAME_SIZE-2] = flags;
+  raw[SL_CR_SBUS_FRAME_SIZE-1] = footer;
+}
+
+/* Decoded frame carries exactly the recorded channels and flags */
+static bool frame_matches(const sl_cr_sbus_raw_frame_s *frame, const uint8_t *raw)
+{
+  const uint8_t flags = (frame->ch17?SL_CR_SBUS_FLAG_CH17:0) | (frame->ch18?SL_CR_SBUS_FLAG_CH18:0) |
+                        (frame->lost_frame?SL_CR_SBUS_FLAG_LOST_FRAME:0) | (frame->failsafe?SL_CR_SBUS_FLAG_FAILSAFE:0);
+  uint8_t expected[SL_CR_SBUS_FRAME_SIZE];
+
+  encode_frame(frame->ch, flags, raw[SL_CR_SBUS_FRAME_SIZE-1], expected);
+
+  return (0 == memcmp(expected, raw, SL_CR_SBUS_FRAME_SIZE-2)) &&
+         (flags == (raw[SL_CR_SBUS_FRAME_SIZE-2] & 0x0F));
+}
+
+/* Sink collecting recorder output in memory */
+static size_t record_write(const uint8_t *data, size_t length, void *user_data)
+{
+  std::vector<uint8_t> * const recording = (std::vector<uint8_t> *) user_data;
+
+  recording->insert(recording->end(), data, data + length);
+
+  return length;
+}
+
+/* Records generated frames with the firmware recorder, flushing as the flushing task would */
+static void generate_recording(std::vector<uint8_t> *recording)
+{
+  static const uint8_t footers[] = {SL_CR_SBUS_FOOTER, 0x04, 0x14, 0x24, 0x34};
+
+  for(unsigned int f = 0; f < CHECK_FRAMES; f++)
+  {
+    uint16_t ch[SL_CR_SBUS_NUM_CH];
+    uint8_t  raw[SL_CR_SBUS_FRAME_SIZE];
+
+    for(unsigned int c = 0; c < SL_CR_SBUS_NUM_CH; c++)
+    {
+      ch[c] = random_next() & SL_CR_SBUS_CH_MASK;
+    }
+    encode_frame(ch, random_next() & 0x0F, footers[f % sizeof(footers)], raw);
+    sl_cr_sbus_record_frame(0, raw, f * CHECK_FRAME_PERIOD);
+    if(0 == (f % 16))
+    {
+      sl_cr_sbus_record_flush(record_write, recording);
+    }
+  }
+  sl_cr_sbus_record_flush(record_write, recording);
+}
+
+/* Replays frame records through a fresh decoder.  corrupt damages one in CHECK_CORRUPT_ONE_IN frames, idle resynchronizes before
+     each frame like the line idle interrupt.  With idle, every undamaged frame not directly after a damaged one must decode exactly.
+     Returns number of frames decoded */
+static unsigned int replay(const std::vector<uint8_t> &recording, bool corrupt, bool idle, const char *name)
+{
+  sl_cr_sbus_replay_c  player(recording.data(), recording.size());
+  sl_cr_sbus_decoder_c decoder;
+  sl_cr_sbus_record_s  record;
+  unsigned int         frames   = 0;
+  unsigned int         intact   = 0;
+  unsigned int         decoded  = 0;
+  unsigned int         missed   = 0;
+  unsigned int         mismatch = 0;
+  bool                 damaged_previous = false;
+
+  check(player.valid(), "recording header recognized");
+
+  while(player.next(&record))
+  {
+    if(SL_CR_SBUS_RECORD_FRAME != record.type)
+    {
+      continue;
+    }
+
+    std::vector<uint8_t> bytes(record.data, record.data + SL_CR_SBUS_FRAME_SIZE);
+    const bool           damaged = corrupt && (0 == (random_next() % CHECK_CORRUPT_ONE_IN));
+    bool                 line_error = false;
+
+    if(damaged)
+    {
+      const unsigned int position = random_next() % SL_CR_SBUS_FRAME_SIZE;
+      switch(random_next() % 4)
+      {
+        case 0:  bytes.erase(bytes.begin() + position);                     break;
+        case 1:  bytes[position] ^= 1 << (random_next() % 8);               break;
+        case 2:  bytes.insert(bytes.begin() + position, random_next());     break;
+        default: bytes.resize(position); line_error = true;                 break;
+      }
+    }
+
+    if(idle)
+    {
+      decoder.reset();
+    }
+
+    bool complete = false;
+    for(size_t b = 0; b < bytes.size(); b++)
+    {
+      complete = decoder.decode(bytes[b], record.rx_time) || complete;
+    }
+    if(line_error)
+    {
+      /* Framing or parity error on the truncated byte */
+      decoder.error();
+    }
+
+    frames++;
+    if(complete)
+    {
+      decoded++;
+      if(!damaged && (!frame_matches(decoder.get_frame(), record.data) ||
+                      (0 != memcmp(decoder.get_raw_frame(), record.data, SL_CR_SBUS_FRAME_SIZE))))
+      {
+        mismatch++;
+      }
+      check(record.rx_time == decoder.get_frame()->rx_time, "decoded frame carries rx time of its last byte");
+    }
+    else if(!damaged && !damaged_previous)
+    {
+      missed++;
+    }
+    intact += damaged?0:1;
+    damaged_previous = damaged;
+  }
+
+  printf("%-20s %5u frames, %5u intact, %5u decoded, %4u decoder errors, %4u missed, %4u mismatched\n",
+    name, frames, intact, decoded, decoder.get_error_count(), missed, mismatch);
+  if(idle || !corrupt)
+  {
+    check(0 == missed, "every intact frame decodes");
+    check(0 == mismatch, "every intact frame decodes to the recorded bytes, channels and flags");
+  }
+  else
+  {
+    /* Without idle the decoder can only hunt for the next header byte, and may lock onto one in channel data.  It must still recover */
+    check((decoded * 2) > intact, "decoder recovers without line idle");
+  }
+  check(corrupt || (0 == decoder.get_error_count()), "clean replay has no decoder errors");
+
+  return decoded;
+}
+
+int main(int argc, char **argv)
+{
+  std::vector<uint8_t> recording;
+
+  if(argc > 1)
+  {
+    FILE * const file = fopen(argv[1], "rb");
+    uint8_t      chunk[4096];
+    size_t       length;
+
+    if(nullptr == file)
+    {
+      fprintf(stderr, "Cannot open %s\n", argv[1]);
+      return 1;
+    }
+    while((length = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+      recording.insert(recording.end(), chunk, chunk + length);
+    }
+    fclose(file);
+  }
+  else
+  {
+    generate_recording(&recording);
+  }
+
+  /* Channel unpacking of a known frame */
+  {
+    uint16_t             ch[SL_CR_SBUS_NUM_CH];
+    uint8_t              raw[SL_CR_SBUS_FRAME_SIZE];
+    sl_cr_sbus_decoder_c decoder;
+    bool                 complete = false;
+
+    for(unsigned int c = 0; c < SL_CR_SBUS_NUM_CH; c++)
+    {
+      ch[c] = (c & 1)?SL_CR_SBUS_CH_MASK:(c * 100);
+    }
+    encode_frame(ch, SL_CR_SBUS_FLAG_FAILSAFE | SL_CR_SBUS_FLAG_CH18, SL_CR_SBUS_FOOTER, raw);
+    for(unsigned int b = 0; b < SL_CR_SBUS_FRAME_SIZE; b++)
+    {
+      complete = decoder.decode(raw[b], 1234);
+    }
+    check(complete && (0 == memcmp(ch, decoder.get_frame()->ch, sizeof(ch))), "known frame unpacks to its channels");
+    check(decoder.get_frame()->failsafe && decoder.get_frame()->ch18 && !decoder.get_frame()->lost_frame && !decoder.get_frame()->ch17,
+          "known frame flags");
+
+    /* Bad footer drops the frame and counts it, previous frame is kept */
+    raw[SL_CR_SBUS_FRAME_SIZE-1] = 0x55;
+    ch[0] = 1;
+    encode_frame(ch, 0, 0x55, raw);
+    complete = false;
+    for(unsigned int b = 0; b < SL_CR_SBUS_FRAME_SIZE; b++)
+    {
+      complete = decoder.decode(raw[b], 5678) || complete;
+    }
+    check(!complete && (1 == decoder.get_error_count()) && (1234 == decoder.get_frame()->rx_time), "bad footer is rejected");
+  }
+
+  const unsigned int clean = replay(recording, false, true, "recorded");
+  check(clean > 0, "recording holds frames");
+  replay(recording, false, false, "recorded, no idle");
+  replay(recording, true, true, "corrupted");
+  replay(recording, true, false, "corrupted, no idle");
+
+  printf("%s\n", (0 == checks_failed)?"ok":"FAIL");
+
+  return (0 == checks_failed)?0:1;
+}
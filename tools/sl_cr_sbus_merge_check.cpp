@@ -0,0 +1,256 @@
+/*
+  sl_cr_sbus_merge_check.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+/* Host simulation check of dual SBUS receiver merging.  Runs the firmware SBUS module on simulated time with two receivers sending
+     frames at the nominal period, offset from each other, through phases of dropout and receiver failsafe.  The SBUS task loop runs
+     on every frame and on its frame period timeout, as on target.
+     Build:  g++ -std=c++17 -I. -Itools/host -I<sl-robot>/src -D_DUAL_SBUS_RECEIVER_ -o sl_cr_sbus_merge_check
+               tools/sl_cr_sbus_merge_check.cpp sl_cr_sbus.cpp sl_cr_sbus_decoder.cpp sl_cr_sbus_record.cpp
+     Usage:  sl_cr_sbus_merge_check
+   Exits non-zero if any check fails. */
+
+#include <Arduino.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sl_cr_failsafe.hpp"
+#include "sl_cr_sbus.hpp"
+
+#ifndef _DUAL_SBUS_RECEIVER_
+#error "Build with -D_DUAL_SBUS_RECEIVER_"
+#endif
+
+using namespace sandor_laboratories::robot;
+
+/* Frame period and offset of second receiver (us) */
+#define CHECK_FRAME_PERIOD    14000
+#define CHECK_RECEIVER_OFFSET 5000
+/* Latest a stale state may be published after the last frame: stale timeout, then up to one task timeout to notice */
+#define CHECK_STALE_LATENCY   ((4 + 1) * CHECK_FRAME_PERIOD)
+
+/* Receiver behaviour during a phase */
+typedef enum
+{
+  RX_OK,
+  RX_SILENT,
+  RX_FAILSAFE,
+} rx_mode_e;
+
+typedef struct
+{
+  const char *name;
+  /* Phase end (us) */
+  uint32_t    end;
+  rx_mode_e   rx[SL_CR_SBUS_RECEIVER_COUNT];
+} phase_s;
+
+static const phase_s phases[] =
+{
+  {"both receivers",        1000000, {RX_OK,       RX_OK}},
+  {"receiver 0 dropout",    2000000, {RX_SILENT,   RX_OK}},
+  {"receiver 1 failsafe",   3000000, {RX_OK,       RX_FAILSAFE}},
+  {"receiver 0 failsafe",   4000000, {RX_FAILSAFE, RX_OK}},
+  {"both failsafe",         4500000, {RX_FAILSAFE, RX_FAILSAFE}},
+  {"both dropout",          5000000, {RX_SILENT,   RX_SILENT}},
+  {"recovered",             6000000, {RX_OK,       RX_OK}},
+  {"receiver 1 dropout",    7000000, {RX_OK,       RX_SILENT}},
+};
+#define CHECK_PHASES (sizeof(phases) / sizeof(phases[0]))
+
+/* Failsafe mask as set by the SBUS module */
+static combat::failsafe_mask_t check_failsafe_mask = 0;
+
+void combat::set_failsafe_mask(failsafe_reason_e reason)   {check_failsafe_mask |= (1 << reason);}
+void combat::clear_failsafe_mask(failsafe_reason_e reason) {check_failsafe_mask &= ~(1 << reason);}
+void combat::set_failsafe_mask_value(failsafe_reason_e reason, bool value)
+{
+  if(value)
+  {
+    set_failsafe_mask(reason);
+  }
+  else
+  {
+    clear_failsafe_mask(reason);
+  }
+}
+combat::failsafe_mask_t combat::get_failsafe_mask() {return check_failsafe_mask;}
+
+void log_snprintf(log_key_e, log_level_e, const char *format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  fprintf(stderr, "\n");
+  va_end(args);
+}
+
+static unsigned int checks_failed = 0;
+
+static void check(bool condition, const char *phase, const char *description)
+{
+  if(!condition)
+  {
+    printf("FAIL: %s: %s (at %uus)\n", phase, description, micros());
+    checks_failed++;
+  }
+}
+
+/* Frame with channel 1 holding the sending receiver, so a published frame can be traced to it */
+static void encode_frame(sl_cr_sbus_receiver_t receiver, bool failsafe, uint8_t *raw)
+{
+  memset(raw, 0, SL_CR_SBUS_FRAME_SIZE);
+  raw[0] = SL_CR_SBUS_HEADER;
+  raw[1] = receiver;
+  raw[SL_CR_SBUS_FRAME_SIZE-2] = failsafe?SL_CR_SBUS_FLAG_FAILSAFE:0;
+  raw[SL_CR_SBUS_FRAME_SIZE-1] = SL_CR_SBUS_FOOTER;
+}
+
+/* Published frames during one phase */
+typedef struct
+{
+  unsigned int    published;
+  unsigned int    stale;
+  unsigned int    failsafe;
+  unsigned int    from[SL_CR_SBUS_RECEIVER_COUNT];
+  unsigned int    out_of_order;
+  sl_cr_time_us_t longest_gap;
+  /* First stale publication (us after phase start), 0 if none */
+  sl_cr_time_us_t stale_after;
+} phase_result_s;
+
+int main()
+{
+  sl_cr_sbus_frame_s frame;
+  sl_cr_time_us_t    phase_start     = 0;
+  sl_cr_time_us_t    last_rx_time    = 0;
+  sl_cr_time_us_t    last_published  = 0;
+  sl_cr_time_us_t    last_task_run   = 0;
+  sl_cr_time_us_t    last_frame_time = 0;
+  uint32_t           last_sequence;
+
+  sl_cr_sbus_init(nullptr);
+  last_sequence = sl_cr_sbus_get_frame(&frame);
+  check(frame.stale && (0 != (combat::get_failsafe_mask() & (1 << combat::FAILSAFE_SBUS_STALE))), "boot", "starts stale");
+
+  for(unsigned int p = 0; p < CHECK_PHASES; p++)
+  {
+    const phase_s  *phase  = &phases[p];
+    phase_result_s  result = {};
+
+    while(micros() < phase->end)
+    {
+      sl_cr_host_advance_us(1000);
+
+      const sl_cr_time_us_t now = micros();
+      bool                  woken = false;
+
+      for(sl_cr_sbus_receiver_t r = 0; r < SL_CR_SBUS_RECEIVER_COUNT; r++)
+      {
+        if((RX_SILENT != phase->rx[r]) && (0 == ((now + CHECK_FRAME_PERIOD - r*CHECK_RECEIVER_OFFSET) % CHECK_FRAME_PERIOD)))
+        {
+          uint8_t raw[SL_CR_SBUS_FRAME_SIZE];
+          encode_frame(r, RX_FAILSAFE == phase->rx[r], raw);
+          sl_cr_sbus_inject(r, raw, SL_CR_SBUS_FRAME_SIZE, now);
+          last_frame_time = now;
+          woken = true;
+        }
+      }
+
+      /* Task wakes on a frame, or after its frame period timeout */
+      if(!woken && ((now - last_task_run) < (sl_cr_sbus_get_frame_period_ticks() * 1000)))
+      {
+        continue;
+      }
+      last_task_run = now;
+
+      if(sl_cr_sbus_loop())
+      {
+        const uint32_t sequence = sl_cr_sbus_get_frame(&frame);
+
+        check(sequence != last_sequence, phase->name, "published frame has a new sequence");
+        last_sequence = sequence;
+        result.published++;
+
+        if(frame.stale)
+        {
+          result.stale++;
+          result.stale_after = (0 == result.stale_after)?(now - phase_start):result.stale_after;
+          check(0 != (combat::get_failsafe_mask() & (1 << combat::FAILSAFE_SBUS_STALE)), phase->name, "stale sets stale failsafe");
+          check((now - last_frame_time) <= CHECK_STALE_LATENCY, phase->name, "stale published within stale timeout of last frame");
+        }
+        else
+        {
+          result.failsafe += frame.failsafe?1:0;
+          result.from[frame.receiver]++;
+          check(frame.receiver == (sl_cr_sbus_receiver_t) sl_cr_sbus_get_frame_ch_value(&frame, 1), phase->name,
+                "channels come from the receiver reported");
+          check(frame.failsafe == (0 != (combat::get_failsafe_mask() & (1 << combat::FAILSAFE_SBUS))), phase->name,
+                "receiver failsafe flag drives SBUS failsafe");
+          check(0 == (combat::get_failsafe_mask() & (1 << combat::FAILSAFE_SBUS_STALE)), phase->name, "fresh frame clears stale failsafe");
+          if((sl_cr_time_diff_us_t) (frame.rx_time - last_rx_time) <= 0)
+          {
+            result.out_of_order++;
+          }
+          last_rx_time = frame.rx_time;
+        }
+
+        if(result.published > 1)
+        {
+          result.longest_gap = ((now - last_published) > result.longest_gap)?(now - last_published):result.longest_gap;
+        }
+        last_published = now;
+      }
+    }
+
+    printf("%-20s published %4u (receiver 0 %4u, receiver 1 %4u), failsafe %4u, stale %u, longest gap %6uus, out of order %u\n",
+      phase->name, result.published, result.from[0], result.from[1], result.failsafe, result.stale, result.longest_gap,
+      result.out_of_order);
+
+    check(0 == result.out_of_order, phase->name, "every published frame is newer than the last");
+    switch(p)
+    {
+      case 0:
+        check((result.from[0] > 0) && (result.from[1] > 0) && (0 == result.failsafe) && (0 == result.stale), phase->name,
+              "both receivers merged without failsafe");
+        check(result.longest_gap <= (CHECK_FRAME_PERIOD - CHECK_RECEIVER_OFFSET), phase->name, "frames of both receivers published");
+        break;
+      case 1:
+      case 7:
+        check((0 == result.stale) && (0 == result.failsafe), phase->name, "one receiver dropping out is not a failsafe");
+        check(result.longest_gap <= CHECK_FRAME_PERIOD, phase->name, "other receiver takes over without a gap");
+        break;
+      case 2:
+        check((0 == result.failsafe) && (0 == result.from[1]) && (result.from[0] > 0), phase->name,
+              "receiver without failsafe is preferred");
+        break;
+      case 3:
+        check((0 == result.failsafe) && (0 == result.from[0]) && (result.from[1] > 0), phase->name,
+              "receiver without failsafe is preferred");
+        break;
+      case 4:
+        check(result.failsafe == result.published, phase->name, "failsafe when both receivers report it");
+        break;
+      case 5:
+        check((1 == result.stale) && (result.stale_after <= CHECK_STALE_LATENCY), phase->name, "stale published once when both drop out");
+        break;
+      case 6:
+        check((0 == result.stale) && (0 == result.failsafe) && (result.from[0] > 0) && (result.from[1] > 0), phase->name,
+              "both receivers used again after recovery");
+        break;
+      default:
+        break;
+    }
+
+    phase_start = micros();
+  }
+
+  sl_cr_sbus_log_stats(LOG_KEY_BOOT);
+  printf("%s\n", (0 == checks_failed)?"ok":"FAIL");
+
+  return (0 == checks_failed)?0:1;
+}
@@ -0,0 +1,195 @@
+/*
+  sl_cr_sbus_replay.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+/* Host replay harness for SBUS recordings (see sl_cr_sbus_record.hpp).  Runs the firmware SBUS, failsafe and drive subsystems on
+     simulated time: each recorded frame is injected for its receiver at its receive time, and the SBUS task loop runs on every frame and
+     on its frame period timeout in between, as on target.  Each SBUS task loop is followed by the arm switch loop, the drive strategy and
+     the control loop, in the order the pipelined drive build (_PIPELINED_DRIVE_) runs them, with the mixer and motor stacks of the open
+     loop host robot.  Writes every frame published to consumers with the failsafe mask and each motor's set and commanded rpm after it,
+     receiver link statistics, and the replay rate through the whole chain.  Recorded decoder errors and recorder overflows are counted,
+     not replayed.
+     Build:  g++ -std=c++17 -O2 -I. -Itools/host -I<sl-robot>/src [-D_DUAL_SBUS_RECEIVER_] -DSL_CR_ROBOT=sl_cr_robot_host_open_loop_s
+               -include tools/host/sl_cr_robot_host.hpp -o sl_cr_sbus_replay tools/sl_cr_sbus_replay.cpp sl_cr_sbus.cpp
+               sl_cr_sbus_decoder.cpp sl_cr_sbus_record.cpp sl_cr_failsafe.cpp sl_cr_latency.cpp sl_cr_drive.cpp sl_cr_encoder.cpp
+               sl_cr_fixed_pid.cpp sl_cr_rc_map.cpp
+     Usage:  sl_cr_sbus_replay [-t] [-q] < SBUS000.BIN > SBUS000.csv
+               -t  tab separated columns instead of CSV
+               -q  no frame rows, so the replay rate is the chain's alone */
+
+#include <Arduino.h>
+#include <chrono>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "sl_cr_drive.hpp"
+#include "sl_cr_failsafe.hpp"
+#include "sl_cr_sbus.hpp"
+#include "sl_cr_sbus_record.hpp"
+
+using namespace sandor_laboratories::robot;
+
+/* Log output of the firmware modules */
+void log_snprintf(log_key_e, log_level_e, const char *format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  fprintf(stderr, "\n");
+  va_end(args);
+}
+
+/* Single threaded */
+void critical_section_enter() {}
+void critical_section_exit() {}
+
+/* Drive subsystem state, for motor outputs */
+static const sl_cr_drive_data_s *drive_data_ptr = nullptr;
+
+/* Writes frame published by last loop */
+static void print_frame(char separator)
+{
+  sl_cr_sbus_frame_s frame;
+
+  sl_cr_sbus_get_frame(&frame);
+  printf("%u%c%u%c%u%c%u%c%u%c%u%c0x%x", (unsigned int) micros(), separator, (unsigned int) frame.rx_time, separator,
+    (unsigned int) frame.receiver, separator, frame.stale?1:0, separator, frame.failsafe?1:0, separator, frame.lost_frame?1:0, separator,
+    (unsigned int) combat::get_failsafe_mask());
+  for(unsigned int c = 1; c <= SL_CR_SBUS_NUM_CH; c++)
+  {
+    printf("%c%d", separator, (int) sl_cr_sbus_get_frame_ch_value(&frame, c));
+  }
+  for(unsigned int m = 0; m < SL_CR_DRIVE_MOTOR_COUNT; m++)
+  {
+    printf("%c%d%c%d", separator, (int) drive_data_ptr->motor_state.set_rpm[m], separator, (int) drive_data_ptr->motor_state.commanded_rpm[m]);
+  }
+  printf("\n");
+}
+
+/* Runs SBUS task loop, then arm switch, drive strategy and control loop, writing any published frame with the outputs it led to */
+static void sbus_task_loop(char separator, bool quiet)
+{
+  const bool new_frame = sl_cr_sbus_loop();
+  combat::failsafe_armswitch_loop();
+  sl_cr_drive_strategy_loop();
+  sl_cr_drive_control_loop();
+
+  if(new_frame && !quiet)
+  {
+    print_frame(separator);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  char                 separator = ',';
+  bool                 quiet = false;
+  std::vector<uint8_t> recording;
+  uint8_t              chunk[4096];
+  size_t               length;
+
+  for(int a = 1; a < argc; a++)
+  {
+    separator = (0 == strcmp(argv[a], "-t"))?'\t':separator;
+    quiet     = quiet || (0 == strcmp(argv[a], "-q"));
+  }
+
+  while((length = fread(chunk, 1, sizeof(chunk), stdin)) > 0)
+  {
+    recording.insert(recording.end(), chunk, chunk + length);
+  }
+
+  sl_cr_sbus_replay_c player(recording.data(), recording.size());
+  sl_cr_sbus_record_s record;
+  unsigned int        frames = 0;
+  unsigned int        errors = 0;
+  unsigned int        overflows = 0;
+  unsigned int        ignored = 0;
+
+  if(!player.valid())
+  {
+    fprintf(stderr, "Not an SBUS recording (version %u)\n", SL_CR_SBUS_RECORD_VERSION);
+    return 1;
+  }
+
+  printf("time_us%crx_time_us%creceiver%cstale%cfailsafe%clost_frame%cfailsafe_mask", separator, separator, separator, separator,
+    separator, separator);
+  for(unsigned int c = 1; c <= SL_CR_SBUS_NUM_CH; c++)
+  {
+    printf("%cch%u", separator, c);
+  }
+  for(unsigned int m = 0; m < SL_CR_DRIVE_MOTOR_COUNT; m++)
+  {
+    printf("%cset_rpm%u%ccommanded_rpm%u", separator, m, separator, m);
+  }
+  printf("\n");
+
+  /* Start simulated time at the first record, as if booted just before it */
+  if(player.next(&record))
+  {
+    sl_cr_host_advance_to_us(record.rx_time - 1);
+    player.rewind();
+  }
+  /* Boot as setup() does */
+  sl_cr_sbus_init(nullptr);
+  drive_data_ptr = sl_cr_drive_init();
+  combat::clear_failsafe_mask(combat::FAILSAFE_BOOT);
+
+  const auto start = std::chrono::steady_clock::now();
+
+  while(player.next(&record))
+  {
+    /* Frame period timeouts of the SBUS task up to this record */
+    const sl_cr_time_us_t period = sl_cr_sbus_get_frame_period_ticks() * 1000;
+    while((sl_cr_time_diff_us_t) (record.rx_time - micros()) > (sl_cr_time_diff_us_t) period)
+    {
+      sl_cr_host_advance_us(period);
+      sbus_task_loop(separator, quiet);
+    }
+    sl_cr_host_advance_to_us(record.rx_time);
+
+    switch(record.type)
+    {
+      case SL_CR_SBUS_RECORD_FRAME:
+        if(record.receiver < SL_CR_SBUS_RECEIVER_COUNT)
+        {
+          sl_cr_sbus_inject(record.receiver, record.data, SL_CR_SBUS_FRAME_SIZE, record.rx_time);
+          sbus_task_loop(separator, quiet);
+          frames++;
+        }
+        else
+        {
+          ignored++;
+        }
+        break;
+      case SL_CR_SBUS_RECORD_ERROR:
+        errors++;
+        break;
+      case SL_CR_SBUS_RECORD_OVERFLOW:
+        overflows += record.data[0];
+        fprintf(stderr, "Recording lost %s%u records before %uus\n", (UINT8_MAX == record.data[0])?"at least ":"", (unsigned int) record.data[0],
+          (unsigned int) record.rx_time);
+        break;
+      default:
+        break;
+    }
+  }
+
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  fprintf(stderr, "%u frames replayed, %u decoder errors recorded, %u records lost to recorder overflow\n", frames, errors, overflows);
+  fprintf(stderr, "%.0f frames/s through SBUS, failsafe, drive strategy and motor stacks%s\n", (seconds > 0)?(frames / seconds):0.0,
+    quiet?"":" (including output)");
+  if(ignored > 0)
+  {
+    fprintf(stderr, "%u frames from a second receiver ignored, build with -D_DUAL_SBUS_RECEIVER_ to merge them\n", ignored);
+  }
+  sl_cr_sbus_log_stats(LOG_KEY_BOOT);
+
+  return 0;
+}
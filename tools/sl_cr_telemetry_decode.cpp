@@ -0,0 +1,126 @@
+/*
+  sl_cr_telemetry_decode.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+/* Host decoder for the telemetry stream (see sl_cr_telemetry.hpp).  Reads a captured stream and writes one row per frame.
+     Build:  g++ -std=c++17 -o sl_cr_telemetry_decode tools/sl_cr_telemetry_decode.cpp
+     Usage:  sl_cr_telemetry_decode [-t] < capture.bin > capture.csv
+               -t  tab separated columns instead of CSV
+   Frames failing CRC are skipped and counted, gaps in sequence are reported as dropped frames. */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+/* Stream layout, must match sl_cr_telemetry.hpp */
+#define SL_CR_TELEMETRY_SYNC        0x4C54
+#define SL_CR_TELEMETRY_VERSION     1
+#define SL_CR_TELEMETRY_HEADER_SIZE 17
+#define SL_CR_TELEMETRY_MOTOR_SIZE  8
+
+static uint16_t read_u16(const uint8_t *data) {return data[0] | (data[1] << 8);}
+static uint32_t read_u32(const uint8_t *data) {return read_u16(data) | ((uint32_t) read_u16(data+2) << 16);}
+
+/* CRC-16/CCITT-FALSE */
+static uint16_t crc16(const uint8_t *data, size_t length)
+{
+  uint16_t crc = 0xFFFF;
+  for(size_t i = 0; i < length; i++)
+  {
+    crc ^= ((uint16_t) data[i]) << 8;
+    for(unsigned int bit = 0; bit < 8; bit++)
+    {
+      crc = (crc & 0x8000)?((crc << 1) ^ 0x1021):(crc << 1);
+    }
+  }
+  return crc;
+}
+
+int main(int argc, char **argv)
+{
+  const char           separator     = ((argc > 1) && (0 == strcmp(argv[1], "-t")))?'\t':',';
+  std::vector<uint8_t> stream;
+  uint8_t              chunk[4096];
+  size_t               length;
+  size_t               offset        = 0;
+  bool                 header_done   = false;
+  bool                 have_sequence = false;
+  uint32_t             next_sequence = 0;
+  unsigned long        frames        = 0;
+  unsigned long        crc_errors    = 0;
+  unsigned long        dropped       = 0;
+
+  while((length = fread(chunk, 1, sizeof(chunk), stdin)) > 0)
+  {
+    stream.insert(stream.end(), chunk, chunk + length);
+  }
+
+  while((offset + SL_CR_TELEMETRY_HEADER_SIZE) <= stream.size())
+  {
+    const uint8_t *frame = &stream[offset];
+
+    if(SL_CR_TELEMETRY_SYNC != read_u16(frame) || SL_CR_TELEMETRY_VERSION != frame[2])
+    {
+      /* Resynchronize */
+      offset++;
+      continue;
+    }
+
+    const unsigned int motor_count   = frame[3];
+    const unsigned int channel_count = frame[4];
+    const size_t       frame_size    = SL_CR_TELEMETRY_HEADER_SIZE + 2*channel_count + SL_CR_TELEMETRY_MOTOR_SIZE*motor_count + 2;
+
+    if((offset + frame_size) > stream.size())
+    {
+      break;
+    }
+    if(crc16(frame, frame_size - 2) != read_u16(frame + frame_size - 2))
+    {
+      crc_errors++;
+      offset++;
+      continue;
+    }
+
+    if(!header_done)
+    {
+      printf("time_us%csequence%cfailsafe_mask", separator, separator);
+      for(unsigned int c = 0; c < channel_count; c++)
+      {
+        printf("%cch%u", separator, c+1);
+      }
+      for(unsigned int m = 0; m < motor_count; m++)
+      {
+        printf("%cm%u_set_rpm%cm%u_commanded_rpm%cm%u_real_rpm%cm%u_error", separator, m, separator, m, separator, m, separator, m);
+      }
+      printf("\n");
+      header_done = true;
+    }
+
+    const uint32_t sequence = read_u32(frame + 5);
+    if(have_sequence && (sequence != next_sequence))
+    {
+      dropped += sequence - next_sequence;
+    }
+    have_sequence = true;
+    next_sequence = sequence + 1;
+
+    printf("%u%c%u%c0x%x", read_u32(frame + 9), separator, sequence, separator, read_u32(frame + 13));
+    const uint8_t *values = frame + SL_CR_TELEMETRY_HEADER_SIZE;
+    for(unsigned int v = 0; v < (channel_count + 4*motor_count); v++)
+    {
+      printf("%c%d", separator, (int16_t) read_u16(values + 2*v));
+    }
+    printf("\n");
+
+    frames++;
+    offset += frame_size;
+  }
+
+  fprintf(stderr, "%lu frames, %lu dropped by device, %lu CRC errors\n", frames, dropped, crc_errors);
+
+  return 0;
+}